@@ -14,6 +14,7 @@ Copyright:
 
 #include "local_glibmm.h"
 #include <string>
+#include <string_view>
 #include <gtkmm.h>
 #include <memory>
 
@@ -48,6 +49,11 @@ Copyright:
 
 
 
+/// GResource path prefix of the compiled-in UI files (see src/ui/gsc_ui.gresource.xml)
+inline constexpr std::string_view app_builder_resource_prefix = "/org/gsmartcontrol/ui/";
+
+
+
 /// Inherit this when using GtkBuilder-enabled windows (or any other GtkBuilder-enabled objects).
 /// \c Child is the child class that inherits all the functionality of having instance lifetime
 /// management and other benefits.
@@ -78,8 +84,8 @@ class AppBuilderWidget : public WidgetType, public WindowInstanceManager<Child,
 
 
 		/// Create an instance of this class, returning an existing instance if not MultiInstance.
-		/// A glade file in "ui" data domain is loaded with Child::ui_name filename base and is available as
-		/// `get_ui()` in child object.
+		/// A glade file with Child::ui_name filename base is loaded from the compiled-in resources
+		/// (or from "ui" data domain if the resource is absent), and is available as `get_ui()` in child object.
 		/// \return nullptr if widget could not be loaded.
 		static std::shared_ptr<Child> create();
 
@@ -138,9 +144,18 @@ std::shared_ptr<Child> AppBuilderWidget<Child, MultiInstance, WidgetType>::creat
 
 	std::string error_msg;
 
-	auto ui_path = hz::data_file_find("ui", std::string(Child::ui_name) + ".glade");
+	const std::string ui_file = std::string(Child::ui_name) + ".glade";
+	const std::string resource_path = std::string(app_builder_resource_prefix) + ui_file;
 	try {
-		auto ui = Gtk::Builder::create_from_file(ui_path.u8string());  // may throw
+		Glib::RefPtr<Gtk::Builder> ui;
+		// The UI files are compiled into the binary. If they are not (e.g. in a custom build),
+		// look for them in "ui" data domain.
+		if (g_resources_get_info(resource_path.c_str(), G_RESOURCE_LOOKUP_FLAGS_NONE, nullptr, nullptr, nullptr)) {
+			ui = Gtk::Builder::create_from_resource(resource_path);  // may throw
+		} else {
+			debug_out_warn("app", DBG_FUNC_MSG << "UI resource \"" << resource_path << "\" not found, loading it from disk.\n");
+			ui = Gtk::Builder::create_from_file(hz::data_file_find("ui", ui_file).u8string());  // may throw
+		}
 
 		Child* raw_obj = nullptr;
 		ui->get_widget_derived({Child::ui_name.data(), Child::ui_name.size()}, raw_obj);  // Calls Child's constructor
@@ -0,0 +1,161 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <algorithm>
+
+#include "hz/debug.h"
+#include "app_pcrecpp_pattern_set.h"
+
+
+
+namespace {
+
+	/// Split "/pattern/modifiers" into pattern and modifiers, the same way app_pcre_re() does.
+	void split_perl_pattern(const std::string& perl_pattern, std::string& pattern, std::string& modifiers)
+	{
+		if (perl_pattern.size() >= 2 && perl_pattern[0] == '/') {
+			const std::string::size_type endpos = perl_pattern.rfind('/');
+			pattern = perl_pattern.substr(1, endpos - 1);
+			modifiers = perl_pattern.substr(endpos + 1);
+		} else {
+			pattern = perl_pattern;
+			modifiers.clear();
+		}
+	}
+
+
+
+	/// Check whether a pattern may be embedded into an alternation without changing its meaning.
+	/// Only modifiers which have an inline "(?ims:...)" form are allowed, and the pattern must not
+	/// refer to its own groups by number (these are renumbered in the alternation).
+	bool pattern_is_combinable(const std::string& pattern, const std::string& modifiers)
+	{
+		if (modifiers.find_first_not_of("ims") != std::string::npos) {
+			return false;
+		}
+		// Backreferences (\1, \g1) and recursion ((?1), (?R)).
+		return !app_pcre_match(R"(/\\[1-9g]|\(\?[0-9R+-]/)", pattern);
+	}
+
+}
+
+
+
+AppPcrePatternSet::AppPcrePatternSet(const std::vector<std::string>& perl_patterns)
+{
+	add_patterns(perl_patterns);
+}
+
+
+
+void AppPcrePatternSet::add_patterns(const std::vector<std::string>& perl_patterns)
+{
+	patterns_.insert(patterns_.end(), perl_patterns.begin(), perl_patterns.end());
+	compile();
+}
+
+
+
+const std::vector<std::string>& AppPcrePatternSet::get_patterns() const
+{
+	return patterns_;
+}
+
+
+
+bool AppPcrePatternSet::empty() const
+{
+	return combined_indices_.empty() && separate_indices_.empty();
+}
+
+
+
+std::optional<std::size_t> AppPcrePatternSet::find_match(std::string_view str) const
+{
+	// Most strings match none of the patterns, reject them with a single call.
+	if (combined_re_.has_value() && app_pcre_match(combined_re_.value(), str)) {
+		for (const std::size_t index : combined_indices_) {
+			if (app_pcre_match(res_[index].value(), str)) {
+				return index;
+			}
+		}
+	}
+	for (const std::size_t index : separate_indices_) {
+		if (app_pcre_match(res_[index].value(), str)) {
+			return index;
+		}
+	}
+	return std::nullopt;
+}
+
+
+
+bool AppPcrePatternSet::match(std::string_view str) const
+{
+	if (combined_re_.has_value() && app_pcre_match(combined_re_.value(), str)) {
+		return true;
+	}
+	return std::any_of(separate_indices_.cbegin(), separate_indices_.cend(), [&](std::size_t index) {
+		return app_pcre_match(res_[index].value(), str);
+	});
+}
+
+
+
+void AppPcrePatternSet::compile()
+{
+	res_.clear();
+	combined_re_.reset();
+	combined_indices_.clear();
+	separate_indices_.clear();
+
+	std::string combined_pattern;
+	for (std::size_t i = 0; i < patterns_.size(); ++i) {
+		pcrecpp::RE re = app_pcre_re(patterns_[i]);
+		if (!re.error().empty()) {
+			debug_out_warn("app", DBG_FUNC_MSG << "Invalid pattern \"" << patterns_[i] << "\": " << re.error() << ", ignoring.\n");
+			res_.emplace_back(std::nullopt);
+			continue;
+		}
+		res_.emplace_back(re);
+
+		std::string pattern, modifiers;
+		split_perl_pattern(patterns_[i], pattern, modifiers);
+		if (!pattern_is_combinable(pattern, modifiers)) {
+			separate_indices_.push_back(i);
+			continue;
+		}
+		combined_pattern += std::string(combined_pattern.empty() ? "" : "|") + "(?" + modifiers + ":" + pattern + ")";
+		combined_indices_.push_back(i);
+	}
+
+	if (combined_indices_.empty()) {
+		return;
+	}
+
+	pcrecpp::RE combined_re(combined_pattern, app_pcre_get_options({}));
+	if (combined_re.error().empty()) {
+		combined_re_ = combined_re;
+	} else {
+		// Shouldn't happen since the individual patterns are valid, but match them one by one anyway.
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot combine patterns: " << combined_re.error() << "\n");
+		separate_indices_.insert(separate_indices_.end(), combined_indices_.begin(), combined_indices_.end());
+		std::sort(separate_indices_.begin(), separate_indices_.end());
+		combined_indices_.clear();
+	}
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,79 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef APP_PCRECPP_PATTERN_SET_H
+#define APP_PCRECPP_PATTERN_SET_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+
+#include "app_pcrecpp.h"
+
+
+
+/// A set of "/pattern/modifiers" regular expressions, compiled once and matched
+/// together. Patterns are merged into a single alternation where possible, so
+/// a string which doesn't match any of them is rejected with one pcre call.
+/// Individual patterns are only consulted to find out which one has matched.
+class AppPcrePatternSet {
+	public:
+
+		/// Constructor
+		AppPcrePatternSet() = default;
+
+		/// Constructor
+		explicit AppPcrePatternSet(const std::vector<std::string>& perl_patterns);
+
+
+		/// Add patterns to the set and recompile it
+		void add_patterns(const std::vector<std::string>& perl_patterns);
+
+
+		/// Get the patterns, as passed to add_patterns()
+		[[nodiscard]] const std::vector<std::string>& get_patterns() const;
+
+
+		/// Check if the set has no (valid) patterns
+		[[nodiscard]] bool empty() const;
+
+
+		/// Partially match a string against all the patterns.
+		/// \return the index (in get_patterns()) of a matching pattern, or std::nullopt.
+		[[nodiscard]] std::optional<std::size_t> find_match(std::string_view str) const;
+
+
+		/// Partially match a string against all the patterns.
+		/// \return true if any pattern matched.
+		[[nodiscard]] bool match(std::string_view str) const;
+
+
+	private:
+
+		/// Compile the individual patterns and the combined alternation
+		void compile();
+
+
+		std::vector<std::string> patterns_;  ///< Patterns in "/pattern/modifiers" format
+		std::vector<std::optional<pcrecpp::RE>> res_;  ///< Compiled patterns, nullopt if invalid
+		std::optional<pcrecpp::RE> combined_re_;  ///< Alternation of the patterns in combined_indices_
+		std::vector<std::size_t> combined_indices_;  ///< Patterns merged into combined_re_
+		std::vector<std::size_t> separate_indices_;  ///< Patterns which have to be matched one by one
+
+};
+
+
+
+
+#endif
+
+/// @}
@@ -20,12 +20,19 @@ Copyright:
 // 	#include <io.h>  // close()
 #else
 	#include <sys/wait.h>  // waitpid()'s W* macros
-// 	#include <unistd.h>  // close()
+	#include <unistd.h>  // close(), pipe2()
+	#include <fcntl.h>  // O_CLOEXEC
+	#include <spawn.h>  // posix_spawnp()
+	#include <glib-unix.h>  // g_unix_fd_add_full()
+#endif
+#ifdef __linux__
+	#include <sys/syscall.h>  // SYS_pidfd_open
 #endif
 
 #include "hz/process_signal.h"  // hz::process_signal_send, win32's W*
 #include "hz/debug.h"
 #include "hz/fs.h"
+#include "hz/string_algo.h"  // string_join
 
 #include "async_command_executor.h"
 #include "build_config.h"
@@ -64,6 +71,13 @@ extern "C" {
 	}
 
 
+	/// Child process pidfd handler callback
+	inline gboolean cmdex_on_pidfd_ready(gint fd, GIOCondition cond, gpointer data)
+	{
+		return AsyncCommandExecutor::on_pidfd_ready(fd, cond, static_cast<AsyncCommandExecutor*>(data));
+	}
+
+
 	/// Child process termination timeout handler
 	inline gboolean cmdex_on_term_timeout(gpointer data)
 	{
@@ -115,6 +129,14 @@ void AsyncCommandExecutor::set_command(const std::string& command_exec, const st
 {
 	command_exec_ = command_exec;
 	command_args_ = command_args;
+	command_argv_.clear();
+}
+
+
+
+void AsyncCommandExecutor::set_command_argv(std::vector<std::string> argv)
+{
+	command_argv_ = std::move(argv);
 }
 
 
@@ -132,18 +154,22 @@ bool AsyncCommandExecutor::execute()
 	str_stderr_.clear();
 
 
-	const std::string cmd = command_exec_ + " " + command_args_;
-
-
 	// Make command vector
 	std::vector<std::string> argvp;
-	try {
-		argvp = Glib::shell_parse_argv(cmd);
-	}
-	catch(Glib::ShellError& e)
-	{
-		push_error(Error<void>("gshell", ErrorLevel::error, e.what()));
-		return false;
+	std::string cmd;
+	if (!command_argv_.empty()) {
+		argvp = command_argv_;
+		cmd = hz::string_join(argvp, " ");  // for debug output only
+	} else {
+		cmd = command_exec_ + " " + command_args_;
+		try {
+			argvp = Glib::shell_parse_argv(cmd);
+		}
+		catch(Glib::ShellError& e)
+		{
+			push_error(Error<void>("gshell", ErrorLevel::error, e.what()));
+			return false;
+		}
 	}
 
 
@@ -175,22 +201,47 @@ bool AsyncCommandExecutor::execute()
 
 	debug_out_info("app", DBG_FUNC_MSG << "Executing \"" << cmd << "\".\n");
 
-	// Execute the command
-	try {
-		Glib::spawn_async_with_pipes(Glib::get_current_dir(), argvp, envp,
-				Glib::SpawnFlags::SPAWN_SEARCH_PATH | Glib::SpawnFlags::SPAWN_DO_NOT_REAP_CHILD,
-				Glib::SlotSpawnChildSetup(),
-				&this->pid_, nullptr, &fd_stdout_, &fd_stderr_);
-	}
-	catch(Glib::SpawnError& e) {
-		// no data is returned to &-parameters on error.
-		push_error(Error<void>("gspawn", ErrorLevel::error, e.what()));
-		// Restore CWD
-		if (path_changed) {
-			std::error_code dummy_ec;
-			hz::fs::current_path(current_path, dummy_ec);
+	// posix_spawn() avoids duplicating our (large) address space in the child,
+	// but it cannot run custom code there. Use GLib spawning if we need that.
+	bool spawned = false;
+	if (!child_setup_func_) {
+		spawned = spawn_posix(argvp, envp);
+		if (!spawned && has_errors()) {
+			// Restore CWD
+			if (path_changed) {
+				std::error_code dummy_ec;
+				hz::fs::current_path(current_path, dummy_ec);
+			}
+			return false;
+		}
+	}
+
+	if (!spawned) {
+		// Under win32 the child setup function is called in the parent, so don't use it there.
+		Glib::SlotSpawnChildSetup child_setup;
+		if constexpr(!BuildEnv::is_kernel_family_windows()) {
+			if (child_setup_func_) {
+				child_setup = sigc::mem_fun(*this, &AsyncCommandExecutor::on_child_setup);
+			}
+		}
+
+		// Execute the command
+		try {
+			Glib::spawn_async_with_pipes(Glib::get_current_dir(), argvp, envp,
+					Glib::SpawnFlags::SPAWN_SEARCH_PATH | Glib::SpawnFlags::SPAWN_DO_NOT_REAP_CHILD,
+					child_setup,
+					&this->pid_, nullptr, &fd_stdout_, &fd_stderr_);
+		}
+		catch(Glib::SpawnError& e) {
+			// no data is returned to &-parameters on error.
+			push_error(Error<void>("gspawn", ErrorLevel::error, e.what()));
+			// Restore CWD
+			if (path_changed) {
+				std::error_code dummy_ec;
+				hz::fs::current_path(current_path, dummy_ec);
+			}
+			return false;
 		}
-		return false;
 	}
 
 	// Restore CWD
@@ -250,10 +301,21 @@ bool AsyncCommandExecutor::execute()
 // 	g_io_channel_unref(channel_stderr_);  // g_io_add_watch_full() holds its own reference
 
 
+	#ifndef _WIN32
+		if (pidfd_ != -1) {
+			// The pidfd becomes readable when the child exits; we reap it ourselves.
+			// This avoids GLib's SIGCHLD handling for our children altogether.
+			event_source_id_pidfd_ = g_unix_fd_add_full(G_PRIORITY_DEFAULT, pidfd_, G_IO_IN,
+					&cmdex_on_pidfd_ready, this, nullptr);
+		}
+	#endif
+
 	// If using SPAWN_DO_NOT_REAP_CHILD, this is needed to avoid zombies.
 	// Note: Do NOT use glibmm slot, it doesn't work here.
 	// (the child stops being a zombie as soon as wait*() exits and this handler is called).
-	g_child_watch_add(this->pid_, &cmdex_child_watch_handler, this);
+	if (event_source_id_pidfd_ == 0) {
+		g_child_watch_add(this->pid_, &cmdex_child_watch_handler, this);
+	}
 
 
 	this->running_ = true;  // the process is running now.
@@ -498,6 +560,116 @@ gboolean AsyncCommandExecutor::on_channel_io(GIOChannel* channel,
 
 
 
+gboolean AsyncCommandExecutor::on_pidfd_ready([[maybe_unused]] int fd, [[maybe_unused]] GIOCondition cond, AsyncCommandExecutor* self)
+{
+#ifdef _WIN32
+	DBG_ASSERT(0);  // not used in win32
+	return FALSE;
+#else
+	int waitpid_status = 0;
+	pid_t ret = 0;
+	do {
+		ret = waitpid(self->pid_, &waitpid_status, 0);  // the child has exited, this won't block
+	} while (ret == -1 && errno == EINTR);
+
+	if (ret == -1) {
+		self->push_error(Error<int>("errno", ErrorLevel::error, errno));
+	}
+
+	self->event_source_id_pidfd_ = 0;  // we return false, removing the source
+	close(self->pidfd_);
+	self->pidfd_ = -1;
+
+	on_child_watch_handler(self->pid_, waitpid_status, self);
+	return FALSE;  // one-time call
+#endif
+}
+
+
+
+bool AsyncCommandExecutor::spawn_posix([[maybe_unused]] const std::vector<std::string>& argv,
+		[[maybe_unused]] const std::vector<std::string>& envp)
+{
+#ifdef _WIN32
+	return false;  // not supported
+
+#else
+	DBG_ASSERT_RETURN(!argv.empty(), false);
+
+	std::vector<char*> c_argv;
+	c_argv.reserve(argv.size() + 1);
+	for (const auto& arg : argv) {
+		c_argv.push_back(const_cast<char*>(arg.c_str()));
+	}
+	c_argv.push_back(nullptr);
+
+	std::vector<char*> c_envp;
+	c_envp.reserve(envp.size() + 1);
+	for (const auto& env : envp) {
+		c_envp.push_back(const_cast<char*>(env.c_str()));
+	}
+	c_envp.push_back(nullptr);
+
+	// The pipes are created with O_CLOEXEC, so they don't leak into other children
+	// spawned concurrently (e.g. by other threads). dup2() in the child clears
+	// the flag on stdout / stderr only.
+	std::array<int, 2> stdout_pipe = {-1, -1};
+	std::array<int, 2> stderr_pipe = {-1, -1};
+	auto close_pipes = [&]()
+	{
+		for (int fd : {stdout_pipe[0], stdout_pipe[1], stderr_pipe[0], stderr_pipe[1]}) {
+			if (fd != -1)
+				close(fd);
+		}
+	};
+
+	if (pipe2(stdout_pipe.data(), O_CLOEXEC) == -1 || pipe2(stderr_pipe.data(), O_CLOEXEC) == -1) {
+		push_error(Error<int>("errno", ErrorLevel::error, errno));
+		close_pipes();
+		return false;
+	}
+
+	posix_spawn_file_actions_t file_actions;
+	posix_spawn_file_actions_init(&file_actions);
+	posix_spawn_file_actions_addopen(&file_actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+	posix_spawn_file_actions_adddup2(&file_actions, stdout_pipe[1], STDOUT_FILENO);
+	posix_spawn_file_actions_adddup2(&file_actions, stderr_pipe[1], STDERR_FILENO);
+
+	pid_t pid = 0;
+	// posix_spawnp() searches PATH, like SPAWN_SEARCH_PATH.
+	const int spawn_error = posix_spawnp(&pid, c_argv.front(), &file_actions, nullptr, c_argv.data(), c_envp.data());
+	posix_spawn_file_actions_destroy(&file_actions);
+
+	// The write ends belong to the child now
+	close(stdout_pipe[1]);
+	stdout_pipe[1] = -1;
+	close(stderr_pipe[1]);
+	stderr_pipe[1] = -1;
+
+	if (spawn_error != 0) {
+		push_error(Error<int>("errno", ErrorLevel::error, spawn_error));
+		close_pipes();
+		return false;
+	}
+
+	pid_ = pid;
+	fd_stdout_ = stdout_pipe[0];
+	fd_stderr_ = stderr_pipe[0];
+
+	#if defined __linux__ && defined SYS_pidfd_open
+		// Linux 5.3+. If it's not available, g_child_watch_add() is used.
+		pidfd_ = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+		if (pidfd_ != -1) {
+			fcntl(pidfd_, F_SETFD, FD_CLOEXEC);
+		}
+	#endif
+
+	return true;
+#endif
+}
+
+
+
 bool AsyncCommandExecutor::stopped_cleanup_needed() const
 {
 	return (child_watch_handler_called_);
@@ -528,7 +700,7 @@ std::string AsyncCommandExecutor::get_stdout_str(bool clear_existing)
 {
 	// debug_out_dump("app", str_stdout_);
 	if (clear_existing) {
-		std::string ret = str_stdout_;
+		std::string ret = std::move(str_stdout_);
 		str_stdout_.clear();
 		return ret;
 	}
@@ -540,7 +712,7 @@ std::string AsyncCommandExecutor::get_stdout_str(bool clear_existing)
 std::string AsyncCommandExecutor::get_stderr_str(bool clear_existing)
 {
 	if (clear_existing) {
-		std::string ret = str_stderr_;
+		std::string ret = std::move(str_stderr_);
 		str_stderr_.clear();
 		return ret;
 	}
@@ -571,6 +743,22 @@ void AsyncCommandExecutor::set_exited_callback(AsyncCommandExecutor::exited_call
 
 
 
+void AsyncCommandExecutor::set_child_setup(AsyncCommandExecutor::child_setup_func_t func)
+{
+	child_setup_func_ = std::move(func);
+}
+
+
+
+void AsyncCommandExecutor::on_child_setup()
+{
+	// We're in the child here. No debug output, no allocations.
+	if (child_setup_func_)
+		child_setup_func_();
+}
+
+
+
 void AsyncCommandExecutor::cleanup_members()
 {
 	kill_signal_sent_ = 0;
@@ -579,6 +767,8 @@ void AsyncCommandExecutor::cleanup_members()
 	waitpid_status_ = 0;
 	event_source_id_stdout_ = 0;
 	event_source_id_stderr_ = 0;
+	event_source_id_pidfd_ = 0;
+	pidfd_ = -1;
 	fd_stdout_ = 0;
 	fd_stderr_ = 0;
 }
@@ -9,6 +9,7 @@ Copyright:
 
 #include <glib.h>
 #include <string>
+#include <vector>
 #include <functional>
 #include <chrono>
 
@@ -31,6 +32,10 @@ class AsyncCommandExecutor : public hz::ErrorHolder {
 		/// A function that is called whenever a process exits.
 		using exited_callback_func_t = std::function<void()>;
 
+		/// A function that is called in the child process after fork(), before exec().
+		/// It must only call async-signal-safe functions. Not called under win32.
+		using child_setup_func_t = std::function<void()>;
+
 
 		/// Constructor
 		explicit AsyncCommandExecutor(exited_callback_func_t exited_cb = nullptr);
@@ -60,6 +65,12 @@ class AsyncCommandExecutor : public hz::ErrorHolder {
 		void set_command(const std::string& command_exec, const std::string& command_args);
 
 
+		/// Set the command to execute as a ready argument vector (binary first).
+		/// No shell parsing is performed on it. This overrides set_command().
+		/// Call before execute().
+		void set_command_argv(std::vector<std::string> argv);
+
+
 		/// Launch the command.
 		bool execute();
 
@@ -131,7 +142,7 @@ class AsyncCommandExecutor : public hz::ErrorHolder {
 
 
 		/// Return execution time, in seconds. Call this after execute().
-		[[maybe_unused]] double get_execution_time_sec();
+		double get_execution_time_sec();
 
 
 		/// Set exit status translator callback, disconnecting the old one.
@@ -144,6 +155,11 @@ class AsyncCommandExecutor : public hz::ErrorHolder {
 		void set_exited_callback(exited_callback_func_t func);
 
 
+		/// Set child setup callback (e.g. to lower the child's priority).
+		/// Call only before execute().
+		void set_child_setup(child_setup_func_t func);
+
+
 
 		// these are sort of private
 
@@ -162,6 +178,9 @@ class AsyncCommandExecutor : public hz::ErrorHolder {
 		/// Channel I/O handler
 		static gboolean on_channel_io(GIOChannel* channel, GIOCondition cond, AsyncCommandExecutor* self, Channel channel_type);
 
+		/// Process file descriptor handler (the child has exited). Reaps the child.
+		static gboolean on_pidfd_ready(int fd, GIOCondition cond, AsyncCommandExecutor* self);
+
 
 	private:
 
@@ -170,10 +189,22 @@ class AsyncCommandExecutor : public hz::ErrorHolder {
 		void cleanup_members();
 
 
+		/// Called in the child process before exec(), invokes child_setup_func_.
+		void on_child_setup();
+
+
+		/// Spawn the child using posix_spawn() with CLOEXEC pipes, without going
+		/// through GLib's fork / exec. Sets pid_, fd_stdout_, fd_stderr_ and pidfd_.
+		/// \return false on error (an error is pushed then), or if it's not supported
+		/// on this platform (nothing is pushed then).
+		bool spawn_posix(const std::vector<std::string>& argv, const std::vector<std::string>& envp);
+
+
 
 		// default command and its args. std::strings, not ustrings.
 		std::string command_exec_;  /// Binary name to execute. NOT affected by cleanup_members().
 		std::string command_args_;  /// Arguments that always go with the binary. NOT affected by cleanup_members().
+		std::vector<std::string> command_argv_;  ///< If not empty, used instead of the two above. NOT affected by cleanup_members().
 
 
 		bool running_ = false;  ///< If true, the child process is running now. NOT affected by cleanup_members().
@@ -181,6 +212,7 @@ class AsyncCommandExecutor : public hz::ErrorHolder {
 		bool child_watch_handler_called_ = false;  ///< true after child_watch_handler callback, before stopped_cleanup().
 
 		GPid pid_ = 0;  ///< Process ID. int in Unix, pointer in win32
+		int pidfd_ = -1;  ///< Linux process file descriptor, if the child was spawned by spawn_posix() and pidfd is supported.
 		int waitpid_status_ = 0;  ///< After the command is stopped, before cleanup, this will be available (waitpid() status).
 
 
@@ -201,6 +233,7 @@ class AsyncCommandExecutor : public hz::ErrorHolder {
 
 		guint event_source_id_stdout_ = 0;  ///< IO watcher event source ID for stdout
 		guint event_source_id_stderr_ = 0;  ///< IO watcher event source ID for stderr
+		guint event_source_id_pidfd_ = 0;  ///< IO watcher event source ID for pidfd_
 
 		std::string str_stdout_;  ///< stdout data read during execution. NOT affected by cleanup_members().
 		std::string str_stderr_;  ///< stderr data read during execution. NOT affected by cleanup_members().
@@ -214,6 +247,9 @@ class AsyncCommandExecutor : public hz::ErrorHolder {
 		// "command exited" signal callback.
 		exited_callback_func_t exited_callback_{ };  ///< Exit notifier function. NOT affected by cleanup_members().
 
+		// called in the child before exec().
+		child_setup_func_t child_setup_func_{ };  ///< Child setup function. NOT affected by cleanup_members().
+
 };
 
 
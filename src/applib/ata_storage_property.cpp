@@ -15,6 +15,7 @@ Copyright:
 #include <sstream>
 #include <iomanip>
 #include <locale>
+#include <algorithm>  // std::min
 
 #include "hz/string_num.h"  // number_to_string
 #include "hz/stream_cast.h"  // stream_cast<>
@@ -320,6 +321,64 @@ std::ostream& operator<< (std::ostream& os, const AtaStorageSelftestEntry& b)
 
 
 
+AtaStorageTemperatureHistory::MinMax AtaStorageTemperatureHistory::get_min_max() const
+{
+	MinMax mm;
+	for (const int8_t t : samples) {
+		if (t == unknown_temperature)
+			continue;
+		if (mm.min == unknown_temperature || t < mm.min)
+			mm.min = t;
+		if (mm.max == unknown_temperature || t > mm.max)
+			mm.max = t;
+	}
+	return mm;
+}
+
+
+
+std::vector<AtaStorageTemperatureHistory::MinMax> AtaStorageTemperatureHistory::downsample_min_max(std::size_t num_buckets) const
+{
+	num_buckets = std::min(num_buckets, samples.size());
+	std::vector<MinMax> buckets(num_buckets);
+
+	for (std::size_t i = 0; i < samples.size() && num_buckets > 0; ++i) {
+		const int8_t t = samples[i];
+		if (t == unknown_temperature)
+			continue;
+		MinMax& mm = buckets[i * num_buckets / samples.size()];
+		if (mm.min == unknown_temperature || t < mm.min)
+			mm.min = t;
+		if (mm.max == unknown_temperature || t > mm.max)
+			mm.max = t;
+	}
+	return buckets;
+}
+
+
+
+int64_t AtaStorageTemperatureHistory::get_sample_time(std::size_t index) const
+{
+	return start_time + int64_t(index) * std::chrono::duration_cast<std::chrono::seconds>(logging_interval).count();
+}
+
+
+
+std::ostream& operator<< (std::ostream& os, const AtaStorageTemperatureHistory& h)
+{
+	const auto mm = h.get_min_max();
+	os << "Temperature history: " << h.samples.size() << " samples, interval: "
+		<< h.logging_interval.count() << " min, min/max: ";
+	if (mm.min == AtaStorageTemperatureHistory::unknown_temperature) {
+		os << "-";
+	} else {
+		os << int(mm.min) << "/" << int(mm.max);
+	}
+	return os;
+}
+
+
+
 std::string AtaStorageProperty::get_section_name(AtaStorageProperty::Section s)
 {
 	static const std::unordered_map<Section, std::string> m {
@@ -382,6 +441,8 @@ std::string AtaStorageProperty::get_value_type_name() const
 		return "error_block";
 	if (std::holds_alternative<AtaStorageSelftestEntry>(value))
 		return "selftest_entry";
+	if (std::holds_alternative<AtaStorageTemperatureHistory>(value))
+		return "temperature_history";
 	return "[internal_error]";
 }
 
@@ -427,6 +488,8 @@ void AtaStorageProperty::dump(std::ostream& os, std::size_t internal_offset) con
 		os << std::get<AtaStorageErrorBlock>(value);
 	} else if (std::holds_alternative<AtaStorageSelftestEntry>(value)) {
 		os << std::get<AtaStorageSelftestEntry>(value);
+	} else if (std::holds_alternative<AtaStorageTemperatureHistory>(value)) {
+		os << std::get<AtaStorageTemperatureHistory>(value);
 	}
 }
 
@@ -457,6 +520,8 @@ std::string AtaStorageProperty::format_value(bool add_reported_too) const
 		return hz::stream_cast<std::string>(std::get<AtaStorageErrorBlock>(value));
 	if (std::holds_alternative<AtaStorageSelftestEntry>(value))
 		return hz::stream_cast<std::string>(std::get<AtaStorageSelftestEntry>(value));
+	if (std::holds_alternative<AtaStorageTemperatureHistory>(value))
+		return hz::stream_cast<std::string>(std::get<AtaStorageTemperatureHistory>(value));
 
 	return "[internal_error]";
 }
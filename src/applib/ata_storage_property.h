@@ -20,6 +20,7 @@ Copyright:
 #include <chrono>
 #include <variant>
 #include <unordered_map>
+#include <limits>
 
 #include "warning_level.h"
 
@@ -222,6 +223,42 @@ std::ostream& operator<< (std::ostream& os, const AtaStorageSelftestEntry& b);
 
 
 
+/// Holds SCT temperature history (--log=scttemp), decoded into a compact time series.
+class AtaStorageTemperatureHistory {
+	public:
+
+		/// Sample value of unknown temperature ("?" in smartctl output)
+		static constexpr int8_t unknown_temperature = std::numeric_limits<int8_t>::min();
+
+		/// Minimum and maximum temperature of a range of samples
+		struct MinMax {
+			int8_t min = unknown_temperature;  ///< Minimum known temperature, unknown_temperature if none
+			int8_t max = unknown_temperature;  ///< Maximum known temperature, unknown_temperature if none
+		};
+
+		/// Get the minimum and maximum known temperature of all samples
+		[[nodiscard]] MinMax get_min_max() const;
+
+		/// Split samples into \c num_buckets consecutive ranges (e.g. one per pixel column)
+		/// and return the minimum and maximum of each, so that spikes survive the downsampling.
+		/// If there are fewer samples than buckets, only samples.size() buckets are returned.
+		[[nodiscard]] std::vector<MinMax> downsample_min_max(std::size_t num_buckets) const;
+
+		/// Get estimated time of sample \c index (seconds since epoch)
+		[[nodiscard]] int64_t get_sample_time(std::size_t index) const;
+
+		int64_t start_time = 0;  ///< Estimated time of the first (oldest) sample, seconds since epoch. 0 if unknown.
+		std::chrono::minutes logging_interval = std::chrono::minutes(0);  ///< Time between two samples
+		std::vector<int8_t> samples;  ///< Temperatures in Celsius, oldest first
+};
+
+
+/// Output operator for debug purposes
+std::ostream& operator<< (std::ostream& os, const AtaStorageTemperatureHistory& h);
+
+
+
+
 /// A single parser-extracted property
 class AtaStorageProperty {
 	public:
@@ -318,7 +355,8 @@ class AtaStorageProperty {
 			AtaStorageAttribute,  ///< Value (if it's an attribute)
 			AtaStorageStatistic,  ///< Value (if it's a statistic from devstat)
 			AtaStorageErrorBlock,  ///< Value (if it's a error block)
-			AtaStorageSelftestEntry  ///< Value (if it's a self-test entry)
+			AtaStorageSelftestEntry,  ///< Value (if it's a self-test entry)
+			AtaStorageTemperatureHistory  ///< Value (if it's an SCT temperature history)
 		> value;
 
 		WarningLevel warning_level = WarningLevel::none;  ///< Warning severity for this property
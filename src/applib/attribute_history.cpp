@@ -0,0 +1,446 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <cstdio>
+#include <cstring>  // std::memcpy
+#include <cerrno>
+#include <ctime>
+#include <memory>
+#include <algorithm>
+
+#include "hz/debug.h"
+#include "hz/fs.h"
+#include "hz/string_sprintf.h"
+#include "attribute_history.h"
+
+
+
+namespace {
+
+	/// File signature
+	constexpr char history_magic[8] = {'G', 'S', 'C', 'H', 'I', 'S', 'T', '\0'};
+
+	/// Increase when the format changes
+	constexpr uint32_t history_version = 1;
+
+	/// Size of the fixed part of the header: magic, version, header size, base time, number of columns, reserved.
+	constexpr std::size_t history_fixed_header_size = 32;
+
+	/// Maximum size of the header (column names), to reject garbage
+	constexpr std::size_t history_max_header_size = 1024 * 1024;
+
+
+	/// Closes FILE* on destruction
+	struct FileCloser {
+		void operator()(std::FILE* f) const
+		{
+			std::fclose(f);
+		}
+	};
+
+	using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+
+	/// Parsed file header
+	struct HistoryHeader {
+		/// Size of each record: 32-bit time delta, 32-bit padding, 64-bit value per column.
+		[[nodiscard]] std::size_t get_record_size() const
+		{
+			return 8 + 8 * columns.size();
+		}
+
+		uint32_t header_size = 0;  ///< Records start at this offset
+		int64_t base_time = 0;  ///< Time of the first record
+		std::vector<std::string> columns;  ///< Column names
+	};
+
+
+	/// Append a POD value to a buffer
+	template<typename T>
+	void history_put(std::string& buf, T value)
+	{
+		buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+
+	/// Read a POD value from a buffer
+	template<typename T>
+	T history_get(const char* data)
+	{
+		T value;
+		std::memcpy(&value, data, sizeof(T));
+		return value;
+	}
+
+
+	/// Error code from errno
+	std::error_code history_errno_error()
+	{
+		return {errno, std::system_category()};
+	}
+
+
+	/// Serialize the header, padding it to 8 bytes. This sets header.header_size.
+	std::string history_serialize_header(HistoryHeader& header)
+	{
+		std::string names;
+		for (const auto& column : header.columns) {
+			names.append(column).push_back('\0');
+		}
+		const std::size_t unpadded_size = history_fixed_header_size + names.size();
+		header.header_size = uint32_t((unpadded_size + 7) / 8 * 8);
+
+		std::string buf(history_magic, sizeof(history_magic));
+		history_put<uint32_t>(buf, history_version);
+		history_put<uint32_t>(buf, header.header_size);
+		history_put<int64_t>(buf, header.base_time);
+		history_put<uint32_t>(buf, uint32_t(header.columns.size()));
+		history_put<uint32_t>(buf, 0);  // reserved
+		buf += names;
+		buf.resize(header.header_size, '\0');
+		return buf;
+	}
+
+
+	/// Serialize a record. \c values are in header column order.
+	void history_serialize_record(std::string& buf, uint32_t time_delta, const std::vector<int64_t>& values)
+	{
+		history_put<uint32_t>(buf, time_delta);
+		history_put<uint32_t>(buf, 0);  // padding
+		for (const int64_t value : values) {
+			history_put<int64_t>(buf, value);
+		}
+	}
+
+
+	/// Read and validate the header
+	std::error_code history_read_header(std::FILE* f, HistoryHeader& header)
+	{
+		char fixed[history_fixed_header_size];
+		if (std::fread(fixed, 1, sizeof(fixed), f) != sizeof(fixed)) {
+			return std::make_error_code(std::errc::io_error);
+		}
+		if (std::memcmp(fixed, history_magic, sizeof(history_magic)) != 0 || history_get<uint32_t>(fixed + 8) != history_version) {
+			return std::make_error_code(std::errc::invalid_argument);
+		}
+		header.header_size = history_get<uint32_t>(fixed + 12);
+		header.base_time = history_get<int64_t>(fixed + 16);
+		const auto num_columns = history_get<uint32_t>(fixed + 24);
+		if (header.header_size < history_fixed_header_size || header.header_size > history_max_header_size
+				|| header.header_size % 8 != 0 || num_columns > header.header_size) {
+			return std::make_error_code(std::errc::invalid_argument);
+		}
+
+		std::string names(header.header_size - history_fixed_header_size, '\0');
+		if (std::fread(names.data(), 1, names.size(), f) != names.size()) {
+			return std::make_error_code(std::errc::io_error);
+		}
+		header.columns.clear();
+		std::string::size_type pos = 0;
+		for (uint32_t i = 0; i < num_columns; ++i) {
+			const std::string::size_type end = names.find('\0', pos);
+			if (end == std::string::npos) {
+				return std::make_error_code(std::errc::invalid_argument);
+			}
+			header.columns.push_back(names.substr(pos, end - pos));
+			pos = end + 1;
+		}
+		return {};
+	}
+
+
+	/// Read the time of record \c index
+	std::error_code history_read_record_time(std::FILE* f, const HistoryHeader& header, std::uintmax_t index, int64_t& time)
+	{
+		if (hz::fs_platform_fseek(f, header.header_size + index * header.get_record_size(), SEEK_SET) != 0) {
+			return history_errno_error();
+		}
+		uint32_t delta = 0;
+		if (std::fread(&delta, sizeof(delta), 1, f) != 1) {
+			return std::make_error_code(std::errc::io_error);
+		}
+		time = header.base_time + int64_t(delta);
+		return {};
+	}
+
+}
+
+
+
+std::optional<std::size_t> AttributeHistoryTable::find_column(const std::string& name) const
+{
+	auto iter = std::find(columns.cbegin(), columns.cend(), name);
+	if (iter == columns.cend()) {
+		return std::nullopt;
+	}
+	return std::size_t(iter - columns.cbegin());
+}
+
+
+
+AttributeHistoryStore::AttributeHistoryStore(hz::fs::path dir)
+		: dir_(std::move(dir))
+{ }
+
+
+
+std::map<std::string, int64_t> AttributeHistoryStore::collect_values(const std::vector<AtaStorageProperty>& props)
+{
+	std::map<std::string, int64_t> values;
+	for (const auto& p : props) {
+		if (p.section != AtaStorageProperty::Section::data) {
+			continue;
+		}
+		if (p.is_value_type<AtaStorageAttribute>()) {
+			const auto& attr = p.get_value<AtaStorageAttribute>();
+			const std::string prefix = "attr/" + std::to_string(attr.id);
+			values[prefix + "/raw"] = attr.raw_value_int;
+			if (attr.value.has_value()) {
+				values[prefix + "/norm"] = attr.value.value();
+			}
+
+		} else if (p.is_value_type<AtaStorageStatistic>()) {
+			const auto& st = p.get_value<AtaStorageStatistic>();
+			if (!st.is_header) {
+				values[hz::string_sprintf("devstat/0x%02x/0x%03x", int(st.page), int(st.offset))] = st.value_int;
+			}
+
+		} else if (p.generic_name == "ata_sct_status/temperature/current" && p.is_value_type<int64_t>()) {
+			values["temperature"] = p.get_value<int64_t>();
+		}
+	}
+	return values;
+}
+
+
+
+std::error_code AttributeHistoryStore::append(const std::string& serial, int64_t time, const std::map<std::string, int64_t>& values) const
+{
+	if (serial.empty() || values.empty()) {
+		return std::make_error_code(std::errc::invalid_argument);
+	}
+
+	std::error_code ec;
+	const hz::fs::path file = get_file(serial);
+	hz::fs::create_directories(dir_, ec);
+	if (ec) {
+		return ec;
+	}
+
+	HistoryHeader header;
+	std::uintmax_t num_records = 0;
+	bool has_new_columns = true;
+
+	if (hz::fs::exists(file, ec)) {
+		FilePtr f(hz::fs_platform_fopen(file, "rb"));
+		if (!f) {
+			return history_errno_error();
+		}
+		if ((ec = history_read_header(f.get(), header))) {
+			debug_out_warn("app", DBG_FUNC_MSG << "Invalid history file \"" << file.u8string() << "\".\n");
+			return ec;
+		}
+		const std::uintmax_t file_size = hz::fs::file_size(file, ec);
+		if (ec) {
+			return ec;
+		}
+		num_records = (file_size - std::min<std::uintmax_t>(file_size, header.header_size)) / header.get_record_size();
+
+		if (num_records > 0) {
+			int64_t last_time = 0;
+			if ((ec = history_read_record_time(f.get(), header, num_records - 1, last_time))) {
+				return ec;
+			}
+			if (time < last_time) {
+				return std::make_error_code(std::errc::invalid_argument);
+			}
+		}
+		f.reset();
+
+		// A crash while appending may leave a partial record at the end, drop it.
+		const std::uintmax_t valid_size = header.header_size + num_records * header.get_record_size();
+		if (file_size > valid_size) {
+			hz::fs::resize_file(file, valid_size, ec);
+			if (ec) {
+				return ec;
+			}
+		}
+
+		has_new_columns = std::any_of(values.cbegin(), values.cend(), [&header](const auto& value) {
+			return std::find(header.columns.cbegin(), header.columns.cend(), value.first) == header.columns.cend();
+		});
+	}
+
+	// New file, or new columns appeared. Write the whole file, including the existing records.
+	if (has_new_columns) {
+		AttributeHistoryTable table;
+		if ((ec = read_range(serial, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), table))) {
+			return ec;
+		}
+
+		HistoryHeader new_header;
+		new_header.base_time = (table.times.empty() ? time : header.base_time);
+		new_header.columns = table.columns;
+		for (const auto& value : values) {
+			if (!table.find_column(value.first).has_value()) {
+				new_header.columns.push_back(value.first);
+			}
+		}
+		if (time - new_header.base_time > int64_t(std::numeric_limits<uint32_t>::max())) {
+			return std::make_error_code(std::errc::value_too_large);
+		}
+
+		std::string buf = history_serialize_header(new_header);
+		buf.reserve(buf.size() + (table.times.size() + 1) * new_header.get_record_size());
+		std::vector<int64_t> row(new_header.columns.size(), AttributeHistoryTable::missing_value);
+		for (std::size_t i = 0; i < table.times.size(); ++i) {
+			std::fill(row.begin(), row.end(), AttributeHistoryTable::missing_value);
+			for (std::size_t col = 0; col < table.columns.size(); ++col) {
+				row[col] = table.values[col][i];  // old columns keep their positions
+			}
+			history_serialize_record(buf, uint32_t(table.times[i] - new_header.base_time), row);
+		}
+		for (std::size_t col = 0; col < new_header.columns.size(); ++col) {
+			auto iter = values.find(new_header.columns[col]);
+			row[col] = (iter == values.end() ? AttributeHistoryTable::missing_value : iter->second);
+		}
+		history_serialize_record(buf, uint32_t(time - new_header.base_time), row);
+
+		return hz::fs_file_put_contents_atomic(file, buf);
+	}
+
+	if (time - header.base_time > int64_t(std::numeric_limits<uint32_t>::max())) {
+		return std::make_error_code(std::errc::value_too_large);
+	}
+
+	std::vector<int64_t> row(header.columns.size(), AttributeHistoryTable::missing_value);
+	for (std::size_t col = 0; col < header.columns.size(); ++col) {
+		auto iter = values.find(header.columns[col]);
+		if (iter != values.end()) {
+			row[col] = iter->second;
+		}
+	}
+	std::string buf;
+	buf.reserve(header.get_record_size());
+	history_serialize_record(buf, uint32_t(time - header.base_time), row);
+
+	FilePtr f(hz::fs_platform_fopen(file, "ab"));
+	if (!f) {
+		return history_errno_error();
+	}
+	if (std::fwrite(buf.data(), 1, buf.size(), f.get()) != buf.size()) {
+		return std::make_error_code(std::errc::io_error);
+	}
+	if (std::fclose(f.release()) != 0) {
+		return history_errno_error();
+	}
+	return {};
+}
+
+
+
+std::error_code AttributeHistoryStore::append_drive(const StorageDevice& drive) const
+{
+	const std::string serial = drive.get_serial_number();
+	if (serial.empty() || drive.get_parse_status() != StorageDevice::ParseStatus::full) {
+		return std::make_error_code(std::errc::invalid_argument);
+	}
+	const auto values = collect_values(drive.get_properties());
+	if (values.empty()) {
+		return {};  // nothing to record, e.g. a drive without SMART attributes
+	}
+	auto ec = append(serial, int64_t(std::time(nullptr)), values);
+	if (ec) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot append to history of drive with serial \""
+				<< serial << "\": " << ec.message() << "\n");
+	}
+	return ec;
+}
+
+
+
+std::error_code AttributeHistoryStore::read_range(const std::string& serial, int64_t from_time, int64_t to_time,
+		AttributeHistoryTable& table) const
+{
+	table = AttributeHistoryTable();
+
+	std::error_code ec;
+	const hz::fs::path file = get_file(serial);
+	if (!hz::fs::exists(file, ec)) {
+		return {};
+	}
+
+	FilePtr f(hz::fs_platform_fopen(file, "rb"));
+	if (!f) {
+		return history_errno_error();
+	}
+	HistoryHeader header;
+	if ((ec = history_read_header(f.get(), header))) {
+		return ec;
+	}
+	const std::uintmax_t file_size = hz::fs::file_size(file, ec);
+	if (ec) {
+		return ec;
+	}
+	const std::uintmax_t num_records = (file_size - std::min<std::uintmax_t>(file_size, header.header_size)) / header.get_record_size();
+
+	table.columns = header.columns;
+	table.values.resize(header.columns.size());
+
+	// Find the first record with time >= from_time
+	std::uintmax_t first = 0, last = num_records;
+	while (first < last) {
+		const std::uintmax_t mid = first + (last - first) / 2;
+		int64_t mid_time = 0;
+		if ((ec = history_read_record_time(f.get(), header, mid, mid_time))) {
+			return ec;
+		}
+		if (mid_time < from_time) {
+			first = mid + 1;
+		} else {
+			last = mid;
+		}
+	}
+
+	if (first < num_records && hz::fs_platform_fseek(f.get(), header.header_size + first * header.get_record_size(), SEEK_SET) != 0) {
+		return history_errno_error();
+	}
+	std::string record(header.get_record_size(), '\0');
+	for (std::uintmax_t i = first; i < num_records; ++i) {
+		if (std::fread(record.data(), 1, record.size(), f.get()) != record.size()) {
+			return std::make_error_code(std::errc::io_error);
+		}
+		const int64_t time = header.base_time + int64_t(history_get<uint32_t>(record.data()));
+		if (time > to_time) {
+			break;
+		}
+		table.times.push_back(time);
+		for (std::size_t col = 0; col < header.columns.size(); ++col) {
+			table.values[col].push_back(history_get<int64_t>(record.data() + 8 + 8 * col));
+		}
+	}
+
+	return {};
+}
+
+
+
+hz::fs::path AttributeHistoryStore::get_file(const std::string& serial) const
+{
+	return dir_ / hz::fs::u8path(hz::fs_filename_make_safe(serial) + ".gschist");
+}
+
+
+
+
+
+
+/// @}
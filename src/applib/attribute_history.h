@@ -0,0 +1,102 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef ATTRIBUTE_HISTORY_H
+#define ATTRIBUTE_HISTORY_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <optional>
+#include <cstdint>
+#include <limits>
+#include <system_error>
+
+#include "hz/fs_ns.h"
+#include "ata_storage_property.h"
+#include "storage_device.h"
+
+
+
+/// Values read from the attribute history, stored column by column.
+struct AttributeHistoryTable {
+
+	/// Value of a column which was not present in a sample
+	static constexpr int64_t missing_value = std::numeric_limits<int64_t>::min();
+
+	/// Find column by name
+	[[nodiscard]] std::optional<std::size_t> find_column(const std::string& name) const;
+
+	std::vector<std::string> columns;  ///< Column names, e.g. "attr/5/raw"
+	std::vector<int64_t> times;  ///< Sample times (seconds since epoch), one per row
+	std::vector<std::vector<int64_t>> values;  ///< values[column][row]
+};
+
+
+
+/**
+Append-only store of numeric drive data (attribute values, device statistics,
+temperature), with one file per drive serial number.
+
+Each file has a header with the column names and the time of the first sample,
+followed by fixed-width records: a 32-bit time delta from the first sample
+and a 64-bit value for each column. The records are 8-byte aligned, so the file
+may be memory-mapped as an array. Appending is O(1) unless a sample brings a
+new column (e.g. after a firmware update), in which case the file is rewritten
+once with the extended header. Since the times are ordered, range queries
+binary-search the first record and read sequentially from there.
+
+The files are in native byte order, they are not meant to be moved between machines.
+*/
+class AttributeHistoryStore {
+	public:
+
+		/// Constructor. \c dir is created on first append.
+		explicit AttributeHistoryStore(hz::fs::path dir);
+
+
+		/// Extract the numeric values to record from the parsed properties.
+		/// Column names are "attr/<id>/raw", "attr/<id>/norm", "devstat/<page>/<offset>" and "temperature".
+		[[nodiscard]] static std::map<std::string, int64_t> collect_values(const std::vector<AtaStorageProperty>& props);
+
+
+		/// Append a sample for a drive. \c time must not be earlier than the last recorded sample.
+		std::error_code append(const std::string& serial, int64_t time, const std::map<std::string, int64_t>& values) const;
+
+
+		/// Append the current values of a drive with full data (the serial number must be known).
+		std::error_code append_drive(const StorageDevice& drive) const;
+
+
+		/// Read the samples with time in [from_time, to_time] into \c table.
+		/// A missing file is not an error, the table is left empty.
+		std::error_code read_range(const std::string& serial, int64_t from_time, int64_t to_time,
+				AttributeHistoryTable& table) const;
+
+
+		/// Get the history file of a drive
+		[[nodiscard]] hz::fs::path get_file(const std::string& serial) const;
+
+
+	private:
+
+		hz::fs::path dir_;  ///< Directory with history files
+
+};
+
+
+
+
+
+
+#endif
+
+/// @}
@@ -0,0 +1,212 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include "local_glibmm.h"
+#include <cmath>
+#include <algorithm>
+
+#include "hz/format_unit.h"  // format_time_length
+#include "hz/string_num.h"  // number_to_string_locale
+#include "attribute_trend.h"
+
+
+
+using namespace std::literals;
+
+
+
+namespace {
+
+	/// Time constant of the long-term rate
+	constexpr double trend_long_tau_days = 30.;
+
+	/// Time constant of the short-term rate
+	constexpr double trend_short_tau_days = 3.;
+
+	/// The short-term rate must be at least this many times the long-term one to be "accelerating"
+	constexpr double trend_acceleration_factor = 2.;
+
+	/// Minimal short-term rate (per day) to be considered accelerating, to ignore noise
+	constexpr double trend_acceleration_min_rate = 0.1;
+
+	/// Projected time to limit below which a warning is shown
+	constexpr std::chrono::hours trend_limit_warning_time = std::chrono::hours(24 * 180);
+
+	constexpr double seconds_per_day = 24. * 60. * 60.;
+
+	/// Minimal interval (seconds) to measure a rate over. Samples closer than that are
+	/// accumulated, otherwise one counter step minutes after the previous sample
+	/// would be a rate of hundreds per day.
+	constexpr int64_t trend_min_rate_interval = 24 * 60 * 60;
+
+}
+
+
+
+const std::vector<AttributeTrendMetric>& attribute_trend_get_default_metrics()
+{
+	static const std::vector<AttributeTrendMetric> metrics = {
+		{"attr/5/raw", _("Reallocated Sector Count"), 1, std::nullopt},
+		{"attr/196/raw", _("Reallocation Event Count"), 1, std::nullopt},
+		{"attr/197/raw", _("Current Pending Sector Count"), 1, std::nullopt},
+		{"attr/198/raw", _("Offline Uncorrectable"), 1, std::nullopt},
+		{"attr/187/raw", _("Reported Uncorrectable"), 1, std::nullopt},
+		{"attr/199/raw", _("UDMA CRC Error Count"), 1, std::nullopt},
+		{"attr/177/norm", _("Wear Leveling Count"), -1, 0},
+		{"attr/231/norm", _("SSD Life Left"), -1, 0},
+		{"attr/233/norm", _("Media Wearout Indicator"), -1, 0},
+		{"devstat/0x07/0x008", _("Percentage Used Endurance Indicator"), 1, 100},
+	};
+	return metrics;
+}
+
+
+
+WarningLevel AttributeTrend::get_warning_level() const
+{
+	if (accelerating || (time_to_limit.has_value() && time_to_limit.value() < trend_limit_warning_time)) {
+		return WarningLevel::warning;
+	}
+	// Error counters shouldn't grow at all. Wear indicators are expected to.
+	if (!metric.limit.has_value() && total_change > 0) {
+		return WarningLevel::notice;
+	}
+	return WarningLevel::none;
+}
+
+
+
+std::string AttributeTrend::format() const
+{
+	std::string str = Glib::ustring::compose(_("%1 changed by %2 since the first recorded value, currently %3 per day"),
+			metric.displayable_name, hz::number_to_string_locale(total_change * metric.bad_direction),
+			hz::number_to_string_locale(recent_rate_per_day * metric.bad_direction, 2, true));
+	if (accelerating) {
+		str += " "s + _("(accelerating)");
+	}
+	if (time_to_limit.has_value()) {
+		str += ", "s + Glib::ustring::compose(_("projected to reach %1 in %2"),
+				hz::number_to_string_locale(metric.limit.value_or(0)), hz::format_time_length(time_to_limit.value()));
+	}
+	return str;
+}
+
+
+
+AttributeTrendTracker::AttributeTrendTracker(const std::vector<AttributeTrendMetric>& metrics)
+		: metrics_(metrics)
+{
+	trends_.resize(metrics_.size());
+	for (std::size_t i = 0; i < metrics_.size(); ++i) {
+		trends_[i].metric = metrics_[i];
+	}
+}
+
+
+
+void AttributeTrendTracker::add_sample(int64_t time, const std::map<std::string, int64_t>& values)
+{
+	for (std::size_t i = 0; i < metrics_.size(); ++i) {
+		auto iter = values.find(metrics_[i].column);
+		if (iter != values.end() && iter->second != AttributeHistoryTable::missing_value) {
+			update_trend(trends_[i], time, iter->second);
+		}
+	}
+}
+
+
+
+void AttributeTrendTracker::add_samples(const AttributeHistoryTable& table)
+{
+	for (std::size_t i = 0; i < metrics_.size(); ++i) {
+		const auto col = table.find_column(metrics_[i].column);
+		if (!col.has_value()) {
+			continue;
+		}
+		const auto& values = table.values.at(col.value());
+		for (std::size_t row = 0; row < table.times.size(); ++row) {
+			if (values[row] != AttributeHistoryTable::missing_value) {
+				update_trend(trends_[i], table.times[row], values[row]);
+			}
+		}
+	}
+}
+
+
+
+const std::vector<AttributeTrend>& AttributeTrendTracker::get_trends() const
+{
+	return trends_;
+}
+
+
+
+void AttributeTrendTracker::update_trend(AttributeTrend& trend, int64_t time, int64_t value)
+{
+	if (trend.num_samples == 0) {
+		trend.num_samples = 1;
+		trend.last_time = time;
+		trend.last_value = value;
+		trend.rate_start_time = time;
+		trend.rate_start_value = value;
+		return;
+	}
+	if (time <= trend.last_time) {
+		return;  // out of order or duplicate
+	}
+
+	// Change in the bad direction. Decreasing error counters (e.g. after a firmware reset) don't make it better.
+	const int64_t change = std::max<int64_t>(0, (value - trend.last_value) * trend.metric.bad_direction);
+
+	++trend.num_samples;
+	trend.last_time = time;
+	trend.last_value = value;
+	trend.total_change += change;
+
+	if (time - trend.rate_start_time < trend_min_rate_interval) {
+		return;  // too close to measure a rate, keep accumulating
+	}
+
+	const double days = double(time - trend.rate_start_time) / seconds_per_day;
+	const int64_t rate_change = std::max<int64_t>(0, (value - trend.rate_start_value) * trend.metric.bad_direction);
+	const double rate = double(rate_change) / days;
+	trend.rate_start_time = time;
+	trend.rate_start_value = value;
+
+	// Exponential weighting by elapsed time, so that irregular intervals are handled
+	if (trend.num_rates == 0) {
+		trend.rate_per_day = rate;
+		trend.recent_rate_per_day = rate;
+	} else {
+		const double long_alpha = 1. - std::exp(-days / trend_long_tau_days);
+		const double short_alpha = 1. - std::exp(-days / trend_short_tau_days);
+		trend.rate_per_day += long_alpha * (rate - trend.rate_per_day);
+		trend.recent_rate_per_day += short_alpha * (rate - trend.recent_rate_per_day);
+	}
+	++trend.num_rates;
+
+	trend.accelerating = trend.num_rates > 1
+			&& trend.recent_rate_per_day >= trend_acceleration_min_rate
+			&& trend.recent_rate_per_day > trend_acceleration_factor * trend.rate_per_day;
+
+	trend.time_to_limit.reset();
+	if (trend.metric.limit.has_value() && trend.recent_rate_per_day > 0.) {
+		const int64_t remaining = std::max<int64_t>(0, (trend.metric.limit.value() - value) * trend.metric.bad_direction);
+		trend.time_to_limit = std::chrono::seconds(int64_t(double(remaining) / trend.recent_rate_per_day * seconds_per_day));
+	}
+}
+
+
+
+
+
+
+/// @}
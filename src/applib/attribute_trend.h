@@ -0,0 +1,112 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef ATTRIBUTE_TREND_H
+#define ATTRIBUTE_TREND_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <optional>
+#include <chrono>
+#include <cstdint>
+
+#include "warning_level.h"
+#include "attribute_history.h"
+
+
+
+/// A history column whose change over time predicts failure
+struct AttributeTrendMetric {
+	std::string column;  ///< History column, e.g. "attr/5/raw"
+	std::string displayable_name;  ///< Readable name
+	int bad_direction = 1;  ///< 1 if increasing values are bad (error counters), -1 if decreasing ones are (remaining life).
+	std::optional<int64_t> limit;  ///< Value at which the drive is considered worn out, if any.
+};
+
+
+/// Get the default tracked metrics: reallocated, pending, uncorrectable and CRC error
+/// counters, and SSD wear indicators.
+const std::vector<AttributeTrendMetric>& attribute_trend_get_default_metrics();
+
+
+
+/// Trend of one metric
+struct AttributeTrend {
+
+	/// Get warning level of this trend
+	[[nodiscard]] WarningLevel get_warning_level() const;
+
+	/// Format as a displayable string, e.g. "Reallocated Sector Count changed by 3 since ...".
+	[[nodiscard]] std::string format() const;
+
+	AttributeTrendMetric metric;  ///< Metric this trend is for
+	std::size_t num_samples = 0;  ///< Number of samples with a value
+	int64_t last_time = 0;  ///< Time of the last sample
+	int64_t last_value = 0;  ///< Value of the last sample
+	int64_t total_change = 0;  ///< Change in the bad direction since the first sample
+	int64_t rate_start_time = 0;  ///< Start of the interval over which the next rate is measured
+	int64_t rate_start_value = 0;  ///< Value at rate_start_time
+	std::size_t num_rates = 0;  ///< Number of measured rates (intervals of at least a day)
+	double rate_per_day = 0.;  ///< Long-term rate of change in the bad direction (exponentially weighted)
+	double recent_rate_per_day = 0.;  ///< Short-term rate of change in the bad direction (exponentially weighted)
+	bool accelerating = false;  ///< Whether the short-term rate is considerably higher than the long-term one
+	std::optional<std::chrono::seconds> time_to_limit;  ///< Projected time until the metric reaches its limit
+};
+
+
+
+/**
+Computes trends of failure-predicting metrics from a sequence of samples.
+Samples are processed incrementally, each in O(number of metrics) time with
+O(1) state per metric, so a tracker may be kept per drive and updated as new
+samples arrive. Rates are exponentially weighted by time, so irregular sampling
+intervals are fine. A rate is measured over at least a day, so that a single
+step between two close samples doesn't look like a huge rate.
+*/
+class AttributeTrendTracker {
+	public:
+
+		/// Constructor
+		explicit AttributeTrendTracker(const std::vector<AttributeTrendMetric>& metrics = attribute_trend_get_default_metrics());
+
+
+		/// Process a sample. Samples must be added in time order, older ones are ignored.
+		void add_sample(int64_t time, const std::map<std::string, int64_t>& values);
+
+
+		/// Process all samples of a history table
+		void add_samples(const AttributeHistoryTable& table);
+
+
+		/// Get the trends, one per metric (metrics without samples have num_samples == 0).
+		[[nodiscard]] const std::vector<AttributeTrend>& get_trends() const;
+
+
+	private:
+
+		/// Process a new value of a metric
+		void update_trend(AttributeTrend& trend, int64_t time, int64_t value);
+
+
+		std::vector<AttributeTrendMetric> metrics_;  ///< Tracked metrics
+		std::vector<AttributeTrend> trends_;  ///< Trends, parallel to metrics_
+
+};
+
+
+
+
+
+
+#endif
+
+/// @}
@@ -12,6 +12,7 @@ Copyright:
 #include "local_glibmm.h"
 #include <glib.h>  // g_usleep()
 
+#include "hz/string_algo.h"  // string_join
 #include "command_executor.h"
 
 
@@ -52,6 +53,24 @@ void CommandExecutor::set_command(std::string command_name, std::string command_
 
 
 
+void CommandExecutor::set_command_argv(std::vector<std::string> argv)
+{
+	DBG_ASSERT_RETURN_NONE(!argv.empty());
+
+	// keep a quoted copy for display and logging
+	std::vector<std::string> quoted_args;
+	quoted_args.reserve(argv.size() - 1);
+	for (std::size_t i = 1; i < argv.size(); ++i) {
+		quoted_args.push_back(Glib::shell_quote(argv[i]));
+	}
+	command_name_ = Glib::shell_quote(argv.front());
+	command_args_ = hz::string_join(quoted_args, " ");
+
+	cmdex_.set_command_argv(std::move(argv));
+}
+
+
+
 std::string CommandExecutor::get_command_name() const
 {
 	return command_name_;
@@ -69,6 +88,9 @@ std::string CommandExecutor::get_command_args() const
 bool CommandExecutor::execute()
 {
 	set_error_msg("");  // clear old error if present
+	execution_time_ = std::chrono::milliseconds(0);
+	stdout_.reset();
+	stderr_.reset();
 
 	const bool slot_connected = !(signal_execute_tick().slots().begin() == signal_execute_tick().slots().end());
 
@@ -78,16 +100,21 @@ bool CommandExecutor::execute()
 	if (!cmdex_.execute()) {  // try to execute
 		debug_out_error("app", DBG_FUNC_MSG << "cmdex_.execute() failed.\n");
 		import_error();  // get error from cmdex and display warnings if needed
+		take_output();
 
 		// emit this for execution loggers
 		cmdex_sync_signal_execute_finish().emit(CommandExecutorResult(get_command_name(),
-				get_command_args(), get_stdout_str(), get_stderr_str(), get_error_msg()));
+				get_command_args(), get_stdout_shared(), get_stderr_shared(), get_error_msg()));
 
 		if (slot_connected)
 			signal_execute_tick().emit(TickStatus::failed);
 		return false;
 	}
 
+	if (execution_term_timeout_msec_.count() != 0 || execution_kill_timeout_msec_.count() != 0) {
+		cmdex_.set_stop_timeouts(execution_term_timeout_msec_, execution_kill_timeout_msec_);
+	}
+
 	bool stop_requested = false;  // stop requested from tick function
 	bool signals_sent = false;  // stop signals sent
 
@@ -139,9 +166,13 @@ bool CommandExecutor::execute()
 	cmdex_.stopped_cleanup();
 	import_error();  // get error from cmdex and display warnings if needed
 
-	// emit this for execution loggers
+	execution_time_ = std::chrono::milliseconds(static_cast<std::chrono::milliseconds::rep>(
+			cmdex_.get_execution_time_sec() * 1000.));
+	take_output();
+
+	// emit this for execution loggers. The output buffers are shared, not copied.
 	cmdex_sync_signal_execute_finish().emit(CommandExecutorResult(get_command_name(),
-			get_command_args(), get_stdout_str(), get_stderr_str(), get_error_msg()));
+			get_command_args(), get_stdout_shared(), get_stderr_shared(), get_error_msg(), execution_time_));
 
 	if (slot_connected)
 		signal_execute_tick().emit(TickStatus::stopped);  // last call
@@ -172,6 +203,21 @@ bool CommandExecutor::try_kill()
 
 
 
+void CommandExecutor::set_execution_timeouts(std::chrono::milliseconds term_timeout_msec, std::chrono::milliseconds kill_timeout_msec)
+{
+	execution_term_timeout_msec_ = term_timeout_msec;
+	execution_kill_timeout_msec_ = kill_timeout_msec;
+}
+
+
+
+std::chrono::milliseconds CommandExecutor::get_execution_time() const
+{
+	return execution_time_;
+}
+
+
+
 void CommandExecutor::set_stop_timeouts(std::chrono::milliseconds term_timeout_msec, std::chrono::milliseconds kill_timeout_msec)
 {
 	cmdex_.set_stop_timeouts(term_timeout_msec, kill_timeout_msec);
@@ -200,16 +246,30 @@ void CommandExecutor::set_buffer_sizes(gsize stdout_buffer_size, gsize stderr_bu
 
 
 
-std::string CommandExecutor::get_stdout_str(bool clear_existing)
+const std::string& CommandExecutor::get_stdout_str() const
 {
-	return cmdex_.get_stdout_str(clear_existing);
+	return shared_output_str(stdout_);
 }
 
 
 
-std::string CommandExecutor::get_stderr_str(bool clear_existing)
+const std::string& CommandExecutor::get_stderr_str() const
 {
-	return cmdex_.get_stderr_str(clear_existing);
+	return shared_output_str(stderr_);
+}
+
+
+
+SharedOutput CommandExecutor::get_stdout_shared() const
+{
+	return stdout_ ? stdout_ : make_shared_output(std::string());
+}
+
+
+
+SharedOutput CommandExecutor::get_stderr_shared() const
+{
+	return stderr_ ? stderr_ : make_shared_output(std::string());
 }
 
 
@@ -221,6 +281,13 @@ void CommandExecutor::set_exit_status_translator(AsyncCommandExecutor::exit_stat
 
 
 
+void CommandExecutor::set_child_setup(AsyncCommandExecutor::child_setup_func_t func)
+{
+	cmdex_.set_child_setup(std::move(func));
+}
+
+
+
 std::string CommandExecutor::get_error_msg(bool with_header) const
 {
 	if (with_header)
@@ -303,6 +370,15 @@ AsyncCommandExecutor& CommandExecutor::get_async_executor()
 
 
 
+void CommandExecutor::take_output()
+{
+	// The buffers are moved, not copied. Everyone down the line shares them.
+	stdout_ = make_shared_output(cmdex_.get_stdout_str(true));
+	stderr_ = make_shared_output(cmdex_.get_stderr_str(true));
+}
+
+
+
 
 
 
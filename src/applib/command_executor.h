@@ -14,6 +14,7 @@ Copyright:
 
 #include <sigc++/sigc++.h>
 #include <string>
+#include <vector>
 #include <chrono>
 #include <utility>
 
@@ -21,25 +22,29 @@ Copyright:
 #include "hz/process_signal.h"  // hz::SIGNAL_*
 
 #include "async_command_executor.h"
+#include "shared_output.h"
 
 
 
 /// Information about a finished command.
 struct CommandExecutorResult {
 	CommandExecutorResult(std::string arg_command, std::string arg_parameters,
-			std::string arg_std_output, std::string arg_std_error, std::string arg_error_message)
+			SharedOutput arg_std_output, SharedOutput arg_std_error, std::string arg_error_message,
+			std::chrono::milliseconds arg_execution_time = std::chrono::milliseconds(0))
 			: command(std::move(arg_command)),
 			parameters(std::move(arg_parameters)),
 			std_output(std::move(arg_std_output)),
 			std_error(std::move(arg_std_error)),
-			error_message(std::move(arg_error_message))
+			error_message(std::move(arg_error_message)),
+			execution_time(arg_execution_time)
 	{ }
 
 	const std::string command;  ///< Executed command
 	const std::string parameters;  ///< Command parameters
-	const std::string std_output;  ///< Stdout data
-	const std::string std_error;  ///< Stderr data
+	const SharedOutput std_output;  ///< Stdout data, shared with the executor. Never null.
+	const SharedOutput std_error;  ///< Stderr data, shared with the executor. Never null.
 	const std::string error_message;  ///< Execution error message
+	const std::chrono::milliseconds execution_time;  ///< Time from spawning the command until it exited
 };
 
 
@@ -87,6 +92,12 @@ class CommandExecutor : public sigc::trackable {
 		void set_command(std::string command_name, std::string command_args);
 
 
+		/// Set command to execute as an argument vector (binary first), bypassing
+		/// shell parsing. get_command_name() and get_command_args() will return
+		/// shell-quoted versions of it.
+		void set_command_argv(std::vector<std::string> argv);
+
+
 		/// Get command to execute
 		std::string get_command_name() const;
 
@@ -116,6 +127,15 @@ class CommandExecutor : public sigc::trackable {
 		bool try_kill();
 
 
+		/// Set timeouts (since the command start) to terminate, kill or both (use 0 to ignore
+		/// the parameter). Unlike set_stop_timeouts(), this is called before execute().
+		void set_execution_timeouts(std::chrono::milliseconds term_timeout_msec, std::chrono::milliseconds kill_timeout_msec);
+
+
+		/// Get the execution time of the last executed command
+		std::chrono::milliseconds get_execution_time() const;
+
+
 		/// Set a timeout (since call to this function) to terminate, kill or both (use 0 to ignore the parameter).
 		/// the timeouts will be unset automatically when the command exits.
 		/// Call from ticker slot while executing.
@@ -135,15 +155,24 @@ class CommandExecutor : public sigc::trackable {
 		/// See AsyncCommandExecutor::set_buffer_sizes() for details. Call this before execute().
 		void set_buffer_sizes(gsize stdout_buffer_size = 0, gsize stderr_buffer_size = 0);
 
-		/// See AsyncCommandExecutor::get_stdout_str() for details.
-		std::string get_stdout_str(bool clear_existing = false);
+		/// Get the stdout data of the last executed command. Call this after execute().
+		[[nodiscard]] const std::string& get_stdout_str() const;
+
+		/// Get the stderr data of the last executed command. Call this after execute().
+		[[nodiscard]] const std::string& get_stderr_str() const;
 
-		/// See AsyncCommandExecutor::get_stderr_str() for details.
-		std::string get_stderr_str(bool clear_existing = false);
+		/// Get the stdout data of the last executed command as a shared buffer, without copying it.
+		[[nodiscard]] SharedOutput get_stdout_shared() const;
+
+		/// Get the stderr data of the last executed command as a shared buffer, without copying it.
+		[[nodiscard]] SharedOutput get_stderr_shared() const;
 
 		/// See AsyncCommandExecutor::set_exit_status_translator() for details.
 		void set_exit_status_translator(AsyncCommandExecutor::exit_status_translator_func_t func);
 
+		/// See AsyncCommandExecutor::set_child_setup() for details. Call this before execute().
+		void set_child_setup(AsyncCommandExecutor::child_setup_func_t func);
+
 
 		/// Get command execution error message. If \c with_header
 		/// is true, a header set using set_error_header() will be displayed first.
@@ -202,6 +231,10 @@ class CommandExecutor : public sigc::trackable {
 		AsyncCommandExecutor& get_async_executor();
 
 
+		/// Move the output of the finished command from cmdex_ into shared buffers
+		void take_output();
+
+
 	private:
 
 		AsyncCommandExecutor cmdex_;  ///< Command executor
@@ -213,6 +246,13 @@ class CommandExecutor : public sigc::trackable {
 
 		std::chrono::milliseconds forced_kill_timeout_msec_ = std::chrono::seconds(3);  // 3 sec by default. Kill timeout in ms.
 
+		std::chrono::milliseconds execution_term_timeout_msec_ = std::chrono::milliseconds(0);  ///< Terminate timeout since start, 0 if none
+		std::chrono::milliseconds execution_kill_timeout_msec_ = std::chrono::milliseconds(0);  ///< Kill timeout since start, 0 if none
+		std::chrono::milliseconds execution_time_ = std::chrono::milliseconds(0);  ///< Execution time of the last command
+
+		SharedOutput stdout_;  ///< Stdout data of the last command
+		SharedOutput stderr_;  ///< Stderr data of the last command
+
 		std::string error_msg_;  ///< Execution error message
 		std::string error_header_;  ///< The error message may have this prepended to it.
 
@@ -0,0 +1,192 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+
+#include "command_latency_stats.h"
+
+
+
+void CommandLatencyStats::add_sample(std::chrono::milliseconds duration, bool timed_out)
+{
+	recent_.at(sample_count_ % window_size) = duration;
+	if (sample_count_ == 0) {
+		average_msec_ = static_cast<double>(duration.count());
+	} else {
+		average_msec_ = ewma_weight * static_cast<double>(duration.count()) + (1. - ewma_weight) * average_msec_;
+	}
+	++sample_count_;
+	max_ = std::max(max_, duration);
+
+	if (timed_out) {
+		++timeout_count_;
+		++consecutive_timeout_count_;
+	} else {
+		consecutive_timeout_count_ = 0;
+	}
+}
+
+
+
+std::size_t CommandLatencyStats::get_sample_count() const
+{
+	return sample_count_;
+}
+
+
+
+std::chrono::milliseconds CommandLatencyStats::get_average() const
+{
+	return std::chrono::milliseconds(static_cast<std::chrono::milliseconds::rep>(std::llround(average_msec_)));
+}
+
+
+
+std::chrono::milliseconds CommandLatencyStats::get_percentile(double p) const
+{
+	const std::size_t count = std::min(sample_count_, window_size);
+	if (count == 0) {
+		return {};
+	}
+	std::vector<std::chrono::milliseconds> sorted(recent_.begin(), recent_.begin() + static_cast<std::ptrdiff_t>(count));
+	std::sort(sorted.begin(), sorted.end());
+
+	// Nearest-rank method
+	p = std::clamp(p, 0., 100.);
+	auto rank = static_cast<std::size_t>(std::ceil(p / 100. * static_cast<double>(count)));
+	rank = std::clamp<std::size_t>(rank, 1, count);
+	return sorted.at(rank - 1);
+}
+
+
+
+std::chrono::milliseconds CommandLatencyStats::get_max() const
+{
+	return max_;
+}
+
+
+
+std::size_t CommandLatencyStats::get_timeout_count() const
+{
+	return timeout_count_;
+}
+
+
+
+std::size_t CommandLatencyStats::get_consecutive_timeout_count() const
+{
+	return consecutive_timeout_count_;
+}
+
+
+
+
+void CommandLatencyTracker::add_sample(const std::string& device, const std::string& command_class,
+		std::chrono::milliseconds duration, bool timed_out)
+{
+	stats_[{device, command_class}].add_sample(duration, timed_out);
+}
+
+
+
+const CommandLatencyStats* CommandLatencyTracker::get_stats(const std::string& device, const std::string& command_class) const
+{
+	auto iter = stats_.find({device, command_class});
+	if (iter == stats_.end()) {
+		return nullptr;
+	}
+	return &iter->second;
+}
+
+
+
+std::pair<std::chrono::milliseconds, std::chrono::milliseconds> CommandLatencyTracker::get_stop_timeouts(
+		const std::string& device, const std::string& command_class, const Settings& settings) const
+{
+	std::chrono::milliseconds term = settings.max_term_timeout;
+
+	const CommandLatencyStats* stats = get_stats(device, command_class);
+	// If the last command timed out, don't shrink the timeout - the device may be busy.
+	if (stats && stats->get_sample_count() >= settings.min_samples && stats->get_consecutive_timeout_count() == 0) {
+		const auto p95 = static_cast<double>(stats->get_percentile(95.).count());
+		const auto average = static_cast<double>(stats->get_average().count());
+		const double adaptive = std::max(settings.percentile_factor * p95, settings.average_factor * average);
+		term = std::chrono::milliseconds(static_cast<std::chrono::milliseconds::rep>(adaptive));
+		term = std::clamp(term, settings.min_term_timeout, std::max(settings.min_term_timeout, settings.max_term_timeout));
+	}
+
+	return {term, term + settings.kill_delay};
+}
+
+
+
+bool CommandLatencyTracker::get_device_is_slow(const std::string& device, const Settings& settings) const
+{
+	for (const auto& [key, stats] : stats_) {
+		if (key.first != device || stats.get_sample_count() == 0) {
+			continue;
+		}
+		if (stats.get_consecutive_timeout_count() >= 2) {
+			return true;
+		}
+		if (stats.get_sample_count() >= settings.min_samples && stats.get_average() > settings.slow_threshold) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+
+std::string CommandLatencyTracker::format_stats(const Settings& settings) const
+{
+	std::ostringstream ss;
+	ss.imbue(std::locale::classic());
+	ss << std::fixed << std::setprecision(2);
+
+	auto to_sec = [](std::chrono::milliseconds ms) {
+		return static_cast<double>(ms.count()) / 1000.;
+	};
+
+	for (const auto& [key, stats] : stats_) {
+		const auto [term, kill] = get_stop_timeouts(key.first, key.second, settings);
+		ss << key.first << " [" << key.second << "]:"
+				<< " samples " << stats.get_sample_count()
+				<< ", average " << to_sec(stats.get_average()) << "s"
+				<< ", p50 " << to_sec(stats.get_percentile(50.)) << "s"
+				<< ", p95 " << to_sec(stats.get_percentile(95.)) << "s"
+				<< ", max " << to_sec(stats.get_max()) << "s"
+				<< ", timeouts " << stats.get_timeout_count()
+				<< ", timeout " << to_sec(term) << "s / " << to_sec(kill) << "s"
+				<< (get_device_is_slow(key.first, settings) ? ", SLOW" : "")
+				<< "\n";
+	}
+	return ss.str();
+}
+
+
+
+void CommandLatencyTracker::clear()
+{
+	stats_.clear();
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,123 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef COMMAND_LATENCY_STATS_H
+#define COMMAND_LATENCY_STATS_H
+
+#include <string>
+#include <array>
+#include <map>
+#include <utility>  // std::pair
+#include <chrono>
+#include <cstddef>  // std::size_t
+
+
+
+/// Execution time statistics of one command class on one device.
+/// Keeps an exponentially weighted moving average and a window of recent
+/// samples (for percentiles).
+class CommandLatencyStats {
+	public:
+
+		/// Number of recent samples kept for percentile calculation
+		static constexpr std::size_t window_size = 32;
+
+		/// Weight of the newest sample in the moving average
+		static constexpr double ewma_weight = 0.25;
+
+
+		/// Add a sample. \c timed_out means that the command had to be stopped,
+		/// so the real execution time is at least \c duration.
+		void add_sample(std::chrono::milliseconds duration, bool timed_out);
+
+		/// Total number of samples added
+		[[nodiscard]] std::size_t get_sample_count() const;
+
+		/// Exponentially weighted moving average of the execution time
+		[[nodiscard]] std::chrono::milliseconds get_average() const;
+
+		/// Get percentile \c p (0-100) of the recent execution times
+		[[nodiscard]] std::chrono::milliseconds get_percentile(double p) const;
+
+		/// Maximum execution time ever seen
+		[[nodiscard]] std::chrono::milliseconds get_max() const;
+
+		/// Total number of timed out executions
+		[[nodiscard]] std::size_t get_timeout_count() const;
+
+		/// Number of timed out executions in a row (the most recent ones)
+		[[nodiscard]] std::size_t get_consecutive_timeout_count() const;
+
+
+	private:
+
+		std::array<std::chrono::milliseconds, window_size> recent_ = { };  ///< Ring buffer of recent samples
+		std::size_t sample_count_ = 0;  ///< Total number of samples
+		double average_msec_ = 0.;  ///< Moving average
+		std::chrono::milliseconds max_ = { };  ///< Maximum
+		std::size_t timeout_count_ = 0;  ///< Total number of timeouts
+		std::size_t consecutive_timeout_count_ = 0;  ///< Number of timeouts in a row
+
+};
+
+
+
+/// Keeps CommandLatencyStats for each (device, command class) pair and
+/// derives command timeouts from them.
+class CommandLatencyTracker {
+	public:
+
+		/// Timeout derivation settings
+		struct Settings {
+			std::chrono::milliseconds min_term_timeout = std::chrono::seconds(30);  ///< Never terminate before this
+			std::chrono::milliseconds max_term_timeout = std::chrono::minutes(5);  ///< Used until there are enough samples
+			std::chrono::milliseconds kill_delay = std::chrono::seconds(5);  ///< Kill this long after terminating
+			std::chrono::milliseconds slow_threshold = std::chrono::seconds(10);  ///< Average above this marks a device as slow
+			std::size_t min_samples = 3;  ///< Number of samples needed before adapting
+			double percentile_factor = 4.;  ///< Terminate after this many 95th percentiles
+			double average_factor = 6.;  ///< ... or this many averages, whichever is larger
+		};
+
+
+		/// Add a sample for a device and command class
+		void add_sample(const std::string& device, const std::string& command_class,
+				std::chrono::milliseconds duration, bool timed_out);
+
+		/// Get statistics for a device and command class, nullptr if there are none.
+		[[nodiscard]] const CommandLatencyStats* get_stats(const std::string& device, const std::string& command_class) const;
+
+		/// Get terminate and kill timeouts for a device and command class.
+		[[nodiscard]] std::pair<std::chrono::milliseconds, std::chrono::milliseconds> get_stop_timeouts(
+				const std::string& device, const std::string& command_class, const Settings& settings) const;
+
+		/// Check if the device is chronically slow: its average execution time
+		/// is above the threshold, or its recent executions timed out repeatedly.
+		[[nodiscard]] bool get_device_is_slow(const std::string& device, const Settings& settings) const;
+
+		/// Format the statistics as a multi-line human-readable table
+		[[nodiscard]] std::string format_stats(const Settings& settings) const;
+
+		/// Forget everything
+		void clear();
+
+
+	private:
+
+		std::map<std::pair<std::string, std::string>, CommandLatencyStats> stats_;  ///< (device, command class) -> stats
+
+};
+
+
+
+
+#endif
+
+/// @}
@@ -0,0 +1,195 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <giomm/zlibcompressor.h>
+#include <giomm/zlibdecompressor.h>
+#include <array>
+
+#include "hz/debug.h"
+#include "command_log_buffer.h"
+
+
+
+namespace {
+
+
+	/// Run all of \c data through \c converter
+	std::string command_log_convert(const Glib::RefPtr<Gio::Converter>& converter, std::string_view data)
+	{
+		std::string result;
+		std::array<char, 32 * 1024> buf = {};
+		std::size_t pos = 0;
+		while (true) {
+			gsize bytes_read = 0, bytes_written = 0;
+			const Gio::ConverterResult status = converter->convert(data.data() + pos, data.size() - pos,
+					buf.data(), buf.size(), Gio::CONVERTER_INPUT_AT_END, bytes_read, bytes_written);
+			pos += bytes_read;
+			result.append(buf.data(), bytes_written);
+			if (status == Gio::CONVERTER_FINISHED) {
+				break;
+			}
+		}
+		return result;
+	}
+
+
+}
+
+
+
+std::string command_log_compress(std::string_view data)
+{
+	// Level 1 is several times faster than the default one, and smartctl output compresses well anyway.
+	return command_log_convert(Gio::ZlibCompressor::create(Gio::ZLIB_COMPRESSOR_FORMAT_RAW, 1), data);
+}
+
+
+
+std::string command_log_decompress(std::string_view data)
+{
+	return command_log_convert(Gio::ZlibDecompressor::create(Gio::ZLIB_COMPRESSOR_FORMAT_RAW), data);
+}
+
+
+
+CommandLogBuffer::CommandLogBuffer(std::size_t max_bytes)
+		: max_bytes_(max_bytes)
+{ }
+
+
+
+void CommandLogBuffer::set_max_bytes(std::size_t max_bytes)
+{
+	max_bytes_ = max_bytes;
+	enforce_limit();
+}
+
+
+
+std::size_t CommandLogBuffer::add(const CommandExecutorResult& result)
+{
+	Entry entry;
+	entry.number = next_number_++;
+	entry.command = result.command;
+	entry.parameters = result.parameters;
+	entry.error_message = result.error_message;
+	entry.execution_time = result.execution_time;
+
+	try {
+		entry.std_output = command_log_compress(shared_output_str(result.std_output));
+		entry.std_error = command_log_compress(shared_output_str(result.std_error));
+		entry.compressed = true;
+	}
+	catch (const Glib::Error& e) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot compress command output, storing it uncompressed: " << e.what() << "\n");
+		entry.std_output = shared_output_str(result.std_output);
+		entry.std_error = shared_output_str(result.std_error);
+		entry.compressed = false;
+	}
+
+	used_bytes_ += entry.get_memory_usage();
+	entries_.push_back(std::move(entry));
+	enforce_limit();
+
+	return entries_.back().number;
+}
+
+
+
+std::shared_ptr<CommandExecutorResult> CommandLogBuffer::get(std::size_t number, bool with_outputs) const
+{
+	if (entries_.empty() || number < entries_.front().number || number > entries_.back().number) {
+		return nullptr;
+	}
+	// Numbers are sequential, so the entry position is known.
+	const Entry& entry = entries_[number - entries_.front().number];
+
+	std::string std_output, std_error;
+	if (with_outputs && entry.compressed) {
+		try {
+			std_output = command_log_decompress(entry.std_output);
+			std_error = command_log_decompress(entry.std_error);
+		}
+		catch (const Glib::Error& e) {
+			debug_out_error("app", DBG_FUNC_MSG << "Cannot decompress command output: " << e.what() << "\n");
+			return nullptr;
+		}
+	} else if (with_outputs) {
+		std_output = entry.std_output;
+		std_error = entry.std_error;
+	}
+
+	return std::make_shared<CommandExecutorResult>(entry.command, entry.parameters,
+			make_shared_output(std::move(std_output)), make_shared_output(std::move(std_error)),
+			entry.error_message, entry.execution_time);
+}
+
+
+
+std::size_t CommandLogBuffer::get_first_number() const
+{
+	return entries_.empty() ? 0 : entries_.front().number;
+}
+
+
+
+std::size_t CommandLogBuffer::get_last_number() const
+{
+	return entries_.empty() ? 0 : entries_.back().number;
+}
+
+
+
+std::size_t CommandLogBuffer::size() const
+{
+	return entries_.size();
+}
+
+
+
+std::size_t CommandLogBuffer::get_memory_usage() const
+{
+	return used_bytes_;
+}
+
+
+
+void CommandLogBuffer::clear()
+{
+	entries_.clear();
+	used_bytes_ = 0;
+	next_number_ = 1;
+}
+
+
+
+std::size_t CommandLogBuffer::Entry::get_memory_usage() const
+{
+	return sizeof(Entry) + command.size() + parameters.size() + error_message.size()
+			+ std_output.size() + std_error.size();
+}
+
+
+
+void CommandLogBuffer::enforce_limit()
+{
+	while (entries_.size() > 1 && used_bytes_ > max_bytes_) {
+		used_bytes_ -= entries_.front().get_memory_usage();
+		entries_.pop_front();
+	}
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,121 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef COMMAND_LOG_BUFFER_H
+#define COMMAND_LOG_BUFFER_H
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <memory>
+#include <chrono>
+#include <cstddef>  // std::size_t
+
+#include "command_executor.h"
+
+
+
+/**
+Bounded history of executed commands. The outputs of each command are
+zlib-compressed when added and decompressed only when requested, and the oldest
+entries are dropped when the memory limit is reached, so an application
+running for days keeps a fixed amount of command history.
+
+Entries are numbered sequentially starting with 1; numbers of dropped entries
+are not reused (until clear()).
+*/
+class CommandLogBuffer {
+	public:
+
+		/// Constructor. \c max_bytes is the limit for the stored (compressed) data.
+		explicit CommandLogBuffer(std::size_t max_bytes);
+
+
+		/// Set the memory limit, dropping the oldest entries if needed.
+		void set_max_bytes(std::size_t max_bytes);
+
+
+		/// Add a command result. The newest entry is never dropped, even if it's over the limit.
+		/// \return the number of the new entry.
+		std::size_t add(const CommandExecutorResult& result);
+
+
+		/// Get a decompressed entry by its number. Returns nullptr if the entry was dropped.
+		/// If \c with_outputs is false, the outputs are left empty and nothing is decompressed.
+		[[nodiscard]] std::shared_ptr<CommandExecutorResult> get(std::size_t number, bool with_outputs = true) const;
+
+
+		/// Number of the oldest kept entry, 0 if empty.
+		[[nodiscard]] std::size_t get_first_number() const;
+
+
+		/// Number of the newest kept entry, 0 if empty.
+		[[nodiscard]] std::size_t get_last_number() const;
+
+
+		/// Number of kept entries
+		[[nodiscard]] std::size_t size() const;
+
+
+		/// Memory used by the stored entries (approximate)
+		[[nodiscard]] std::size_t get_memory_usage() const;
+
+
+		/// Remove all entries and restart numbering
+		void clear();
+
+
+	private:
+
+		/// A stored command result
+		struct Entry {
+			std::size_t number = 0;  ///< Sequential number
+			std::string command;  ///< Executed command
+			std::string parameters;  ///< Command parameters
+			std::string error_message;  ///< Execution error message
+			std::chrono::milliseconds execution_time = std::chrono::milliseconds(0);  ///< Execution time
+			std::string std_output;  ///< Stdout, compressed if \c compressed
+			std::string std_error;  ///< Stderr, compressed if \c compressed
+			bool compressed = false;  ///< False if compression failed and the outputs are stored as-is
+
+			/// Memory used by this entry (approximate)
+			[[nodiscard]] std::size_t get_memory_usage() const;
+		};
+
+
+		/// Drop the oldest entries until the limit is satisfied (keeping at least one)
+		void enforce_limit();
+
+
+		std::deque<Entry> entries_;  ///< Entries, oldest first
+		std::size_t max_bytes_ = 0;  ///< Memory limit
+		std::size_t used_bytes_ = 0;  ///< Memory used by entries_
+		std::size_t next_number_ = 1;  ///< Number of the next added entry
+
+};
+
+
+
+/// Compress data with zlib. Throws Glib::Error on error.
+std::string command_log_compress(std::string_view data);
+
+
+/// Decompress data compressed with command_log_compress(). Throws Glib::Error on error.
+std::string command_log_decompress(std::string_view data);
+
+
+
+
+
+
+#endif
+
+/// @}
@@ -0,0 +1,201 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <glib.h>
+#include <array>
+#include <cerrno>
+#include <cstddef>  // std::size_t
+#include <cstring>  // std::memcpy
+
+#ifdef __linux__
+	#include <glib-unix.h>  // g_unix_fd_add_full()
+	#include <unistd.h>  // close(), read()
+	#include <sys/inotify.h>
+#endif
+
+#include "hz/debug.h"
+#include "hz/string_algo.h"
+
+#include "directory_watcher.h"
+
+
+
+
+// this is needed because these callbacks are called by glib.
+extern "C" {
+
+	/// Inotify fd handler callback
+	inline gboolean directory_watcher_on_fd_ready(gint fd, GIOCondition cond, gpointer data)
+	{
+		return DirectoryWatcher::on_fd_ready(fd, cond, static_cast<DirectoryWatcher*>(data));
+	}
+
+}
+
+
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+	close();
+}
+
+
+
+bool DirectoryWatcher::open([[maybe_unused]] const hz::fs::path& dir)
+{
+#ifdef __linux__
+	close();
+
+	const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd == -1) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot initialize inotify: " << hz::string_trim_copy(g_strerror(errno)) << "\n");
+		return false;
+	}
+
+	// Only completely written files are interesting, not each write() to them.
+	const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+	if (inotify_add_watch(fd, dir.c_str(), mask) == -1) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot watch directory \"" << dir.u8string() << "\": "
+				<< hz::string_trim_copy(g_strerror(errno)) << "\n");
+		::close(fd);
+		return false;
+	}
+
+	fd_ = fd;
+	dir_ = dir;
+	event_source_id_ = g_unix_fd_add_full(G_PRIORITY_DEFAULT_IDLE, fd_, GIOCondition(G_IO_IN | G_IO_ERR | G_IO_HUP),
+			&directory_watcher_on_fd_ready, this, nullptr);
+	debug_out_info("app", DBG_FUNC_MSG << "Watching directory \"" << dir_.u8string() << "\".\n");
+	return true;
+#else
+	debug_out_info("app", DBG_FUNC_MSG << "Directory watching is not supported on this platform.\n");
+	return false;
+#endif
+}
+
+
+
+void DirectoryWatcher::close()
+{
+	if (event_source_id_ != 0) {
+		g_source_remove(event_source_id_);
+		event_source_id_ = 0;
+	}
+#ifdef __linux__
+	if (fd_ != -1) {
+		::close(fd_);  // this removes the watch too
+		fd_ = -1;
+	}
+#endif
+}
+
+
+
+bool DirectoryWatcher::is_open() const
+{
+	return fd_ != -1;
+}
+
+
+
+const hz::fs::path& DirectoryWatcher::get_directory() const
+{
+	return dir_;
+}
+
+
+
+void DirectoryWatcher::process_pending()
+{
+#ifdef __linux__
+	if (fd_ == -1) {
+		return;
+	}
+
+	// Enough for many events; each one is inotify_event + NAME_MAX + 1 at most.
+	alignas(inotify_event) std::array<char, 16 * 1024> buf = { };
+
+	while (true) {
+		const ssize_t received = read(fd_, buf.data(), buf.size());
+		if (received == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				debug_out_warn("app", DBG_FUNC_MSG << "Error reading inotify events: " << hz::string_trim_copy(g_strerror(errno)) << "\n");
+			}
+			break;
+		}
+		if (received <= 0) {
+			break;
+		}
+
+		std::size_t pos = 0;
+		while (pos + sizeof(inotify_event) <= static_cast<std::size_t>(received)) {
+			inotify_event event = { };
+			std::memcpy(&event, buf.data() + pos, sizeof(inotify_event));
+			const char* name = buf.data() + pos + sizeof(inotify_event);
+			pos += sizeof(inotify_event) + event.len;
+
+			if ((event.mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) != 0) {
+				debug_out_warn("app", DBG_FUNC_MSG << "Watched directory \"" << dir_.u8string() << "\" was removed, not watching anymore.\n");
+				close();
+				return;
+			}
+			if ((event.mask & IN_Q_OVERFLOW) != 0) {
+				debug_out_warn("app", DBG_FUNC_MSG << "Inotify event queue overflow, some file events were lost.\n");
+				continue;
+			}
+			if (event.len == 0 || (event.mask & IN_ISDIR) != 0) {
+				continue;
+			}
+
+			const std::string filename(name);  // NUL-padded
+			// Skip hidden files, which include temporary files of atomic writes (they are then moved in).
+			if (filename.empty() || filename.front() == '.') {
+				continue;
+			}
+
+			const bool removed = (event.mask & (IN_DELETE | IN_MOVED_FROM)) != 0;
+			signal_file_event_.emit(removed ? "removed" : "changed", dir_ / hz::fs::u8path(filename));
+		}
+	}
+#endif
+}
+
+
+
+sigc::signal<void, const std::string&, const hz::fs::path&>& DirectoryWatcher::signal_file_event()
+{
+	return signal_file_event_;
+}
+
+
+
+int DirectoryWatcher::on_fd_ready([[maybe_unused]] int fd, int condition, DirectoryWatcher* self)
+{
+	if ((condition & (G_IO_ERR | G_IO_HUP)) != 0) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Inotify descriptor closed, not watching anymore.\n");
+		self->event_source_id_ = 0;  // we return false, removing the source
+		self->close();
+		return FALSE;
+	}
+	self->process_pending();
+	// process_pending() may have closed it, which removed the source already.
+	return self->is_open() ? TRUE : FALSE;
+}
+
+
+
+
+
+
+/// @}
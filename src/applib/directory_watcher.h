@@ -0,0 +1,93 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef DIRECTORY_WATCHER_H
+#define DIRECTORY_WATCHER_H
+
+#include <string>
+#include <sigc++/sigc++.h>
+
+#include "hz/fs_ns.h"
+
+
+
+/// Watches a directory (non-recursively) with inotify and reports files which were
+/// completely written, moved in, deleted or moved out. Files being written are
+/// not reported until they are closed, so a partially written dump is never seen.
+/// The events are processed in the default GLib main context.
+/// Linux only; open() fails elsewhere.
+class DirectoryWatcher {
+	public:
+
+		/// Constructor
+		DirectoryWatcher() = default;
+
+		/// Deleted
+		DirectoryWatcher(const DirectoryWatcher& other) = delete;
+
+		/// Deleted
+		DirectoryWatcher(DirectoryWatcher&& other) = delete;
+
+		/// Deleted
+		DirectoryWatcher& operator=(const DirectoryWatcher& other) = delete;
+
+		/// Deleted
+		DirectoryWatcher& operator=(DirectoryWatcher&& other) = delete;
+
+		/// Destructor, calls close()
+		~DirectoryWatcher();
+
+
+		/// Start watching a directory.
+		/// \return false on error.
+		bool open(const hz::fs::path& dir);
+
+		/// Stop watching
+		void close();
+
+		/// Check whether the directory is being watched
+		[[nodiscard]] bool is_open() const;
+
+		/// Get the watched directory
+		[[nodiscard]] const hz::fs::path& get_directory() const;
+
+
+		/// Read and dispatch all the pending events. This is called automatically
+		/// from the main loop, but may be called manually too.
+		void process_pending();
+
+
+		/// Emitted for each file event. The parameters are the action ("changed" or "removed")
+		/// and the file path.
+		sigc::signal<void, const std::string&, const hz::fs::path&>& signal_file_event();
+
+
+		/// Called by the inotify watch callback
+		static int on_fd_ready(int fd, int condition, DirectoryWatcher* self);
+
+
+	private:
+
+		int fd_ = -1;  ///< Inotify file descriptor
+		hz::fs::path dir_;  ///< Watched directory
+		unsigned int event_source_id_ = 0;  ///< Inotify fd watch source
+
+		sigc::signal<void, const std::string&, const hz::fs::path&> signal_file_event_;  ///< File event signal
+
+};
+
+
+
+
+
+#endif
+
+/// @}
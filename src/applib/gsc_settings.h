@@ -48,12 +48,22 @@ inline void init_default_settings()
 
 	rconfig::set_default_data("system/smartctl_options", "");  // default options on ALL commands
 	rconfig::set_default_data("system/smartctl_device_options", "");  // dev1:val1;dev2:val2;... format, each bin2ascii-encoded.
+	rconfig::set_default_data("system/smartctl_nice", 0);  // CPU priority (nice value, -20 - 19) of smartctl processes. Unix only.
+	rconfig::set_default_data("system/smartctl_ioprio_class", "");  // I/O priority class of smartctl processes: "", "best-effort" or "idle". Linux only.
+	rconfig::set_default_data("system/smartctl_ioprio_level", 7);  // 0-7, lower is higher priority. Used with "best-effort" class.
+	rconfig::set_default_data("system/smartctl_cgroup_path", "");  // cgroup v2 directory to run smartctl processes in, e.g. "/sys/fs/cgroup/smartmon". Linux only.
+	rconfig::set_default_data("system/smartctl_adaptive_timeouts", false);  // Stop smartctl if it takes much longer than it usually does on this device. Opt-in, some devices are legitimately very slow.
+	rconfig::set_default_data("system/smartctl_timeout_min_sec", 30);  // Adaptive timeouts never go below this.
+	rconfig::set_default_data("system/smartctl_timeout_max_sec", 300);  // Adaptive timeouts never go above this. Also used until enough executions are measured.
+	rconfig::set_default_data("system/smartctl_slow_threshold_sec", 10);  // Devices with average smartctl execution time above this are reported as slow.
 
 	rconfig::set_default_data("system/linux_udev_byid_path", "/dev/disk/by-id");  // linux hard disk device links here
 	rconfig::set_default_data("system/linux_proc_partitions_path", "/proc/partitions");  // file in linux /proc/partitions format
 	rconfig::set_default_data("system/linux_proc_devices_path", "/proc/devices");  // file in linux /proc/devices format
 	rconfig::set_default_data("system/linux_proc_scsi_scsi_path", "/proc/scsi/scsi");  // file in linux /proc/scsi/scsi format
 	rconfig::set_default_data("system/linux_proc_scsi_sg_devices_path", "/proc/scsi/sg/devices");  // file in linux /proc/scsi/sg/devices format
+	rconfig::set_default_data("system/linux_sysfs_class_block_path", "/sys/class/block");  // linux sysfs block device directory, used to skip non-drives before running smartctl. Empty to disable.
+	rconfig::set_default_data("system/linux_use_scan_open", true);  // linux: use "smartctl --scan-open" to find RAID drives, port-scanning only the controllers it misses
 	rconfig::set_default_data("system/linux_3ware_max_scan_port", 23);  // 0-127 (3ware). The last RAID port to scan if no other method is available
 	rconfig::set_default_data("system/linux_areca_enc_max_scan_port", 36);  // 1-128 (areca with enclosures). The last RAID port to scan if no other method is available
 	rconfig::set_default_data("system/linux_areca_enc_max_enclosure", 4);  // 1-8 (areca with enclosures). The last RAID enclosure to scan if no other method is available
@@ -62,13 +72,19 @@ inline void init_default_settings()
 	rconfig::set_default_data("system/unix_sdev_path", "/dev");  // path to /dev. used by other unices
 // 	rconfig::set_default_data("system/device_match_patterns", "");  // semicolon-separated PCRE patterns
 	rconfig::set_default_data("system/device_blacklist_patterns", "");  // semicolon-separated PCRE patterns
+	rconfig::set_default_data("system/prometheus_textfile", "");  // write drive metrics in Prometheus text format to this file (e.g. for node_exporter textfile collector). Empty to disable.
 
 	rconfig::set_default_data("gui/drive_data_open_save_dir", "");
 
 	rconfig::set_default_data("gui/show_smart_capable_only", false);  // show smart-capable drives only
 	rconfig::set_default_data("gui/scan_on_startup", true);  // scan drives on startup
+	rconfig::set_default_data("gui/hotplug_monitor", true);  // add and remove hotplugged drives without rescanning. Linux only.
+	rconfig::set_default_data("gui/use_device_cache", true);  // show the drives from the previous run on startup, while they are being rescanned
+	rconfig::set_default_data("gui/virtual_drive_watch_dir", "");  // load smartctl data files from this directory as virtual drives and reload them when they change. Empty to disable. Linux only.
+	rconfig::set_default_data("gui/record_attribute_history", true);  // append attribute values to per-drive history files on each full read
 
 	rconfig::set_default_data("gui/smartctl_output_filename_format", "{model}_{serial}_{date}.txt");  // when suggesting filename
+	rconfig::set_default_data("gui/executor_log_max_size_kib", 16 * 1024);  // memory limit for the (compressed) outputs in the Execution Log window. The oldest entries are dropped.
 
 	rconfig::set_default_data("gui/icons_show_device_name", false);  // text under icons
 	rconfig::set_default_data("gui/icons_show_serial_number", false);  // text under icons
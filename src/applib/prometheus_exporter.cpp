@@ -0,0 +1,232 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <algorithm>
+#include <set>
+
+#include "hz/fs.h"
+#include "hz/debug.h"
+#include "hz/string_sprintf.h"
+#include "prometheus_exporter.h"
+
+
+
+void PrometheusTextExporter::add_properties(const Labels& labels, const std::vector<AtaStorageProperty>& props)
+{
+	WarningLevel max_warning = WarningLevel::none;
+
+	// Some properties share a generic name (e.g. repeated log entries). Prometheus rejects
+	// samples with identical label sets, so only the first one of those is written.
+	std::set<std::string> written;
+	auto add_unique = [&](const std::string& name, const char* help, const Labels& extra_labels, int64_t value) {
+		std::string key = name;
+		for (const auto& [label, label_value] : extra_labels) {
+			key.append(1, '\0').append(label).append(1, '\0').append(label_value);
+		}
+		if (written.insert(key).second) {
+			add_sample(name, help, labels, extra_labels, value);
+		}
+	};
+
+	for (const auto& p : props) {
+		max_warning = std::max(max_warning, p.warning_level);
+
+		// Labels identifying this property
+		Labels prop_labels = {{"name", p.generic_name.empty() ? p.reported_name : p.generic_name}};
+
+		if (p.is_value_type<AtaStorageAttribute>()) {
+			const auto& attr = p.get_value<AtaStorageAttribute>();
+			prop_labels = {{"id", std::to_string(attr.id)}, {"name", p.reported_name}};
+			if (attr.value.has_value()) {
+				add_unique("gsmartcontrol_attribute_value", "SMART attribute normalized value.",
+						prop_labels, attr.value.value());
+			}
+			if (attr.worst.has_value()) {
+				add_unique("gsmartcontrol_attribute_worst", "SMART attribute worst normalized value.",
+						prop_labels, attr.worst.value());
+			}
+			if (attr.threshold.has_value()) {
+				add_unique("gsmartcontrol_attribute_threshold", "SMART attribute threshold.",
+						prop_labels, attr.threshold.value());
+			}
+			add_unique("gsmartcontrol_attribute_raw", "SMART attribute raw value.",
+					prop_labels, attr.raw_value_int);
+
+		} else if (p.is_value_type<AtaStorageStatistic>()) {
+			const auto& st = p.get_value<AtaStorageStatistic>();
+			if (st.is_header) {
+				continue;
+			}
+			prop_labels = {{"page", hz::string_sprintf("0x%02x", int(st.page))},
+					{"offset", hz::string_sprintf("0x%03x", int(st.offset))},
+					{"name", p.reported_name}};
+			add_unique("gsmartcontrol_devstat_value", "Device statistics value.", prop_labels, st.value_int);
+
+		} else if (p.is_value_type<int64_t>()) {
+			if (p.generic_name == "ata_sct_status/temperature/current") {
+				add_unique("gsmartcontrol_temperature_celsius", "Current drive temperature.",
+						{}, p.get_value<int64_t>());
+			}
+			add_unique("gsmartcontrol_property_value", "Numeric property reported by smartctl (e.g. error and self-test counts).",
+					prop_labels, p.get_value<int64_t>());
+
+		} else if (p.is_value_type<bool>()) {
+			add_unique("gsmartcontrol_property_value", "Numeric property reported by smartctl (e.g. error and self-test counts).",
+					prop_labels, int64_t(p.get_value<bool>()));
+
+		} else if (p.is_value_type<std::chrono::seconds>()) {
+			add_unique("gsmartcontrol_property_seconds", "Time interval property reported by smartctl.",
+					prop_labels, p.get_value<std::chrono::seconds>().count());
+		}
+
+		if (p.warning_level != WarningLevel::none) {
+			add_unique("gsmartcontrol_property_warning_level", "Warning level of a property (1 notice, 2 warning, 3 alert).",
+					prop_labels, int64_t(p.warning_level));
+		}
+	}
+
+	add_sample("gsmartcontrol_drive_warning_level", "Highest warning level of drive properties (0 none, 1 notice, 2 warning, 3 alert).",
+			labels, {}, int64_t(max_warning));
+}
+
+
+
+std::optional<PrometheusTextExporter::FullData> PrometheusTextExporter::get_full_data(const StorageDevice& drive)
+{
+	if (drive.get_parse_status() != StorageDevice::ParseStatus::full) {
+		return std::nullopt;
+	}
+	FullData data;
+	data.serial_number = drive.get_serial_number();
+	data.read_time = drive.get_full_output_read_time();
+	for (const auto& p : drive.get_properties()) {
+		if (p.is_value_type<AtaStorageAttribute>() || p.is_value_type<AtaStorageStatistic>()) {
+			data.properties.push_back(p);
+		}
+	}
+	return data;
+}
+
+
+
+void PrometheusTextExporter::add_drive(const StorageDevice& drive, const FullData* last_full_data)
+{
+	const Labels labels = {
+		{"device", drive.get_device_with_type()},
+		{"type", StorageDevice::get_type_storable_name(drive.get_detected_type())},
+		{"model", drive.get_model_name()},
+		{"serial", drive.get_serial_number()},
+	};
+
+	auto add_read_time = [&](const char* data, std::optional<std::chrono::system_clock::time_point> read_time) {
+		if (read_time.has_value()) {
+			add_sample("gsmartcontrol_last_read_timestamp_seconds", "When the drive data was read, in seconds since the epoch (info: basic data, full: attributes and logs).",
+					labels, {{"data", data}}, std::chrono::duration_cast<std::chrono::seconds>(read_time->time_since_epoch()).count());
+		}
+	};
+
+	add_read_time("info", drive.get_info_output_read_time());
+
+	// A basic re-parse (e.g. by a rescan) drops the attributes, export the last known ones.
+	if (drive.get_parse_status() != StorageDevice::ParseStatus::full
+			&& last_full_data && last_full_data->serial_number == drive.get_serial_number()) {
+		std::vector<AtaStorageProperty> props = drive.get_properties();
+		props.insert(props.end(), last_full_data->properties.begin(), last_full_data->properties.end());
+		add_properties(labels, props);
+		add_read_time("full", last_full_data->read_time);
+		return;
+	}
+
+	add_properties(labels, drive.get_properties());
+	if (drive.get_parse_status() == StorageDevice::ParseStatus::full) {
+		add_read_time("full", drive.get_full_output_read_time());
+	}
+}
+
+
+
+std::string PrometheusTextExporter::render() const
+{
+	std::string result;
+	for (const auto& [name, family] : families_) {
+		result.append("# HELP ").append(name).append(" ").append(family.help).append("\n");
+		result.append("# TYPE ").append(name).append(" gauge\n");
+		result.append(family.samples);
+	}
+	return result;
+}
+
+
+
+std::error_code PrometheusTextExporter::write_file(const hz::fs::path& file) const
+{
+	auto ec = hz::fs_file_put_contents_atomic(file, render());
+	if (ec) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot write metrics file " << file.u8string() << ": " << ec.message() << "\n");
+	}
+	return ec;
+}
+
+
+
+void PrometheusTextExporter::clear()
+{
+	families_.clear();
+}
+
+
+
+std::string PrometheusTextExporter::escape_label_value(const std::string& value)
+{
+	std::string result;
+	result.reserve(value.size());
+	for (char c : value) {
+		switch (c) {
+			case '\\': result += "\\\\"; break;
+			case '"': result += "\\\""; break;
+			case '\n': result += "\\n"; break;
+			default: result += c; break;
+		}
+	}
+	return result;
+}
+
+
+
+void PrometheusTextExporter::add_sample(const std::string& name, const char* help,
+		const Labels& labels, const Labels& extra_labels, int64_t value)
+{
+	Family& family = families_[name];
+	if (family.help.empty()) {
+		family.help = help;
+	}
+
+	std::string& s = family.samples;
+	s.append(name);
+	bool first = true;
+	for (const auto* label_list : {&labels, &extra_labels}) {
+		for (const auto& [label, label_value] : *label_list) {
+			s.append(first ? "{" : ",").append(label).append("=\"").append(escape_label_value(label_value)).append("\"");
+			first = false;
+		}
+	}
+	if (!first) {
+		s.append("}");
+	}
+	s.append(" ").append(std::to_string(value)).append("\n");
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,109 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef PROMETHEUS_EXPORTER_H
+#define PROMETHEUS_EXPORTER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstdint>
+#include <chrono>
+#include <optional>
+#include <system_error>
+
+#include "hz/fs_ns.h"
+#include "ata_storage_property.h"
+#include "storage_device.h"
+
+
+
+/**
+Renders the numeric parsed properties of drives in Prometheus text exposition
+format, suitable for node_exporter's textfile collector.
+
+Metrics of all drives are grouped by family, so each HELP / TYPE header is written
+once. Only the already-parsed properties are used, smartctl is not executed.
+*/
+class PrometheusTextExporter {
+	public:
+
+		/// Metric labels (name, value)
+		using Labels = std::vector<std::pair<std::string, std::string>>;
+
+
+		/// The properties of a fully parsed drive, kept to export its attributes
+		/// after the drive is parsed again with the basic data only (e.g. by a rescan).
+		struct FullData {
+			std::string serial_number;  ///< Serial number of the drive the properties belong to
+			std::vector<AtaStorageProperty> properties;  ///< SMART attributes and device statistics
+			std::optional<std::chrono::system_clock::time_point> read_time;  ///< When the data was read from the drive
+		};
+
+
+		/// Get the data of \c drive to keep in FullData, if it's fully parsed.
+		[[nodiscard]] static std::optional<FullData> get_full_data(const StorageDevice& drive);
+
+
+		/// Add metrics for the numeric properties in \c props, each labelled with \c labels.
+		void add_properties(const Labels& labels, const std::vector<AtaStorageProperty>& props);
+
+
+		/// Add metrics for a drive, labelled with its device, type, model and serial number.
+		/// If the drive is not fully parsed, the attributes and device statistics are taken
+		/// from \c last_full_data (if it's of the same drive). The time the exported data was
+		/// read is written as gsmartcontrol_last_read_timestamp_seconds (if known), so that
+		/// the age of the data can be checked regardless of when the file was written.
+		void add_drive(const StorageDevice& drive, const FullData* last_full_data = nullptr);
+
+
+		/// Render all added metrics
+		[[nodiscard]] std::string render() const;
+
+
+		/// Render all added metrics and atomically replace \c file with them.
+		std::error_code write_file(const hz::fs::path& file) const;
+
+
+		/// Remove all added metrics
+		void clear();
+
+
+		/// Escape a label value (backslash, double quote and newline)
+		[[nodiscard]] static std::string escape_label_value(const std::string& value);
+
+
+	private:
+
+		/// Add a sample to metric family \c name
+		void add_sample(const std::string& name, const char* help,
+				const Labels& labels, const Labels& extra_labels, int64_t value);
+
+
+		/// A metric family with its samples, already rendered
+		struct Family {
+			std::string help;  ///< HELP text
+			std::string samples;  ///< Sample lines
+		};
+
+		std::map<std::string, Family> families_;  ///< Metric families, by name
+
+};
+
+
+
+
+
+
+#endif
+
+/// @}
@@ -133,8 +133,9 @@ std::string SelfTest::start(const std::shared_ptr<CommandExecutor>& smartctl_ex)
 	if (test_param.empty())
 		return _("Invalid test specified");
 
-	std::string output;
-	std::string error_msg = drive_->execute_device_smartctl("--test=" + test_param, smartctl_ex, output);
+	SharedOutput shared_output;
+	std::string error_msg = drive_->execute_device_smartctl("--test=" + test_param, smartctl_ex, shared_output);
+	const std::string& output = shared_output_str(shared_output);
 
 	if (!error_msg.empty())  // checks for empty output too
 		return error_msg;
@@ -194,8 +195,9 @@ std::string SelfTest::force_stop(const std::shared_ptr<CommandExecutor>& smartct
 	}
 
 	// To abort non-captive short, long and conveyance tests, use "--abort".
-	std::string output;
-	std::string error_msg = drive_->execute_device_smartctl("--abort", smartctl_ex, output);
+	SharedOutput shared_output;
+	std::string error_msg = drive_->execute_device_smartctl("--abort", smartctl_ex, shared_output);
+	const std::string& output = shared_output_str(shared_output);
 
 	if (!error_msg.empty())  // checks for empty output too
 		return error_msg;
@@ -235,9 +237,10 @@ std::string SelfTest::update(const std::shared_ptr<CommandExecutor>& smartctl_ex
 	if (!drive_)
 		return "[internal error: drive must not be NULL]";
 
-	std::string output;
-// 	std::string error_message = drive_->execute_device_smartctl("--log=selftest", smartctl_ex, output);
-	std::string error_msg = drive_->execute_device_smartctl("--capabilities", smartctl_ex, output);
+	SharedOutput shared_output;
+// 	std::string error_message = drive_->execute_device_smartctl("--log=selftest", smartctl_ex, shared_output);
+	std::string error_msg = drive_->execute_device_smartctl("--capabilities", smartctl_ex, shared_output);
+	const std::string& output = shared_output_str(shared_output);
 
 	if (!error_msg.empty())  // checks for empty output too
 		return error_msg;
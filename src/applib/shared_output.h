@@ -0,0 +1,68 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef SHARED_OUTPUT_H
+#define SHARED_OUTPUT_H
+
+#include <memory>
+#include <string>
+
+#include "hz/string_algo.h"
+
+
+
+/// Immutable, reference-counted command output. The same buffer is passed from the
+/// executor to the drive and to the executor log, so that a large smartctl output
+/// exists only once in memory.
+using SharedOutput = std::shared_ptr<const std::string>;
+
+
+
+/// Create a shared output, taking ownership of the string data
+inline SharedOutput make_shared_output(std::string s)
+{
+	return std::make_shared<const std::string>(std::move(s));
+}
+
+
+
+/// Get the output string. Null output is treated as an empty string.
+inline const std::string& shared_output_str(const SharedOutput& output)
+{
+	static const std::string empty;
+	return output ? *output : empty;
+}
+
+
+
+/// Convert the output to unix newlines and trim it. If it is in this form
+/// already (the usual case), the same buffer is returned without copying.
+inline SharedOutput shared_output_normalized(const SharedOutput& output)
+{
+	const std::string& s = shared_output_str(output);
+	const std::string trim_chars = " \t\r\n";
+	const bool normalized = s.find('\r') == std::string::npos
+			&& (s.empty() || (trim_chars.find(s.front()) == std::string::npos && trim_chars.find(s.back()) == std::string::npos));
+	if (normalized) {
+		return output ? output : make_shared_output(std::string());
+	}
+	std::string copy = s;
+	hz::string_any_to_unix(copy);
+	hz::string_trim(copy);
+	return make_shared_output(std::move(copy));
+}
+
+
+
+
+#endif
+
+/// @}
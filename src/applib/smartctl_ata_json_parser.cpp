@@ -9,6 +9,10 @@ Copyright:
 /// \weakgroup applib
 /// @{
 
+#include "local_glibmm.h"
+#include <unordered_map>
+#include <unordered_set>
+
 #include "smartctl_ata_json_parser.h"
 #include "json/json.hpp"
 #include "hz/debug.h"
@@ -78,56 +82,173 @@ _custom/smart_enabled
 namespace {
 
 
-/// Get json node data. The path is slash-separated string.
-/// \throws std::runtime_error If not found or one of the paths is not an object
-template<typename T>
-T get_node_data(const nlohmann::json& root, const std::string& path)
-{
-	using namespace std::literals;
-
-	std::vector<std::string> components;
-	hz::string_split(path, '/', components, true);
-
-	const auto* curr = &root;
-	for (std::size_t comp_index = 0; comp_index < components.size(); ++comp_index) {
-		const std::string& comp_name = components[comp_index];
-
-		if (!curr->is_object()) {  // we can't have non-object values in the middle of a path
-			throw std::runtime_error("Cannot get node data \""s + path + "\", component \"" + comp_name + "\" is not an object.");
-		}
-		if (auto iter = curr->find(comp_name); iter != curr->end()) {  // path component exists
-			const auto& jval = iter.value();
-			if (comp_index + 1 == components.size()) {  // it's the "value" component
-				try {
-					return jval.get<T>();  // may throw json::type_error
-				}
-				catch (nlohmann::json::type_error& ex) {
-					throw std::runtime_error(ex.what());
-				}
+/// SAX handler which extracts the scalar values of a fixed set of slash-separated
+/// key paths (e.g. "smartctl/version"), without building a DOM. Values of array
+/// elements are collected under the array's path. Everything else is skipped.
+class SmartctlJsonPathExtractor : public nlohmann::json_sax<nlohmann::json> {
+	public:
+
+		/// Constructor. \c wanted_paths must outlive this object.
+		explicit SmartctlJsonPathExtractor(const std::unordered_set<std::string>& wanted_paths)
+				: wanted_paths_(wanted_paths)
+		{ }
+
+
+		/// Get extracted values of a path, in the order of appearance. Numbers and booleans
+		/// are converted to strings. Values of unexpected type (null, binary) are skipped.
+		[[nodiscard]] const std::vector<std::string>& get_values(const std::string& path) const
+		{
+			static const std::vector<std::string> empty;
+			auto iter = values_.find(path);
+			return (iter != values_.end() ? iter->second : empty);
+		}
+
+
+		/// Get parse error message, if parsing failed
+		[[nodiscard]] const std::string& get_error_msg() const
+		{
+			return error_msg_;
+		}
+
+
+		// json_sax overrides
+
+		bool null() override
+		{
+			return true;
+		}
+
+		bool boolean(bool val) override
+		{
+			return add_value([val]() { return std::string(val ? "true" : "false"); });
+		}
+
+		bool number_integer(number_integer_t val) override
+		{
+			return add_value([val]() { return hz::number_to_string_nolocale(val); });
+		}
+
+		bool number_unsigned(number_unsigned_t val) override
+		{
+			return add_value([val]() { return hz::number_to_string_nolocale(val); });
+		}
+
+		bool number_float(number_float_t val, [[maybe_unused]] const string_t& s) override
+		{
+			return add_value([val]() { return hz::number_to_string_nolocale(val); });
+		}
+
+		bool string(string_t& val) override
+		{
+			return add_value([&val]() { return std::move(val); });
+		}
+
+		bool binary([[maybe_unused]] binary_t& val) override
+		{
+			return true;
+		}
+
+		bool start_object([[maybe_unused]] std::size_t elements) override
+		{
+			frame_path_sizes_.push_back(path_.size());
+			return true;
+		}
+
+		bool key(string_t& val) override
+		{
+			// Replace the previous key of this object
+			const std::size_t base_size = frame_path_sizes_.empty() ? 0 : frame_path_sizes_.back();
+			path_.resize(base_size);
+			if (base_size != 0) {
+				path_ += '/';
 			}
-			// continue to the next component
-			curr = &jval;
+			path_ += val;
+			return true;
+		}
 
-		} else {  // path component doesn't exist
-			throw std::runtime_error("Cannot get node data \""s + path + "\", component \"" + comp_name + "\" does not exist.");
+		bool end_object() override
+		{
+			return end_frame();
 		}
-	}
 
-	throw std::runtime_error("Cannot get node data \""s + path + "\": Internal error.");
+		bool start_array([[maybe_unused]] std::size_t elements) override
+		{
+			// Array elements belong to the array's path
+			frame_path_sizes_.push_back(path_.size());
+			return true;
+		}
+
+		bool end_array() override
+		{
+			return end_frame();
+		}
+
+		bool parse_error([[maybe_unused]] std::size_t position, [[maybe_unused]] const std::string& last_token,
+				const nlohmann::detail::exception& ex) override
+		{
+			error_msg_ = ex.what();
+			return false;
+		}
+
+
+	private:
+
+		/// Store the value if the current path is wanted. The value is only formatted if it's needed.
+		template<typename Func>
+		bool add_value(Func&& value_func)
+		{
+			if (wanted_paths_.count(path_) != 0) {
+				values_[path_].push_back(value_func());
+			}
+			return true;
+		}
+
+
+		/// Leave an object or array, restoring the path of its parent
+		bool end_frame()
+		{
+			if (!frame_path_sizes_.empty()) {
+				path_.resize(frame_path_sizes_.back());
+				frame_path_sizes_.pop_back();
+			}
+			return true;
+		}
+
+
+		const std::unordered_set<std::string>& wanted_paths_;  ///< Paths to extract
+		std::string path_;  ///< Current key path
+		std::vector<std::size_t> frame_path_sizes_;  ///< Size of path_ when entering each object / array
+		std::unordered_map<std::string, std::vector<std::string>> values_;  ///< Extracted values by path
+		std::string error_msg_;  ///< Parse error message
+
+};
+
+
+
+/// Info section keys which are stored as string properties, with their displayable names
+const std::vector<std::pair<std::string, std::string>>& get_json_info_string_keys()
+{
+	static const std::vector<std::pair<std::string, std::string>> info_keys = {
+			{"model_family", _("Model Family")},
+	};
+	return info_keys;
 }
 
 
-/// Get json node data. The path is slash-separated string.
-/// If an error is found, the default value is returned.
-template<typename T>
-T get_node_data(const nlohmann::json& root, const std::string& path, const T& default_value)
+
+/// All the paths the parser is interested in. Compiled once.
+const std::unordered_set<std::string>& get_json_wanted_paths()
 {
-	try {
-		return get_node_data<T>(root, path);
-	}
-	catch (std::runtime_error& ex) {
-		return default_value;
-	}
+	static const std::unordered_set<std::string> paths = []() {
+		std::unordered_set<std::string> wanted = {
+				"smartctl/version",
+		};
+		for (const auto& info_key : get_json_info_string_keys()) {
+			wanted.insert(info_key.first);
+		}
+		return wanted;
+	}();
+	return paths;
 }
 
 
@@ -137,66 +258,61 @@ T get_node_data(const nlohmann::json& root, const std::string& path, const T& de
 
 bool SmartctlAtaJsonParser::parse_full(const std::string& json_data_full)
 {
-	this->set_data_full(json_data_full);
-
 	if (hz::string_trim_copy(json_data_full).empty()) {
 		set_error_msg("Smartctl data is empty.");
 		debug_out_warn("app", DBG_FUNC_MSG << "Empty string passed as an argument. Returning.\n");
 		return false;
 	}
 
-	try {
-		const nlohmann::json root_node = nlohmann::json::parse(json_data_full);
-
-		{
-			AtaStorageProperty p;
-			p.set_name("Smartctl version", "smartctl/version/_merged", "Smartctl Version");
-			auto json_ver = get_node_data<std::vector<int>>(root_node, "smartctl/version", {});
-			if (json_ver.size() >= 2) {
-				p.reported_value = hz::number_to_string_nolocale(json_ver.at(0)) + "." + hz::number_to_string_nolocale(json_ver.at(1));
-			}
-			p.value = p.reported_value;  // string-type value
-			p.section = AtaStorageProperty::Section::info;  // add to info section
-			add_property(p);
-		}
-		// {
-		// 	AtaStorageProperty p;
-		// 	p.set_name("Smartctl version", "smartctl/version/_merged_full", "Smartctl Version");
-		// 	p.reported_value = version_full;
-		// 	p.value = p.reported_value;  // string-type value
-		// 	p.section = AtaStorageProperty::Section::info;  // add to info section
-		// 	add_property(p);
-		// }
-
-		// if (!SmartctlVersionParser::check_parsed_version(SmartctlParserType::Text, version)) {
-		// 	set_error_msg("Incompatible smartctl version.");
-		// 	debug_out_warn("app", DBG_FUNC_MSG << "Incompatible smartctl version. Returning.\n");
-		// 	return false;
-		// }
-
-		const std::unordered_map<std::string, std::string> info_keys = {
-				{"model_family", _("Model Family")},
-		};
-
-		for (const auto& [key, jval] : root_node.items()) {
-			if (auto found = info_keys.find(key); found != info_keys.end()) {
-				AtaStorageProperty p;
-				p.section = AtaStorageProperty::Section::info;
-				p.set_name(key, key, found->second);
-				p.reported_value = jval.get<std::string>();
-				p.value = p.reported_value;  // string-type value
-
-				// parse_section_info_property(p);  // set type and the typed value. may change generic_name too.
+	// Extract only what we need. Building a DOM of the whole output (which, with --json=o,
+	// contains the whole text output as well) is wasteful.
+	SmartctlJsonPathExtractor extractor(get_json_wanted_paths());
+	if (!nlohmann::json::sax_parse(json_data_full, &extractor)) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Error parsing smartctl output as JSON: " << extractor.get_error_msg() << ". Returning.\n");
+		set_error_msg("Invalid JSON data.");
+		return false;
+	}
 
-				add_property(p);
-			}
+	{
+		AtaStorageProperty p;
+		p.set_name("Smartctl version", "smartctl/version/_merged", "Smartctl Version");
+		const auto& json_ver = extractor.get_values("smartctl/version");
+		if (json_ver.size() >= 2) {
+			p.reported_value = json_ver.at(0) + "." + json_ver.at(1);
 		}
+		p.value = p.reported_value;  // string-type value
+		p.section = AtaStorageProperty::Section::info;  // add to info section
+		add_property(p);
+	}
+	// {
+	// 	AtaStorageProperty p;
+	// 	p.set_name("Smartctl version", "smartctl/version/_merged_full", "Smartctl Version");
+	// 	p.reported_value = version_full;
+	// 	p.value = p.reported_value;  // string-type value
+	// 	p.section = AtaStorageProperty::Section::info;  // add to info section
+	// 	add_property(p);
+	// }
+
+	// if (!SmartctlVersionParser::check_parsed_version(SmartctlParserType::Text, version)) {
+	// 	set_error_msg("Incompatible smartctl version.");
+	// 	debug_out_warn("app", DBG_FUNC_MSG << "Incompatible smartctl version. Returning.\n");
+	// 	return false;
+	// }
+
+	for (const auto& [key, displayable_name] : get_json_info_string_keys()) {
+		const auto& values = extractor.get_values(key);
+		if (values.empty()) {
+			continue;
+		}
+		AtaStorageProperty p;
+		p.section = AtaStorageProperty::Section::info;
+		p.set_name(key, key, displayable_name);
+		p.reported_value = values.front();
+		p.value = p.reported_value;  // string-type value
 
+		// parse_section_info_property(p);  // set type and the typed value. may change generic_name too.
 
-	}
-	catch (const nlohmann::json::parse_error& e) {
-		debug_out_warn("app", DBG_FUNC_MSG << "Error parsing smartctl output as JSON. Returning.\n");
-		return false;
+		add_property(p);
 	}
 
 	return true;
@@ -206,4 +322,5 @@ bool SmartctlAtaJsonParser::parse_full(const std::string& json_data_full)
 
 
 
+
 /// @}
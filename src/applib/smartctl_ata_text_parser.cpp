@@ -70,13 +70,11 @@ namespace {
 // Parse full "smartctl -x" output
 bool SmartctlAtaTextParser::parse_full(const std::string& full)
 {
-	this->set_data_full(full);
-
-
 	// -------------------- Fix the output so it doesn't interfere with proper parsing
 
 	// perform any2unix
-	std::string s = hz::string_trim_copy(hz::string_any_to_unix_copy(full));
+	std::string s = hz::string_any_to_unix_copy(full);
+	hz::string_trim(s);
 
 	if (s.empty()) {
 		set_error_msg("Smartctl data is empty.");
@@ -1978,11 +1976,26 @@ Index    Estimated Time   Temperature Celsius
 */
 	bool data_found = false;  // true if something was found.
 
-	// the whole subsection
+	// The history table, decoded into a compact series. This is much smaller than its text.
+	AtaStorageTemperatureHistory history;
+	const bool history_found = SmartctlTextParserHelper::parse_temperature_history(sub, history);
+	if (history_found) {
+		AtaStorageProperty p(pt);
+		p.set_name("SCT temperature history", "ata_sct_temperature_history/table");
+		p.value = std::move(history);
+
+		add_property(p);
+		data_found = true;
+	}
+
+	// the whole subsection (without the history table if it was decoded)
 	{
 		AtaStorageProperty p(pt);
 		p.set_name("SCT temperature log", "ata_sct_status/_and/ata_sct_temperature_history/_merged");
 		p.reported_value = sub;
+		if (std::string table_header; history_found && app_pcre_match("/^(Index[ \\t]+Estimated Time.*)$/mi", sub, &table_header)) {
+			p.reported_value = hz::string_trim_copy(sub.substr(0, sub.find(table_header)));
+		}
 		p.value = p.reported_value;  // string-type value
 
 		add_property(p);
@@ -10,19 +10,25 @@ Copyright:
 /// @{
 
 #include "local_glibmm.h"  // Glib::shell_quote()
+#include <algorithm>  // std::min, std::max
+#include <iterator>  // std::make_move_iterator
+#include <vector>
 
 #include "smartctl_executor.h"
 #include "hz/win32_tools.h"
 #include "rconfig/rconfig.h"
 #include "app_pcrecpp.h"
+#include "app_pcrecpp_pattern_set.h"
 #include "hz/fs.h"
+#include "hz/process_priority.h"
 #include "build_config.h"
 
 
 
 hz::fs::path get_smartctl_binary()
 {
-	auto smartctl_binary = hz::fs::u8path(rconfig::get_data<std::string>("system/smartctl_binary"));
+	static const rconfig::Key<std::string> smartctl_binary_key("system/smartctl_binary");
+	auto smartctl_binary = hz::fs::u8path(smartctl_binary_key.get());
 
 	if constexpr(BuildEnv::is_kernel_family_windows()) {
 		// Look in smartmontools installation directory.
@@ -80,12 +86,105 @@ hz::fs::path get_smartctl_binary()
 
 
 
+AsyncCommandExecutor::child_setup_func_t get_smartctl_child_setup()
+{
+	if constexpr(BuildEnv::is_kernel_family_windows()) {
+		return nullptr;
+	}
+
+	static const rconfig::Key<int> nice_key("system/smartctl_nice");
+	static const rconfig::Key<std::string> io_class_key("system/smartctl_ioprio_class");
+	static const rconfig::Key<int> io_level_key("system/smartctl_ioprio_level");
+	static const rconfig::Key<std::string> cgroup_path_key("system/smartctl_cgroup_path");
+
+	const int nice_value = std::max(-20, std::min(19, nice_key.get()));
+
+	const auto io_class_str = io_class_key.get();
+	hz::IoPriorityClass io_class = hz::IoPriorityClass::None;
+	if (io_class_str == "best-effort") {
+		io_class = hz::IoPriorityClass::BestEffort;
+	} else if (io_class_str == "idle") {
+		io_class = hz::IoPriorityClass::Idle;
+	} else if (!io_class_str.empty()) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Invalid I/O priority class \"" << io_class_str
+				<< "\" in \"system/smartctl_ioprio_class\", ignoring.\n");
+	}
+	const int io_level = io_level_key.get();
+
+	std::string cgroup_procs_file;
+	if (auto cgroup_dir = cgroup_path_key.get(); !cgroup_dir.empty()) {
+		cgroup_procs_file = (hz::fs::u8path(cgroup_dir) / "cgroup.procs").string();
+	}
+
+	if (nice_value == 0 && io_class == hz::IoPriorityClass::None && cgroup_procs_file.empty()) {
+		return nullptr;
+	}
+
+	// This is called in the child between fork() and exec(), so only the
+	// async-signal-safe functions are allowed. Errors are ignored - there is
+	// no one to report them to, and smartctl should run anyway.
+	return [nice_value, io_class, io_level, cgroup_procs_file]()
+	{
+		if (!cgroup_procs_file.empty()) {
+			hz::process_join_cgroup_self(cgroup_procs_file.c_str());
+		}
+		if (nice_value != 0) {
+			hz::process_set_cpu_priority_self(nice_value);
+		}
+		hz::process_set_io_priority_self(io_class, io_level);
+	};
+}
+
+
+
+CommandLatencyTracker& get_smartctl_latency_tracker()
+{
+	static CommandLatencyTracker tracker;
+	return tracker;
+}
+
+
+
+CommandLatencyTracker::Settings get_smartctl_latency_settings()
+{
+	static const rconfig::Key<int> timeout_min_key("system/smartctl_timeout_min_sec");
+	static const rconfig::Key<int> timeout_max_key("system/smartctl_timeout_max_sec");
+	static const rconfig::Key<int> slow_threshold_key("system/smartctl_slow_threshold_sec");
+
+	CommandLatencyTracker::Settings settings;
+	settings.min_term_timeout = std::chrono::seconds(std::max(1, timeout_min_key.get()));
+	settings.max_term_timeout = std::chrono::seconds(std::max(1, timeout_max_key.get()));
+	settings.slow_threshold = std::chrono::seconds(std::max(1, slow_threshold_key.get()));
+	return settings;
+}
+
+
+
+std::string get_smartctl_command_class(const std::string& command_options)
+{
+	// Compiled once, this is called for every smartctl execution.
+	static const AppPcrePatternSet classes({
+		// These read the logs and may take a lot of time on some devices
+		"/(?:^|\\s)(?:-a|-x|--all|--xall|-A|--attributes|--get=all|-l)(?:\\s|=|$)/",
+		"/(?:^|\\s)(?:-i|--info)(?:\\s|$)/",
+	});
+	static const std::vector<std::string> class_names = {"full", "info"};
+
+	if (const auto index = classes.find_match(command_options); index.has_value()) {
+		return class_names.at(index.value());
+	}
+	return "other";
+}
+
+
+
 std::string execute_smartctl(const std::string& device, const std::string& device_opts,
 		const std::string& command_options,
-		std::shared_ptr<CommandExecutor> smartctl_ex, std::string& smartctl_output)
+		std::shared_ptr<CommandExecutor> smartctl_ex, SharedOutput& smartctl_output)
 {
 	// win32 doesn't have slashes in devices names. For others, check that slash is present.
-	if constexpr(!BuildEnv::is_kernel_family_windows()) {
+	// An empty device is for the commands which don't take one (e.g. --scan-open).
+	if (!device.empty() && !BuildEnv::is_kernel_family_windows()) {
 		const std::string::size_type pos = device.rfind('/');  // find basename
 		if (pos == std::string::npos) {
 			debug_out_error("app", DBG_FUNC_MSG << "Invalid device name \"" << device << "\".\n");
@@ -104,29 +203,69 @@ std::string execute_smartctl(const std::string& device, const std::string& devic
 		return _("Smartctl binary is not specified in configuration.");
 	}
 
-	auto smartctl_def_options = rconfig::get_data<std::string>("system/smartctl_options");
-
-	if (!smartctl_def_options.empty())
-		smartctl_def_options += " ";
+	// Build the argument vector directly. Only the option strings which may
+	// contain user-entered text need to go through the shell parser.
+	std::vector<std::string> argv = {smartctl_binary.u8string()};
+	static const rconfig::Key<std::string> smartctl_options_key("system/smartctl_options");
+	for (const std::string& options : {smartctl_options_key.get(), device_opts, command_options}) {
+		if (hz::string_trim_copy(options).empty())
+			continue;
+		try {
+			std::vector<std::string> parsed = Glib::shell_parse_argv(options);
+			argv.insert(argv.end(), std::make_move_iterator(parsed.begin()), std::make_move_iterator(parsed.end()));
+		}
+		catch(Glib::ShellError& e) {
+			debug_out_error("app", DBG_FUNC_MSG << "Cannot parse smartctl options \"" << options << "\": " << e.what() << "\n");
+			return Glib::ustring::compose(_("Invalid smartctl options specified: %1"), e.what());
+		}
+	}
+	if (!device.empty()) {
+		argv.push_back(device);
+	}
 
+	smartctl_ex->set_child_setup(get_smartctl_child_setup());
+	smartctl_ex->set_command_argv(std::move(argv));
+
+	CommandLatencyTracker& latency_tracker = get_smartctl_latency_tracker();
+	const CommandLatencyTracker::Settings latency_settings = get_smartctl_latency_settings();
+	const std::string command_class = get_smartctl_command_class(command_options);
+	static const rconfig::Key<bool> adaptive_timeouts_key("system/smartctl_adaptive_timeouts");
+	const bool adaptive_timeouts = adaptive_timeouts_key.get();
+	const bool was_slow = latency_tracker.get_device_is_slow(device, latency_settings);
+
+	std::chrono::milliseconds term_timeout(0);
+	if (adaptive_timeouts) {
+		const auto [term, kill] = latency_tracker.get_stop_timeouts(device, command_class, latency_settings);
+		term_timeout = term;
+		smartctl_ex->set_execution_timeouts(term, kill);
+	} else {
+		smartctl_ex->set_execution_timeouts(std::chrono::milliseconds(0), std::chrono::milliseconds(0));
+	}
 
-	std::string device_specific_options = device_opts;
-	if (!device_specific_options.empty())
-		device_specific_options += " ";
+	const bool executed = smartctl_ex->execute();
 
+	if (executed) {
+		const auto execution_time = smartctl_ex->get_execution_time();
+		const bool timed_out = term_timeout.count() != 0 && execution_time >= term_timeout;
+		latency_tracker.add_sample(device, command_class, execution_time, timed_out);
 
-	smartctl_ex->set_command(Glib::shell_quote(smartctl_binary.u8string()),
-			smartctl_def_options + device_specific_options + command_options
-			+ " " + Glib::shell_quote(device));
+		if (timed_out) {
+			debug_out_warn("app", DBG_FUNC_MSG << "Smartctl on device \"" << device << "\" timed out after "
+					<< execution_time.count() << " ms.\n");
+		}
+		if (!was_slow && latency_tracker.get_device_is_slow(device, latency_settings)) {
+			debug_out_warn("app", DBG_FUNC_MSG << "Device \"" << device << "\" is slow to respond to smartctl commands.\n");
+		}
+	}
 
-	if (!smartctl_ex->execute() || !smartctl_ex->get_error_msg().empty()) {
+	if (!executed || !smartctl_ex->get_error_msg().empty()) {
 		debug_out_warn("app", DBG_FUNC_MSG << "Smartctl binary did not execute cleanly.\n");
 
-		smartctl_output = hz::string_trim_copy(hz::string_any_to_unix_copy(smartctl_ex->get_stdout_str()));
+		smartctl_output = shared_output_normalized(smartctl_ex->get_stdout_shared());
 
 		// check if it's a device permission error.
 		// Smartctl open device: /dev/sdb failed: Permission denied
-		if (app_pcre_match("/Smartctl open device.+Permission denied/mi", smartctl_output)) {
+		if (app_pcre_match("/Smartctl open device.+Permission denied/mi", *smartctl_output)) {
 			return _("Permission denied while opening device.");
 		}
 
@@ -134,9 +273,9 @@ std::string execute_smartctl(const std::string& device, const std::string& devic
 		return smartctl_ex->get_error_msg();
 	}
 
-	// any_to_unix is needed for windows
-	smartctl_output = hz::string_trim_copy(hz::string_any_to_unix_copy(smartctl_ex->get_stdout_str()));
-	if (smartctl_output.empty()) {
+	// any_to_unix is needed for windows. This shares the executor's buffer if no conversion is needed.
+	smartctl_output = shared_output_normalized(smartctl_ex->get_stdout_shared());
+	if (smartctl_output->empty()) {
 		debug_out_error("app", DBG_FUNC_MSG << "Smartctl returned an empty output.\n");
 		return _("Smartctl returned an empty output.");
 	}
@@ -17,6 +17,7 @@ Copyright:
 
 #include "async_command_executor.h"
 #include "command_executor.h"
+#include "command_latency_stats.h"
 #include "hz/fs_ns.h"
 
 
@@ -164,11 +165,34 @@ using SmartctlExecutor = SmartctlExecutorGeneric<CommandExecutor>;
 hz::fs::path get_smartctl_binary();
 
 
-/// Execute smartctl on device \c device.
+/// Get the child setup function which applies the configured CPU / IO priority
+/// and cgroup ("system/smartctl_*" config keys) to a smartctl child process.
+/// Returns an empty function if nothing needs to be changed.
+AsyncCommandExecutor::child_setup_func_t get_smartctl_child_setup();
+
+
+/// Get the execution time statistics of smartctl commands, per device and command class.
+CommandLatencyTracker& get_smartctl_latency_tracker();
+
+
+/// Get the adaptive timeout settings from config ("system/smartctl_timeout_*" keys).
+CommandLatencyTracker::Settings get_smartctl_latency_settings();
+
+
+/// Get the command class ("full", "info" or "other") of smartctl options, for latency tracking.
+std::string get_smartctl_command_class(const std::string& command_options);
+
+
+/// Execute smartctl on device \c device. \c device may be empty for the commands which
+/// don't take one (e.g. --scan-open), their latency is tracked under an empty device name.
+/// If "system/smartctl_adaptive_timeouts" is enabled, the command is stopped if it
+/// takes much longer than it usually does on this device.
+/// \c smartctl_output is set to the trimmed output, sharing the executor's buffer when possible.
+/// It is left unchanged if smartctl could not be run.
 /// \return error message on error, empty string on success.
 std::string execute_smartctl(const std::string& device, const std::string& device_opts,
 		const std::string& command_options,
-		std::shared_ptr<CommandExecutor> smartctl_ex, std::string& smartctl_output);
+		std::shared_ptr<CommandExecutor> smartctl_ex, SharedOutput& smartctl_output);
 
 
 
@@ -53,13 +53,6 @@ leaf::result<SmartctlParserType> SmartctlParser::detect_output_type(const std::s
 
 
 
-std::string SmartctlParser::get_data_full() const
-{
-	return data_full_;
-}
-
-
-
 std::string SmartctlParser::get_error_msg() const
 {
 	return Glib::ustring::compose(_("Cannot parse smartctl output: %1"), error_msg_);
@@ -83,13 +76,6 @@ void SmartctlParser::add_property(AtaStorageProperty p)
 
 
 
-void SmartctlParser::set_data_full(const std::string& s)
-{
-	data_full_ = s;
-}
-
-
-
 void SmartctlParser::set_error_msg(const std::string& s)
 {
 	error_msg_ = s;
@@ -76,9 +76,6 @@ class SmartctlParser {
 		[[nodiscard]] static leaf::result<SmartctlParserType> detect_output_type(const std::string& output);
 
 
-		/// Get "full" data, as passed to parse_full().
-		[[nodiscard]] std::string get_data_full() const;
-
 		/// Get parse error message. Call this only if parsing doesn't succeed,
 		/// to get a friendly error message.
 		[[nodiscard]] std::string get_error_msg() const;
@@ -92,9 +89,6 @@ class SmartctlParser {
 		/// Add a property into property list, look up and set its description
 		void add_property(AtaStorageProperty p);
 
-		/// Set "full" data ("smartctl -x" output), json or text.
-		void set_data_full(const std::string& s);
-
 		/// Set error message
 		void set_error_msg(const std::string& s);
 
@@ -102,7 +96,6 @@ class SmartctlParser {
 	private:
 
 		std::vector<AtaStorageProperty> properties_;  ///< Parsed data properties
-		std::string data_full_;  ///< full data, filled by parse_full()
 		std::string error_msg_;  ///< This will be filled with some displayable message on error
 
 };
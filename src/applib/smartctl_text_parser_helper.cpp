@@ -9,6 +9,11 @@ Copyright:
 /// \weakgroup applib
 /// @{
 
+#include <sstream>
+#include <iomanip>  // std::get_time
+#include <ctime>
+#include <algorithm>  // std::clamp
+
 #include "smartctl_text_parser_helper.h"
 #include "build_config.h"
 #include "hz/locale_tools.h"
@@ -71,6 +76,86 @@ std::string SmartctlTextParserHelper::parse_byte_size(const std::string& str, in
 
 
 
+bool SmartctlTextParserHelper::parse_temperature_history(const std::string& str, AtaStorageTemperatureHistory& history)
+{
+/*
+Temperature Logging Interval:        1 minute
+...
+Index    Estimated Time   Temperature Celsius
+ 362    2017-08-29 08:43    38  *******************
+ ...    ..(119 skipped).    ..  *******************
+   4    2017-08-29 10:43    38  *******************
+  98    2017-08-29 12:17     ?  -
+*/
+	history = AtaStorageTemperatureHistory();
+
+	std::vector<std::string> lines;
+	hz::string_split(str, '\n', lines, true);
+
+	bool table_found = false;
+	for (const auto& orig_line : lines) {
+		const std::string line = hz::string_trim_copy(orig_line);
+
+		if (!table_found) {
+			const std::string interval_prefix = "Temperature Logging Interval:";
+			if (hz::string_begins_with(line, interval_prefix)) {
+				history.logging_interval = std::chrono::minutes(hz::string_to_number_nolocale<int64_t>(
+						hz::string_trim_copy(line.substr(interval_prefix.size())), false));
+			}
+			table_found = hz::string_begins_with(line, "Index") && line.find("Temperature") != std::string::npos;
+			continue;
+		}
+
+		// Run of samples equal to the previous one
+		if (hz::string_begins_with(line, "...")) {
+			const std::string::size_type open_pos = line.find('(');
+			const std::string::size_type skipped_pos = line.find("skipped");
+			if (open_pos == std::string::npos || skipped_pos == std::string::npos || skipped_pos < open_pos) {
+				continue;
+			}
+			const auto num_skipped = hz::string_to_number_nolocale<std::size_t>(
+					hz::string_trim_copy(line.substr(open_pos + 1, skipped_pos - open_pos - 1)), false);
+			const int8_t previous = history.samples.empty()
+					? AtaStorageTemperatureHistory::unknown_temperature : history.samples.back();
+			history.samples.insert(history.samples.end(), num_skipped, previous);
+			continue;
+		}
+
+		std::istringstream iss(line);
+		std::string index, date, time, temperature;
+		int64_t index_value = 0;
+		if (!(iss >> index >> date >> time >> temperature) || !hz::string_is_numeric_nolocale(index, index_value)) {
+			continue;
+		}
+
+		if (history.samples.empty()) {
+			std::tm tm = {};
+			std::istringstream time_iss(date + " " + time);
+			time_iss >> std::get_time(&tm, "%Y-%m-%d %H:%M");
+			if (!time_iss.fail()) {
+				tm.tm_isdst = -1;  // estimated times are in local time
+				const std::time_t start_time = std::mktime(&tm);
+				history.start_time = (start_time == std::time_t(-1) ? 0 : int64_t(start_time));
+			}
+		}
+
+		int64_t value = 0;
+		if (temperature != "?" && hz::string_is_numeric_nolocale(temperature, value)) {
+			history.samples.push_back(static_cast<int8_t>(std::clamp<int64_t>(value,
+					AtaStorageTemperatureHistory::unknown_temperature + 1, std::numeric_limits<int8_t>::max())));
+		} else {
+			history.samples.push_back(AtaStorageTemperatureHistory::unknown_temperature);
+		}
+	}
+
+	return table_found;
+}
+
+
+
+
+
+
 /// @}
 
 
@@ -15,6 +15,8 @@ Copyright:
 #include <string>
 #include <cstdint>
 
+#include "ata_storage_property.h"
+
 
 
 /// Helpers for smartctl text output parser
@@ -28,6 +30,13 @@ class SmartctlTextParserHelper {
 		/// \return Size as a displayable string
 		static std::string parse_byte_size(const std::string& str, int64_t& bytes, bool extended);
 
+		/// Decode the history table of "SCT Temperature History" (--log=scttemp) into \c history.
+		/// The "..(N skipped).." rows are expanded into N copies of the previous sample.
+		/// \param str Subsection text
+		/// \param history Decoded history
+		/// \return false if there is no history table in \c str
+		static bool parse_temperature_history(const std::string& str, AtaStorageTemperatureHistory& history);
+
 };
 
 
@@ -16,6 +16,9 @@ Copyright:
 #include "build_config.h"
 
 #include "hz/debug.h"
+#include "hz/fs.h"
+#include "hz/string_algo.h"
+#include "rconfig/rconfig.h"
 
 #include "app_pcrecpp.h"
 #include "smartctl_executor.h"
@@ -28,6 +31,42 @@ Copyright:
 
 
 
+namespace {
+
+
+	/// Read the serial number of a drive from sysfs without running smartctl (Linux only).
+	/// \return an empty string if not available.
+	std::string read_sysfs_serial_number([[maybe_unused]] const StorageDevicePtr& drive)
+	{
+		if constexpr(BuildEnv::is_kernel_linux()) {
+			const auto sysfs_dir = rconfig::get_data<std::string>("system/linux_sysfs_class_block_path");
+			if (sysfs_dir.empty()) {
+				return {};
+			}
+			const auto device_dir = hz::fs::u8path(sysfs_dir) / hz::fs::u8path(drive->get_device_base()) / "device";
+			std::string contents;
+
+			// NVMe, some SCSI drivers
+			if (!hz::fs_file_get_contents_unseekable(device_dir / "serial", contents)) {
+				hz::string_trim(contents);
+				return contents;
+			}
+
+			// SCSI / SAT: Unit Serial Number VPD page, 4-byte header.
+			if (!hz::fs_file_get_contents_unseekable(device_dir / "vpd_pg80", contents) && contents.size() > 4) {
+				std::string serial = contents.substr(4);
+				hz::string_trim(serial, std::string(" \t\r\n\0", 5));
+				return serial;
+			}
+		}
+		return {};
+	}
+
+
+}
+
+
+
 std::string StorageDetector::detect(std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory)
 {
 	debug_out_info("app", DBG_FUNC_MSG << "Starting drive detection.\n");
@@ -60,13 +99,7 @@ std::string StorageDetector::detect(std::vector<StorageDevicePtr>& drives, const
 // 				continue;
 
 			// matched, check the blacklist
-			bool blacked = false;
-			for (const auto& blacklist_pattern : blacklist_patterns_) {
-				if (app_pcre_match(blacklist_pattern, drive->get_device())) {  // matched the blacklist too
-					blacked = true;
-					break;
-				}
-			}
+			const bool blacked = get_device_blacklisted(drive->get_device());
 
 			debug_out_info("app", "Found device: " << drive->get_device_with_type() << ".\n");
 
@@ -91,6 +124,18 @@ std::string StorageDetector::detect(std::vector<StorageDevicePtr>& drives, const
 
 
 
+bool StorageDetector::get_device_blacklisted(const std::string& device) const
+{
+	const auto index = blacklist_.find_match(device);
+	if (index.has_value()) {
+		debug_out_dump("app", "Device " << device << " matches blacklist pattern \""
+				<< blacklist_.get_patterns().at(index.value()) << "\".\n");
+	}
+	return index.has_value();
+}
+
+
+
 std::string StorageDetector::fetch_basic_data(std::vector<StorageDevicePtr>& drives,
 		const CommandExecutorFactoryPtr& ex_factory, bool return_first_error)
 {
@@ -155,5 +200,73 @@ std::string StorageDetector::detect_and_fetch_basic_data(std::vector<StorageDevi
 
 
 
+std::string StorageDetector::detect_and_fetch_basic_data_incremental(std::vector<StorageDevicePtr>& put_drives_here,
+		const std::vector<StorageDevicePtr>& known_drives, const CommandExecutorFactoryPtr& ex_factory,
+		bool refetch_known)
+{
+	std::vector<StorageDevicePtr> detected;
+	std::string error_msg = detect(detected, ex_factory);
+	if (!error_msg.empty())
+		return error_msg;
+
+	std::vector<StorageDevicePtr> to_fetch;
+	for (auto& drive : detected) {
+		auto known_iter = std::find_if(known_drives.cbegin(), known_drives.cend(), [&drive](const StorageDevicePtr& known) {
+			return known && !known->get_is_virtual()
+					&& known->get_device() == drive->get_device() && known->get_type_argument() == drive->get_type_argument();
+		});
+
+		if (refetch_known && known_iter != known_drives.cend()) {
+			const StorageDevicePtr& known = *known_iter;
+			if (!drive->get_info_output().empty()) {  // fetched during detection
+				known->set_info_output(drive->get_info_output_shared(), drive->get_info_output_read_time());
+				known->parse_basic_data();
+			} else {
+				known->clear_fetched();
+				to_fetch.push_back(known);
+			}
+			drive = known;
+			continue;
+		}
+
+		bool reuse = (known_iter != known_drives.cend()) && !(*known_iter)->get_info_output().empty();
+		if (reuse) {
+			const StorageDevicePtr& known = *known_iter;
+			std::string serial;
+			if (!drive->get_info_output().empty()) {  // fetched during detection, nothing to save
+				drive->parse_basic_data(false, false);
+				serial = drive->get_serial_number();
+			} else {
+				serial = read_sysfs_serial_number(drive);
+			}
+			// If the serial number cannot be read, we can't tell if it's the same drive.
+			if (serial.empty()) {
+				debug_out_info("app", "Device " << drive->get_device_with_type() << " has an unknown serial number, fetching its data again.\n");
+				reuse = false;
+			} else if (serial != known->get_serial_number()) {
+				debug_out_info("app", "Device " << drive->get_device_with_type() << " has changed its serial number from \""
+						<< known->get_serial_number() << "\" to \"" << serial << "\".\n");
+				reuse = false;
+			}
+		}
+
+		if (reuse) {
+			debug_out_info("app", "Device " << drive->get_device_with_type() << " is unchanged, reusing its data.\n");
+			drive = *known_iter;
+		} else {
+			to_fetch.push_back(drive);
+		}
+	}
+
+	fetch_basic_data(to_fetch, ex_factory, false);  // ignore its errors, there may be plenty of them.
+
+	put_drives_here.insert(put_drives_here.end(), detected.begin(), detected.end());
+	return error_msg;
+}
+
+
+
+
+
 
 /// @}
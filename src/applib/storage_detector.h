@@ -15,6 +15,7 @@ Copyright:
 #include <vector>
 #include <string>
 
+#include "app_pcrecpp_pattern_set.h"
 #include "storage_device.h"
 #include "command_executor.h"
 #include "command_executor_factory.h"
@@ -43,6 +44,18 @@ class StorageDetector {
 				const CommandExecutorFactoryPtr& ex_factory);
 
 
+		/// Run detect(), reusing the drives in \c known_drives which have the same device,
+		/// type argument and serial number as the detected ones (together with all
+		/// their fetched data). fetch_basic_data() is run only for new or changed drives, and
+		/// for the ones whose serial number cannot be read without running smartctl.
+		/// If \c refetch_known is true, the known drive objects are still reused, but their
+		/// basic data is fetched again (in place, emitting their "changed" signals).
+		/// \return An error if such occurs.
+		std::string detect_and_fetch_basic_data_incremental(std::vector<StorageDevicePtr>& put_drives_here,
+				const std::vector<StorageDevicePtr>& known_drives, const CommandExecutorFactoryPtr& ex_factory,
+				bool refetch_known = false);
+
+
 // 		void add_match_patterns(std::vector<std::string>& patterns)
 // 		{
 // 			match_patterns_.insert(match_patterns_.end(), patterns.begin(), patterns.end());
@@ -52,10 +65,14 @@ class StorageDetector {
 		/// Add device patterns to drive detection blacklist
 		void add_blacklist_patterns(const std::vector<std::string>& patterns)
 		{
-			blacklist_patterns_.insert(blacklist_patterns_.end(), patterns.begin(), patterns.end());
+			blacklist_.add_patterns(patterns);
 		}
 
 
+		/// Check whether a device matches the blacklist
+		[[nodiscard]] bool get_device_blacklisted(const std::string& device) const;
+
+
 		/// Get all errors produced by fetch_basic_data().
 		[[nodiscard]] const std::vector<std::string>& get_fetch_data_errors() const
 		{
@@ -73,7 +90,7 @@ class StorageDetector {
 	private:
 
 // 		std::vector<std::string> match_patterns_;  ///< First each file is matched against these
-		std::vector<std::string> blacklist_patterns_;  ///< If a device matches these, it's ignored.
+		AppPcrePatternSet blacklist_;  ///< If a device matches these patterns, it's ignored.
 
 		std::vector<std::string> fetch_data_errors_;  ///< Errors that have occurred
 		std::vector<std::string> fetch_data_error_outputs_;  ///< Corresponding command outputs to fetch_data_errors_
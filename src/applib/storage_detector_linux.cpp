@@ -26,8 +26,11 @@ Copyright:
 #include "hz/string_num.h"
 #include "rconfig/rconfig.h"
 #include "app_pcrecpp.h"
+#include "app_pcrecpp_pattern_set.h"
 #include "storage_detector_linux.h"
+#include "storage_detector_linux_sysfs.h"
 #include "storage_detector_helpers.h"
+#include "storage_detector_scan_open.h"
 
 
 
@@ -74,23 +77,16 @@ inline std::string detect_drives_linux_udev_byid(std::vector<std::string>& devic
 	}
 
 	// filter-out the ones with "partN" in them
-	static const std::vector<std::string> blacklist = {
+	static const AppPcrePatternSet blacklist({
 			"/-part[0-9]+$/"
-	};
+	});
 
 	std::error_code ec;
 	for (const auto& entry : hz::fs::directory_iterator(dir, ec)) {  // this outputs to debug too.
 		auto path = entry.path();
 
 		// platform blacklist
-		bool blacked = false;
-		for (const auto& bl_pattern : blacklist) {
-			if (app_pcre_match(bl_pattern, path.string())) {
-				blacked = true;
-				break;
-			}
-		}
-		if (blacked)
+		if (blacklist.match(path.string()))
 			continue;
 
 		// those are usually relative links, so find out where they are pointing to.
@@ -375,15 +371,8 @@ inline std::string detect_drives_linux_proc_partitions(std::vector<StorageDevice
 		return error_msg;
 	}
 
-	static const std::vector<std::string> blacklist = {
-		"/d[a-z][0-9]+$/",  // sda1, hdb2 - partitions. twa0 and twe1 are drives, not partitions.
-		"/ram[0-9]+$/",  // ramdisks?
-		"/loop[0-9]*$/",  // not sure if loop devices go there, but anyway...
-		"/part[0-9]+$/",  // devfs had them
-		"/p[0-9]+$/",  // partitions are usually marked this way
-		"/md[0-9]*$/",  // linux software raid
-		"/dm-[0-9]*$/",  // linux device mapper
-	};
+	// Empty if sysfs is not to be used
+	const auto sysfs_dir = hz::fs::u8path(rconfig::get_data<std::string>("system/linux_sysfs_class_block_path"));
 
 	std::vector<std::string> devices;
 
@@ -398,16 +387,9 @@ inline std::string detect_drives_linux_proc_partitions(std::vector<StorageDevice
 			continue;
 		}
 
-		// platform blacklist
-		bool blacked = false;
-		for (const auto& bl_pattern : blacklist) {
-			if (app_pcre_match(bl_pattern, dev)) {
-				blacked = true;
-				break;
-			}
-		}
-		if (blacked)
+		if (!linux_block_device_needs_probe(sysfs_dir, dev)) {
 			continue;
+		}
 
 		std::string path = "/dev/" + dev;  // let's just hope the it's /dev.
 		if (std::find(devices.begin(), devices.end(), path) == devices.end()) {  // there may be duplicates
@@ -1056,6 +1038,57 @@ inline std::string detect_drives_linux_hpsa(std::vector<StorageDevicePtr>& drive
 
 
 
+std::string linux_get_platform_blacklist_match(const std::string& dev)
+{
+	// Compiled once into a single alternation, so that systems with many
+	// dm / loop devices don't pay for a pattern compilation per device.
+	static const AppPcrePatternSet blacklist({
+		"/d[a-z][0-9]+$/",  // sda1, hdb2 - partitions. twa0 and twe1 are drives, not partitions.
+		"/ram[0-9]+$/",  // ramdisks? zram too.
+		"/loop[0-9]*$/",  // not sure if loop devices go there, but anyway...
+		"/part[0-9]+$/",  // devfs had them
+		"/p[0-9]+$/",  // partitions are usually marked this way
+		"/md[0-9]*$/",  // linux software raid
+		"/dm-[0-9]*$/",  // linux device mapper
+		"/nbd[0-9]+$/",  // network block devices
+	});
+
+	if (const auto index = blacklist.find_match(dev); index.has_value()) {
+		return blacklist.get_patterns().at(index.value());
+	}
+	return {};
+}
+
+
+
+bool linux_block_device_needs_probe(const hz::fs::path& sysfs_class_block_dir, const std::string& dev)
+{
+	// Decide by sysfs information if available, this avoids running smartctl on
+	// partitions, virtual devices, controllers, etc...
+	const LinuxSysfsBlockDeviceInfo sysfs_info = linux_sysfs_classify_block_device(sysfs_class_block_dir, dev);
+	if (sysfs_info.kind != LinuxSysfsBlockDeviceInfo::Kind::unknown) {
+		if (!sysfs_info.needs_probe()) {
+			debug_out_dump("app", "Device /dev/" << dev << " is not a drive according to sysfs ("
+					<< linux_sysfs_block_device_kind_name(sysfs_info.kind) << ": " << sysfs_info.reason << "), ignoring.\n");
+			return false;
+		}
+		debug_out_dump("app", "Device /dev/" << dev << " is a drive according to sysfs ("
+				<< linux_sysfs_block_device_kind_name(sysfs_info.kind) << ": " << sysfs_info.reason
+				<< (sysfs_info.type_hint.empty() ? std::string() : ", likely type: " + sysfs_info.type_hint) << ").\n");
+		return true;
+	}
+
+	// platform blacklist
+	if (const std::string bl_pattern = linux_get_platform_blacklist_match(dev); !bl_pattern.empty()) {
+		debug_out_dump("app", "Device /dev/" << dev << " matches platform blacklist pattern \""
+				<< bl_pattern << "\", ignoring.\n");
+		return false;
+	}
+	return true;
+}
+
+
+
 std::string detect_drives_linux(std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory)
 {
 	clear_read_file_cache();
@@ -1074,31 +1107,59 @@ std::string detect_drives_linux(std::vector<StorageDevicePtr>& drives, const Com
 		error_msgs.push_back(error_msg);
 	}
 
-	error_msg = detect_drives_linux_3ware(drives, ex_factory);
-	if (!error_msg.empty()) {
-		error_msgs.push_back(error_msg);
+	// A single "smartctl --scan-open" finds the drives behind most RAID controllers.
+	// Use its results for the controller families it reports, and fall back to port
+	// brute-forcing (one smartctl call per port) only for the ones it misses.
+	std::vector<SmartctlScanOpenEntry> scan_entries;
+	if (rconfig::get_data<bool>("system/linux_use_scan_open")) {
+		error_msg = smartctl_scan_open(ex_factory, scan_entries);
+		if (!error_msg.empty()) {
+			debug_out_info("app", DBG_FUNC_MSG << "smartctl --scan-open failed, using port scanning only: " << error_msg << "\n");
+			scan_entries.clear();
+		}
 	}
 
-	error_msg = detect_drives_linux_areca(drives, ex_factory);
-	if (!error_msg.empty()) {
-		error_msgs.push_back(error_msg);
+	if (smartctl_scan_open_add_drives(scan_entries, "3ware,", drives) == 0) {
+		error_msg = detect_drives_linux_3ware(drives, ex_factory);
+		if (!error_msg.empty()) {
+			error_msgs.push_back(error_msg);
+		}
 	}
 
-	error_msg = detect_drives_linux_adaptec(drives, ex_factory);
-	if (!error_msg.empty()) {
-		error_msgs.push_back(error_msg);
+	if (smartctl_scan_open_add_drives(scan_entries, "areca,", drives) == 0) {
+		error_msg = detect_drives_linux_areca(drives, ex_factory);
+		if (!error_msg.empty()) {
+			error_msgs.push_back(error_msg);
+		}
 	}
 
-	error_msg = detect_drives_linux_cciss(drives, ex_factory);
+	// smartctl doesn't scan Adaptec controllers by itself.
+	error_msg = detect_drives_linux_adaptec(drives, ex_factory);
 	if (!error_msg.empty()) {
 		error_msgs.push_back(error_msg);
 	}
 
-	error_msg = detect_drives_linux_hpsa(drives, ex_factory);
-	if (!error_msg.empty()) {
-		error_msgs.push_back(error_msg);
+	// Both cciss and hpsa drives use "-d cciss,N".
+	if (smartctl_scan_open_add_drives(scan_entries, "cciss,", drives) == 0) {
+		error_msg = detect_drives_linux_cciss(drives, ex_factory);
+		if (!error_msg.empty()) {
+			error_msgs.push_back(error_msg);
+		}
+
+		error_msg = detect_drives_linux_hpsa(drives, ex_factory);
+		if (!error_msg.empty()) {
+			error_msgs.push_back(error_msg);
+		}
 	}
 
+	// The rest of the --scan-open drives (other controller types, drives missing
+	// from the partitions file, etc...). The plain devices are filtered just like
+	// the ones in the partitions file.
+	const auto sysfs_dir = hz::fs::u8path(rconfig::get_data<std::string>("system/linux_sysfs_class_block_path"));
+	smartctl_scan_open_add_remaining_drives(scan_entries, drives, [&sysfs_dir](const std::string& device) {
+		return linux_block_device_needs_probe(sysfs_dir, hz::fs::u8path(device).filename().u8string());
+	});
+
 	return hz::string_join(error_msgs, "\n");
 }
 
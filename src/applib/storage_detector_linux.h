@@ -23,6 +23,18 @@ Copyright:
 
 
 
+/// Check whether a block device name (e.g. "sda1", "loop0") matches the platform blacklist
+/// (partitions, ramdisks, software raid, etc...). Used when sysfs can't tell what the device is.
+/// \return the matching pattern, or an empty string if the device is not blacklisted.
+std::string linux_get_platform_blacklist_match(const std::string& dev);
+
+
+/// Check whether a block device (e.g. "sda") may be a drive and should be probed with smartctl.
+/// This is decided by sysfs information in \c sysfs_class_block_dir (if it's not empty and it
+/// knows the device), or by the platform blacklist otherwise.
+bool linux_block_device_needs_probe(const hz::fs::path& sysfs_class_block_dir, const std::string& dev);
+
+
 /// Detect drives in Linux
 std::string detect_drives_linux(std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory);
 
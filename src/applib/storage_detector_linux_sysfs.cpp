@@ -0,0 +1,186 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <array>
+#include <string_view>
+
+#include "hz/fs.h"
+#include "hz/string_algo.h"
+#include "hz/string_num.h"
+#include "storage_detector_linux_sysfs.h"
+
+
+
+namespace {
+
+
+	/// Read a (small) sysfs attribute file, trimmed. Returns std::nullopt if it cannot be read.
+	std::optional<std::string> read_sysfs_attribute(const hz::fs::path& file)
+	{
+		std::string contents;
+		if (hz::fs_file_get_contents_unseekable(file, contents)) {
+			return std::nullopt;
+		}
+		hz::string_trim(contents);
+		return contents;
+	}
+
+
+	/// Check whether a directory exists and has any entries
+	bool sysfs_dir_has_entries(const hz::fs::path& dir)
+	{
+		std::error_code ec;
+		const hz::fs::directory_iterator iter(dir, ec);
+		return !ec && iter != hz::fs::directory_iterator();
+	}
+
+
+}
+
+
+
+LinuxSysfsBlockDeviceInfo linux_sysfs_classify_block_device(const hz::fs::path& sysfs_class_block_dir, const std::string& name)
+{
+	using Kind = LinuxSysfsBlockDeviceInfo::Kind;
+
+	LinuxSysfsBlockDeviceInfo info;
+
+	const hz::fs::path dir = sysfs_class_block_dir / hz::fs::u8path(name);
+	std::error_code ec;
+	if (sysfs_class_block_dir.empty() || name.empty() || !hz::fs::exists(dir, ec)) {
+		info.reason = "no sysfs entry";
+		return info;
+	}
+
+	// These never have SMART, no need to look further.
+	static constexpr std::array<std::string_view, 6> virtual_prefixes = {"loop", "ram", "zram", "nbd", "dm-", "md"};
+	for (const auto& prefix : virtual_prefixes) {
+		if (hz::string_begins_with(name, std::string(prefix))) {
+			info.kind = Kind::virtual_device;
+			info.reason = "virtual device name";
+			return info;
+		}
+	}
+	if (hz::fs::exists(dir / "dm", ec) || hz::fs::exists(dir / "md", ec)) {
+		info.kind = Kind::virtual_device;
+		info.reason = "device mapper or software RAID";
+		return info;
+	}
+
+	if (hz::fs::exists(dir / "partition", ec)) {
+		info.kind = Kind::partition;
+		info.reason = "partition";
+		return info;
+	}
+
+	// Stacked devices are built on top of other block devices.
+	if (sysfs_dir_has_entries(dir / "slaves")) {
+		info.kind = Kind::virtual_device;
+		info.reason = "stacked on other devices";
+		return info;
+	}
+
+	// Devices without backing hardware don't have "device" link.
+	if (!hz::fs::exists(dir / "device", ec)) {
+		info.kind = Kind::virtual_device;
+		info.reason = "no backing device";
+		return info;
+	}
+
+	info.removable = (read_sysfs_attribute(dir / "removable").value_or("0") == "1");
+	if (auto rotational = read_sysfs_attribute(dir / "queue" / "rotational")) {
+		info.rotational = (*rotational == "1");
+	}
+	info.vendor = read_sysfs_attribute(dir / "device" / "vendor").value_or(std::string());
+	info.model = read_sysfs_attribute(dir / "device" / "model").value_or(std::string());
+
+	if (hz::string_begins_with(name, "nvme")) {
+		// nvme0c0n1-style entries are hidden multipath controller paths of nvme0n1.
+		if (name.find('c', 4) != std::string::npos) {
+			info.kind = Kind::other;
+			info.reason = "NVMe multipath controller path";
+			return info;
+		}
+		info.kind = Kind::disk;
+		info.reason = "NVMe namespace";
+		info.type_hint = "nvme";
+		return info;
+	}
+
+	// SCSI peripheral device type (sd, sr, libata devices)
+	if (auto type_str = read_sysfs_attribute(dir / "device" / "type")) {
+		int scsi_type = -1;
+		if (hz::string_is_numeric_nolocale(*type_str, scsi_type, true)) {
+			switch (scsi_type) {
+				case 0x00:  // Direct access block device
+				case 0x0e:  // Simplified direct-access device (RBC)
+					info.kind = Kind::disk;
+					info.reason = "SCSI disk";
+					break;
+				case 0x05:  // CD/DVD
+					info.kind = Kind::cddvd;
+					info.reason = "SCSI CD/DVD";
+					break;
+				case 0x0c:  // Storage array controller
+					info.kind = Kind::controller;
+					info.reason = "SCSI storage array controller";
+					break;
+				default:
+					info.kind = Kind::other;
+					info.reason = "SCSI peripheral type " + *type_str;
+					break;
+			}
+		}
+	}
+
+	// 3ware controllers export themselves as sd*; their drives are found by 3ware detection.
+	if (info.vendor == "AMCC" || info.vendor == "3ware") {
+		info.kind = Kind::controller;
+		info.reason = "3ware controller";
+		return info;
+	}
+
+	// libata reports "ATA" as vendor for (S)ATA drives.
+	if (info.kind == Kind::disk && info.vendor == "ATA") {
+		info.type_hint = "sat";
+	}
+
+	if (info.kind == Kind::unknown) {
+		info.kind = Kind::disk;  // hd*, vd*, mmcblk*, etc...
+		info.reason = "block device with backing hardware";
+	}
+
+	return info;
+}
+
+
+
+std::string linux_sysfs_block_device_kind_name(LinuxSysfsBlockDeviceInfo::Kind kind)
+{
+	using Kind = LinuxSysfsBlockDeviceInfo::Kind;
+	switch (kind) {
+		case Kind::unknown: return "unknown";
+		case Kind::disk: return "disk";
+		case Kind::cddvd: return "cddvd";
+		case Kind::controller: return "controller";
+		case Kind::virtual_device: return "virtual";
+		case Kind::partition: return "partition";
+		case Kind::other: return "other";
+	}
+	return "unknown";
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,69 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef STORAGE_DETECTOR_LINUX_SYSFS_H
+#define STORAGE_DETECTOR_LINUX_SYSFS_H
+
+#include <string>
+#include <optional>
+
+#include "hz/fs_ns.h"
+
+
+
+/// Information about a Linux block device, read from sysfs without running smartctl
+struct LinuxSysfsBlockDeviceInfo {
+
+	/// Device kind
+	enum class Kind {
+		unknown,  ///< No sysfs information available
+		disk,  ///< Hard disk, SSD, NVMe namespace, etc...
+		cddvd,  ///< CD/DVD/Blu-Ray drive
+		controller,  ///< RAID controller exporting itself as a disk (e.g. 3ware), handled by controller-specific detection
+		virtual_device,  ///< Loop, ramdisk, zram, nbd, device mapper, software RAID, etc...
+		partition,  ///< Partition of another device
+		other,  ///< Tape, enclosure, media changer, etc...
+	};
+
+	Kind kind = Kind::unknown;  ///< Device kind
+	std::string reason;  ///< Why the device was classified this way (for debug output)
+	bool removable = false;  ///< "removable" flag
+	std::optional<bool> rotational;  ///< "queue/rotational" flag
+	std::string vendor;  ///< "device/vendor", SCSI / libata only
+	std::string model;  ///< "device/model"
+	std::string type_hint;  ///< The smartctl "-d" type which is most likely to work ("nvme", "sat"), or empty if unknown.
+
+
+	/// Check whether it's worth running smartctl on the device
+	[[nodiscard]] bool needs_probe() const
+	{
+		return kind == Kind::unknown || kind == Kind::disk || kind == Kind::cddvd;
+	}
+
+};
+
+
+
+/// Classify a block device by its sysfs entry (\c sysfs_class_block_dir / \c name,
+/// where \c sysfs_class_block_dir is usually "/sys/class/block" and \c name is e.g. "sda").
+LinuxSysfsBlockDeviceInfo linux_sysfs_classify_block_device(const hz::fs::path& sysfs_class_block_dir, const std::string& name);
+
+
+
+/// Get the kind as a displayable string (for debug output)
+std::string linux_sysfs_block_device_kind_name(LinuxSysfsBlockDeviceInfo::Kind kind);
+
+
+
+
+#endif
+
+/// @}
@@ -0,0 +1,134 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include "local_glibmm.h"
+#include <algorithm>
+
+#include "json/json.hpp"
+#include "hz/debug.h"
+#include "hz/string_algo.h"
+#include "smartctl_executor.h"  // execute_smartctl()
+#include "storage_detector_scan_open.h"
+
+
+
+std::string smartctl_scan_open_parse_json(const std::string& json_output, std::vector<SmartctlScanOpenEntry>& entries)
+{
+	try {
+		const nlohmann::json root = nlohmann::json::parse(json_output);
+
+		auto devices_iter = root.find("devices");
+		if (devices_iter == root.end() || !devices_iter->is_array()) {
+			return "No devices array in smartctl --scan-open output.";
+		}
+
+		for (const auto& device : *devices_iter) {
+			// Devices which couldn't be opened (e.g. empty RAID ports) have "open_error".
+			if (device.contains("open_error")) {
+				debug_out_dump("app", "Skipping device " << device.value("info_name", std::string())
+						<< ": " << device.at("open_error").dump() << "\n");
+				continue;
+			}
+			SmartctlScanOpenEntry entry;
+			entry.device = device.value("name", std::string());
+			entry.type = device.value("type", std::string());
+			entry.protocol = device.value("protocol", std::string());
+			if (!entry.device.empty()) {
+				entries.push_back(entry);
+			}
+		}
+	}
+	catch (const nlohmann::json::exception& e) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot parse smartctl --scan-open output: " << e.what() << "\n");
+		return "Cannot parse smartctl --scan-open output.";
+	}
+
+	return {};
+}
+
+
+
+std::string smartctl_scan_open(const CommandExecutorFactoryPtr& ex_factory, std::vector<SmartctlScanOpenEntry>& entries)
+{
+	debug_out_info("app", DBG_FUNC_MSG << "Detecting drives through smartctl --scan-open...\n");
+
+	std::shared_ptr<CommandExecutor> smartctl_ex = ex_factory->create_executor(CommandExecutorFactory::ExecutorType::Smartctl);
+
+	SharedOutput output;
+	std::string error_msg = execute_smartctl(std::string(), std::string(), "--scan-open --json", smartctl_ex, output);
+	if (!error_msg.empty()) {
+		return error_msg;
+	}
+
+	return smartctl_scan_open_parse_json(*output, entries);
+}
+
+
+
+std::size_t smartctl_scan_open_add_drives(const std::vector<SmartctlScanOpenEntry>& entries,
+		const std::string& type_prefix, std::vector<StorageDevicePtr>& drives)
+{
+	std::size_t num_matched = 0;
+	for (const auto& entry : entries) {
+		if (!hz::string_begins_with(entry.type, type_prefix)) {
+			continue;
+		}
+		++num_matched;
+
+		const bool exists = std::any_of(drives.cbegin(), drives.cend(), [&entry](const StorageDevicePtr& drive) {
+			return drive->get_device() == entry.device && drive->get_type_argument() == entry.type;
+		});
+		if (!exists) {
+			drives.push_back(std::make_shared<StorageDevice>(entry.device, entry.type));
+			debug_out_info("app", "Added drive " << drives.back()->get_device_with_type() << " (found by --scan-open).\n");
+		}
+	}
+	return num_matched;
+}
+
+
+
+std::size_t smartctl_scan_open_add_remaining_drives(const std::vector<SmartctlScanOpenEntry>& entries,
+		std::vector<StorageDevicePtr>& drives, const std::function<bool(const std::string& device)>& device_filter)
+{
+	std::size_t num_added = 0;
+	for (const auto& entry : entries) {
+		// Drives behind controllers share the device name and differ by port ("megaraid,0").
+		const bool is_port = entry.type.find(',') != std::string::npos;
+
+		const bool exists = std::any_of(drives.cbegin(), drives.cend(), [&entry, is_port](const StorageDevicePtr& drive) {
+			if (is_port) {
+				return drive->get_device() == entry.device && drive->get_type_argument() == entry.type;
+			}
+			// The same drive may have been found by other means, without a type.
+			// smartctl reports NVMe controllers (/dev/nvme0), we list their namespaces (/dev/nvme0n1).
+			return drive->get_device() == entry.device
+					|| (entry.type == "nvme" && hz::string_begins_with(drive->get_device(), entry.device + "n"));
+		});
+		if (!exists && !is_port && device_filter && !device_filter(entry.device)) {
+			debug_out_dump("app", "Ignoring " << entry.device << " found by --scan-open, it's not a drive.\n");
+			continue;
+		}
+		if (!exists) {
+			drives.push_back(std::make_shared<StorageDevice>(entry.device, entry.type));
+			debug_out_info("app", "Added drive " << drives.back()->get_device_with_type() << " (found by --scan-open).\n");
+			++num_added;
+		}
+	}
+	return num_added;
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,65 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef STORAGE_DETECTOR_SCAN_OPEN_H
+#define STORAGE_DETECTOR_SCAN_OPEN_H
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "command_executor_factory.h"
+#include "storage_device.h"
+
+
+
+/// A device reported by "smartctl --scan-open"
+struct SmartctlScanOpenEntry {
+	std::string device;  ///< e.g. "/dev/sda" or "/dev/twa0"
+	std::string type;  ///< "-d" argument, e.g. "sat" or "3ware,2"
+	std::string protocol;  ///< "ATA", "SCSI", "NVMe"
+};
+
+
+
+/// Parse "smartctl --scan-open --json" output. Devices which could not be opened are skipped.
+/// \return error message on error.
+std::string smartctl_scan_open_parse_json(const std::string& json_output, std::vector<SmartctlScanOpenEntry>& entries);
+
+
+/// Run "smartctl --scan-open --json" and parse its output. This finds the drives behind
+/// many RAID controllers with a single smartctl invocation.
+/// \return error message on error.
+std::string smartctl_scan_open(const CommandExecutorFactoryPtr& ex_factory, std::vector<SmartctlScanOpenEntry>& entries);
+
+
+/// Add the drives of \c entries with type starting with \c type_prefix (e.g. "3ware,") to \c drives,
+/// skipping the ones already there.
+/// \return the number of matching entries (including the skipped ones).
+std::size_t smartctl_scan_open_add_drives(const std::vector<SmartctlScanOpenEntry>& entries,
+		const std::string& type_prefix, std::vector<StorageDevicePtr>& drives);
+
+
+/// Add the drives of \c entries which were not found by other means to \c drives.
+/// Drives behind controllers (with a port in their type, e.g. "megaraid,0") are compared
+/// by device and type, the others by device only. The others are added only if
+/// \c device_filter (if set) accepts their device.
+/// \return the number of added drives.
+std::size_t smartctl_scan_open_add_remaining_drives(const std::vector<SmartctlScanOpenEntry>& entries,
+		std::vector<StorageDevicePtr>& drives,
+		const std::function<bool(const std::string& device)>& device_filter = nullptr);
+
+
+
+
+#endif
+
+/// @}
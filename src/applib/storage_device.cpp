@@ -78,10 +78,19 @@ StorageDevice::StorageDevice(std::string dev, std::string type_arg)
 
 
 
+StorageDevice::~StorageDevice()
+{
+	changed_idle_conn_.disconnect();
+}
+
+
+
 void StorageDevice::clear_fetched(bool including_outputs) {
 	if (including_outputs) {
-		info_output_.clear();
-		full_output_.clear();
+		info_output_.reset();
+		full_output_.reset();
+		info_output_read_time_.reset();
+		full_output_read_time_.reset();
 	}
 
 	parse_status_ = ParseStatus::none;
@@ -110,6 +119,7 @@ std::string StorageDevice::fetch_basic_data_and_parse(const std::shared_ptr<Comm
 	// We don't use "--all" - it may cause really screwed up the output (tests, etc...).
 	// This looks just like "--info" only on non-smart devices.
 	std::string error_msg = execute_device_smartctl("--info --health --capabilities", smartctl_ex, this->info_output_, true);  // set type to invalid if needed
+	info_output_read_time_ = std::chrono::system_clock::now();
 
 	// Smartctl 5.39 cvs/svn version defaults to usb type on at least linux and windows.
 	// This means that the old SCSI identify command isn't executed by default,
@@ -140,13 +150,33 @@ std::string StorageDevice::parse_basic_data(bool do_set_properties, bool emit_si
 {
 	this->clear_fetched(false);  // clear everything fetched before, except outputs
 
-	if (this->info_output_.empty()) {
+	if (this->get_info_output().empty()) {
 		debug_out_error("app", DBG_FUNC_MSG << "String to parse is empty.\n");
 		return _("Cannot read information from an empty string.");
 	}
 
+	// If the output can be parsed properly, take the basic data from the parsed
+	// properties, so that the output is scanned only once.
+	if (do_set_properties) {
+		auto parser = SmartctlParser::create(SmartctlParserType::Text);
+		DBG_ASSERT_RETURN(parser, "Cannot create parser");
+
+		if (parser->parse_full(this->get_info_output())) {
+			this->set_basic_data_from_properties(parser->get_properties());
+			this->set_properties(StoragePropertyProcessor::process_properties(parser->get_properties(), get_disk_type()));
+
+			set_parse_status(model_name_.has_value() ? ParseStatus::info : ParseStatus::none);
+
+			if (emit_signal)
+				notify_changed(change_identity | change_properties);  // notify listeners
+
+			return {};
+		}
+	}
+
+	// The parser failed (or wasn't asked for), use the looser regex-based detection below.
 	std::string version, version_full;
-	if (!SmartctlVersionParser::parse_version(this->info_output_, version, version_full))  // is this smartctl data at all?
+	if (!SmartctlVersionParser::parse_version(this->get_info_output(), version, version_full))  // is this smartctl data at all?
 		return _("Cannot get smartctl version information.");
 
 	// Detect type. note: we can't distinguish between sata and scsi (on linux, for -d ata switch).
@@ -155,15 +185,15 @@ std::string StorageDevice::parse_basic_data(bool do_set_properties, bool emit_si
 	// Sample output line 2 (encountered on a BDRW drive):
 	// Device type:          CD/DVD
 	// NOTE: CD/DVD detection does not work in "-d scsi" mode.
-	if (app_pcre_match("/this device: CD\\/DVD/mi", info_output_)
-			|| app_pcre_match("/^Device type:\\s+CD\\/DVD/mi", info_output_)) {
+	if (app_pcre_match("/this device: CD\\/DVD/mi", get_info_output())
+			|| app_pcre_match("/^Device type:\\s+CD\\/DVD/mi", get_info_output())) {
 		debug_out_dump("app", "Drive " << get_device_with_type() << " seems to be a CD/DVD device.\n");
 		this->set_detected_type(DetectedType::cddvd);
 
 	// This was encountered on a csmi soft-raid under windows with pd0.
 	// The device reported that it had smart supported and enabled.
 	// Product:              Raid 5 Volume
-	} else if (app_pcre_match("/Product:[ \\t]*Raid/mi", info_output_)) {
+	} else if (app_pcre_match("/Product:[ \\t]*Raid/mi", get_info_output())) {
 		debug_out_dump("app", "Drive " << get_device_with_type() << " seems to be a RAID volume/controller.\n");
 		this->set_detected_type(DetectedType::raid);
 	}
@@ -180,45 +210,45 @@ std::string StorageDevice::parse_basic_data(bool do_set_properties, bool emit_si
 		// Compared to SmartctlAtaTextParser, this one is much looser.
 
 		// Don't put complete messages here - they change across smartctl versions.
-		if (app_pcre_match("/^SMART support is:[ \\t]*Unavailable/mi", info_output_)  // cdroms output this
-				|| app_pcre_match("/Device does not support SMART/mi", info_output_)  // usb flash drives, non-smart hds
-				|| app_pcre_match("/Device Read Identity Failed/mi", info_output_)) {  // solaris scsi, unsupported by smartctl (maybe others?)
+		if (app_pcre_match("/^SMART support is:[ \\t]*Unavailable/mi", get_info_output())  // cdroms output this
+				|| app_pcre_match("/Device does not support SMART/mi", get_info_output())  // usb flash drives, non-smart hds
+				|| app_pcre_match("/Device Read Identity Failed/mi", get_info_output())) {  // solaris scsi, unsupported by smartctl (maybe others?)
 			smart_supported_ = false;
 			smart_enabled_ = false;
 
-		} else if (app_pcre_match("/^SMART support is:[ \\t]*Available/mi", info_output_)
-				|| app_pcre_match("/^SMART support is:[ \\t]*Ambiguous/mi", info_output_)) {
+		} else if (app_pcre_match("/^SMART support is:[ \\t]*Available/mi", get_info_output())
+				|| app_pcre_match("/^SMART support is:[ \\t]*Ambiguous/mi", get_info_output())) {
 			smart_supported_ = true;
 
-			if (app_pcre_match("/^SMART support is:[ \\t]*Enabled/mi", info_output_)) {
+			if (app_pcre_match("/^SMART support is:[ \\t]*Enabled/mi", get_info_output())) {
 				smart_enabled_ = true;
-			} else if (app_pcre_match("/^SMART support is:[ \\t]*Disabled/mi", info_output_)) {
+			} else if (app_pcre_match("/^SMART support is:[ \\t]*Disabled/mi", get_info_output())) {
 				smart_enabled_ = false;
 			}
 		}
 	}
 
 	std::string model;
-	if (app_pcre_match("/^Device Model:[ \\t]*(.*)$/mi", info_output_, &model)) {  // HD's and cdroms
+	if (app_pcre_match("/^Device Model:[ \\t]*(.*)$/mi", get_info_output(), &model)) {  // HD's and cdroms
 		model_name_ = hz::string_remove_adjacent_duplicates_copy(hz::string_trim_copy(model), ' ');
 
-	} else if (app_pcre_match("/^(?:Device|Product):[ \\t]*(.*)$/mi", info_output_, &model)) {  // usb flash drives
+	} else if (app_pcre_match("/^(?:Device|Product):[ \\t]*(.*)$/mi", get_info_output(), &model)) {  // usb flash drives
 		model_name_ = hz::string_remove_adjacent_duplicates_copy(hz::string_trim_copy(model), ' ');
 	}
 
 
 	std::string family;  // this is from smartctl's database
-	if (app_pcre_match("/^Model Family:[ \\t]*(.*)$/mi", info_output_, &family)) {
+	if (app_pcre_match("/^Model Family:[ \\t]*(.*)$/mi", get_info_output(), &family)) {
 		family_name_ = hz::string_remove_adjacent_duplicates_copy(hz::string_trim_copy(family), ' ');
 	}
 
 	std::string serial;
-	if (app_pcre_match("/^Serial Number:[ \\t]*(.*)$/mi", info_output_, &serial)) {
+	if (app_pcre_match("/^Serial Number:[ \\t]*(.*)$/mi", get_info_output(), &serial)) {
 		serial_number_ = hz::string_remove_adjacent_duplicates_copy(hz::string_trim_copy(serial), ' ');
 	}
 
 	std::string rpm_str;
-	if (app_pcre_match("/^Rotation Rate:[ \\t]*(.*)$/mi", info_output_, &rpm_str)) {
+	if (app_pcre_match("/^Rotation Rate:[ \\t]*(.*)$/mi", get_info_output(), &rpm_str)) {
 		const int rpm = hz::string_to_number_nolocale<int>(rpm_str, false);
 		hdd_ = rpm > 0;
 	}
@@ -226,48 +256,116 @@ std::string StorageDevice::parse_basic_data(bool do_set_properties, bool emit_si
 
 	// Note: this property is present since 5.33.
 	std::string size;
-	if (app_pcre_match("/^User Capacity:[ \\t]*(.*)$/mi", info_output_, &size)) {
+	if (app_pcre_match("/^User Capacity:[ \\t]*(.*)$/mi", get_info_output(), &size)) {
 		int64_t bytes = 0;
 		size_ = SmartctlTextParserHelper::parse_byte_size(size, bytes, false);
 	}
 
 
-	// Try to parse the properties. ignore its errors - we already got what we came for.
-	// Note that this may try to parse data the second time (it may already have
-	// been parsed by parse_data() which failed at it).
-	if (do_set_properties) {
-		AtaStorageAttribute::DiskType disk_type = AtaStorageAttribute::DiskType::Any;
-		if (hdd_.has_value()) {
-			disk_type = hdd_.value() ? AtaStorageAttribute::DiskType::Hdd : AtaStorageAttribute::DiskType::Ssd;
+	// A model field (and its aliases) is a good indication whether there was any data or not
+	set_parse_status(model_name_.has_value() ? ParseStatus::info : ParseStatus::none);
+
+	if (emit_signal)
+		notify_changed(change_identity | change_properties);  // notify listeners
+
+	return {};
+}
+
+
+
+void StorageDevice::set_basic_data_from_properties(const std::vector<AtaStorageProperty>& props)
+{
+	// This mirrors the regex-based detection in parse_basic_data(), see the comments there.
+	std::optional<std::string> device_model;
+	for (const auto& p : props) {
+		if (p.section != AtaStorageProperty::Section::info) {
+			continue;
 		}
 
-		auto parser = SmartctlParser::create(SmartctlParserType::Text);
-		DBG_ASSERT_RETURN(parser, "Cannot create parser");
+		if (p.generic_name == "model_name") {
+			// "Device Model" takes precedence over usb / scsi "Device" and "Product".
+			const bool is_device_model = app_pcre_match("/^Device Model$/i", p.reported_name);
+			if (is_device_model || !device_model.has_value()) {
+				model_name_ = hz::string_remove_adjacent_duplicates_copy(hz::string_trim_copy(p.reported_value), ' ');
+			}
+			if (is_device_model) {
+				device_model = model_name_;
+			}
+			// This was encountered on a csmi soft-raid under windows with pd0.
+			if (app_pcre_match("/^Product$/i", p.reported_name) && app_pcre_match("/^Raid/i", p.reported_value)) {
+				debug_out_dump("app", "Drive " << get_device_with_type() << " seems to be a RAID volume/controller.\n");
+				this->set_detected_type(DetectedType::raid);
+			}
+
+		} else if (p.generic_name == "model_family") {
+			family_name_ = hz::string_remove_adjacent_duplicates_copy(hz::string_trim_copy(p.reported_value), ' ');
+
+		} else if (p.generic_name == "serial_number") {
+			serial_number_ = hz::string_remove_adjacent_duplicates_copy(hz::string_trim_copy(p.reported_value), ' ');
+
+		} else if (p.generic_name == "rotation_rate") {
+			const int rpm = hz::string_to_number_nolocale<int>(p.reported_value, false);
+			hdd_ = rpm > 0;
+
+		} else if (p.generic_name == "user_capacity/bytes") {
+			int64_t bytes = 0;
+			size_ = SmartctlTextParserHelper::parse_byte_size(p.reported_value, bytes, false);
+
+		} else if (p.generic_name == "device_type/name") {
+			if (app_pcre_match("/^CD\\/DVD/i", p.reported_value)) {
+				debug_out_dump("app", "Drive " << get_device_with_type() << " seems to be a CD/DVD device.\n");
+				this->set_detected_type(DetectedType::cddvd);
+			}
 
-		if (parser->parse_full(this->info_output_)) {  // try to parse it
-			this->set_properties(StoragePropertyProcessor::process_properties(parser->get_properties(), disk_type));  // copy to our drive, overwriting old data
+		} else if (p.generic_name == "_text_only/smart_supported" && p.is_value_type<bool>()) {
+			smart_supported_ = p.get_value<bool>();
+			if (!smart_supported_.value()) {
+				smart_enabled_ = false;
+			}
+			if (app_pcre_match("/this device: CD\\/DVD/i", p.reported_value)) {
+				debug_out_dump("app", "Drive " << get_device_with_type() << " seems to be a CD/DVD device.\n");
+				this->set_detected_type(DetectedType::cddvd);
+			}
+
+		} else if (p.generic_name == "_text_only/smart_enabled" && p.is_value_type<bool>()) {
+			smart_enabled_ = p.get_value<bool>();
 		}
 	}
 
-	// A model field (and its aliases) is a good indication whether there was any data or not
-	set_parse_status(model_name_.has_value() ? ParseStatus::info : ParseStatus::none);
+	// RAID volume may report that it has SMART, but it obviously doesn't.
+	if (get_detected_type() == DetectedType::raid) {
+		smart_supported_ = false;
+		smart_enabled_ = false;
 
-	if (emit_signal)
-		signal_changed().emit(this);  // notify listeners
+	// These messages are printed outside the info section. Only look for them if
+	// the info section didn't say anything about SMART support.
+	} else if (!smart_supported_.has_value()
+			&& (get_info_output().find("Device does not support SMART") != std::string::npos  // usb flash drives, non-smart hds
+			|| get_info_output().find("Device Read Identity Failed") != std::string::npos)) {  // solaris scsi
+		smart_supported_ = false;
+		smart_enabled_ = false;
+	}
+}
 
-	return {};
+
+
+AtaStorageAttribute::DiskType StorageDevice::get_disk_type() const
+{
+	if (hdd_.has_value()) {
+		return hdd_.value() ? AtaStorageAttribute::DiskType::Hdd : AtaStorageAttribute::DiskType::Ssd;
+	}
+	return AtaStorageAttribute::DiskType::Any;
 }
 
 
 
-std::string StorageDevice::fetch_data_and_parse(const std::shared_ptr<CommandExecutor>& smartctl_ex)
+std::string StorageDevice::fetch_data(const std::shared_ptr<CommandExecutor>& smartctl_ex)
 {
 	if (this->test_is_active_)
 		return _("A test is currently being performed on this drive.");
 
-	this->clear_fetched();  // clear everything fetched before, including outputs
-
-	std::string output;
+	// The previously parsed data is kept until the new output is parsed.
+	SharedOutput output;
 	std::string error_msg;
 
 	const SmartctlParserSettingType default_parser_type = SmartctlParserSettingType::Text;
@@ -294,7 +392,7 @@ std::string StorageDevice::fetch_data_and_parse(const std::shared_ptr<CommandExe
 	if (get_detected_type() == DetectedType::invalid && get_type_argument().empty()) {
 		debug_out_info("app", "The device seems to be of different type than auto-detected, trying again with scsi.\n");
 		this->set_type_argument("scsi");
-		return this->fetch_data_and_parse(smartctl_ex);  // try again with scsi
+		return this->fetch_data(smartctl_ex);  // try again with scsi
 	}
 
 	// Since the type error leads to "command line didn't parse" error here,
@@ -302,7 +400,24 @@ std::string StorageDevice::fetch_data_and_parse(const std::shared_ptr<CommandExe
 	if (!error_msg.empty())
 		return error_msg;
 
-	this->full_output_ = output;
+	this->full_output_ = std::move(output);
+	this->full_output_read_time_ = std::chrono::system_clock::now();
+	return {};
+}
+
+
+
+std::string StorageDevice::fetch_data_and_parse(const std::shared_ptr<CommandExecutor>& smartctl_ex)
+{
+	if (this->test_is_active_)
+		return _("A test is currently being performed on this drive.");
+
+	this->clear_fetched();  // clear everything fetched before, including outputs
+
+	std::string error_msg = this->fetch_data(smartctl_ex);
+	if (!error_msg.empty())
+		return error_msg;
+
 	return this->parse_data();
 }
 
@@ -312,16 +427,11 @@ std::string StorageDevice::parse_data()
 {
 	this->clear_fetched(false);  // clear everything fetched before, except outputs
 
-	AtaStorageAttribute::DiskType disk_type = AtaStorageAttribute::DiskType::Any;
-	if (hdd_.has_value()) {
-		disk_type = hdd_.value() ? AtaStorageAttribute::DiskType::Hdd : AtaStorageAttribute::DiskType::Ssd;
-	}
-
 	std::string error_msg;
 	auto parser_type = leaf::try_handle_some(
 		[this]() -> leaf::result<SmartctlParserType>
 		{
-			return SmartctlParser::detect_output_type(this->full_output_);
+			return SmartctlParser::detect_output_type(this->get_full_output());
 		},
 		[&error_msg](leaf::match<SmartctlParserError, SmartctlParserError::EmptyInput>) -> SmartctlParserType
 		{
@@ -341,24 +451,22 @@ std::string StorageDevice::parse_data()
 	auto parser = SmartctlParser::create(parser_type.value());
 	DBG_ASSERT_RETURN(parser, "Cannot create parser");
 
-	if (parser->parse_full(this->full_output_)) {  // try to parse it (parse only, set the properties after basic parsing).
+	if (parser->parse_full(this->get_full_output())) {  // try to parse it (parse only, set the properties after basic parsing).
 
-		// refresh basic info too
-		this->info_output_ = parser->get_data_full();  // put data including version information
+		// refresh basic info too. This shares the buffer, the full output includes version information.
+		this->info_output_ = this->full_output_;
+		this->info_output_read_time_ = this->full_output_read_time_;
 
-		// note: this will clear the non-basic properties!
-		// this will parse some info that is already parsed by SmartctlAtaTextParser::parse_full(),
-		// but this one sets the StorageDevice class members, not properties.
-		this->parse_basic_data(false, false);  // don't emit signal, we're not complete yet.
+		// Take the basic info from the parsed properties instead of scanning the output again.
+		this->set_basic_data_from_properties(parser->get_properties());
 
-		// Call this after parse_basic_data(), since it sets parse status to "info".
 		this->set_parse_status(StorageDevice::ParseStatus::full);
 
 		// set the full properties.
 		// copy to our drive, overwriting old data.
-		this->set_properties(StoragePropertyProcessor::process_properties(parser->get_properties(), disk_type));
+		this->set_properties(StoragePropertyProcessor::process_properties(parser->get_properties(), get_disk_type()));
 
-		signal_changed().emit(this);  // notify listeners
+		notify_changed(change_identity | change_properties);  // notify listeners
 
 		return {};
 	}
@@ -370,7 +478,8 @@ std::string StorageDevice::parse_data()
 
 	// proper parsing failed. try to at least extract info section
 	this->info_output_ = this->full_output_;  // complete output here. sometimes it's only the info section
-	if (!this->parse_basic_data(true).empty()) {  // will add some properties too. this will emit signal_changed().
+	this->info_output_read_time_ = this->full_output_read_time_;
+	if (!this->parse_basic_data(true).empty()) {  // will add some properties too. this will notify the listeners.
 		return parser->get_error_msg();  // return full parser's error messages - they are more detailed.
 	}
 
@@ -386,6 +495,58 @@ StorageDevice::ParseStatus StorageDevice::get_parse_status() const
 
 
 
+StorageDevicePtr StorageDevice::clone_for_parsing() const
+{
+	auto copy = (is_virtual_ ? std::make_shared<StorageDevice>(virtual_file_.u8string(), true)
+			: std::make_shared<StorageDevice>(device_, type_arg_));
+	copy->extra_args_ = extra_args_;
+	copy->drive_letters_ = drive_letters_;
+	copy->is_manually_added_ = is_manually_added_;
+	copy->detected_type_ = detected_type_;
+	copy->info_output_ = info_output_;  // immutable, may be shared between threads
+	copy->full_output_ = full_output_;
+	copy->cloned_info_output_ = info_output_;  // parsing replaces info_output_ of the copy
+	copy->cloned_full_output_ = full_output_;
+	copy->info_output_read_time_ = info_output_read_time_;
+	copy->full_output_read_time_ = full_output_read_time_;
+	return copy;
+}
+
+
+
+bool StorageDevice::take_parsed_data(StorageDevice& parsed)
+{
+	// The outputs are only replaced, never modified, so the buffer identity tells whether
+	// they were changed (and possibly parsed synchronously) since cloning.
+	if (info_output_ != parsed.cloned_info_output_ || full_output_ != parsed.cloned_full_output_) {
+		return false;
+	}
+
+	info_output_ = std::move(parsed.info_output_);
+	full_output_ = std::move(parsed.full_output_);
+	info_output_read_time_ = parsed.info_output_read_time_;  // parsing may replace the info output with the full one
+	parse_status_ = parsed.parse_status_;
+
+	// The test flag is not touched, a test may have been started while parsing.
+	detected_type_ = parsed.detected_type_;
+	smart_supported_ = parsed.smart_supported_;
+	smart_enabled_ = parsed.smart_enabled_;
+	aodc_status_ = parsed.aodc_status_;
+	model_name_ = std::move(parsed.model_name_);
+	family_name_ = std::move(parsed.family_name_);
+	serial_number_ = std::move(parsed.serial_number_);
+	size_ = std::move(parsed.size_);
+	hdd_ = parsed.hdd_;
+	health_property_ = std::move(parsed.health_property_);
+
+	properties_ = std::move(parsed.properties_);
+
+	notify_changed(change_identity | change_properties);  // notify listeners
+	return true;
+}
+
+
+
 std::string StorageDevice::set_smart_enabled(bool b, const std::shared_ptr<CommandExecutor>& smartctl_ex)
 {
 	if (this->test_is_active_)
@@ -406,8 +567,9 @@ SMART Disabled. Use option -s with argument 'on' to enable it.
 A mandatory SMART command failed: exiting. To continue, add one or more '-T permissive' options.
 */
 
-	std::string output;
-	std::string error_msg = execute_device_smartctl((b ? "--smart=on --saveauto=on" : "--smart=off"), smartctl_ex, output);
+	SharedOutput shared_output;
+	std::string error_msg = execute_device_smartctl((b ? "--smart=on --saveauto=on" : "--smart=off"), smartctl_ex, shared_output);
+	const std::string& output = shared_output_str(shared_output);
 	if (!error_msg.empty()) {
 		return error_msg;
 	}
@@ -443,8 +605,9 @@ SMART Automatic Offline Testing Disabled.
 --------------------------- OR ---------------------------
 A mandatory SMART command failed: exiting. To continue, add one or more '-T permissive' options.
 */
-	std::string output;
-	std::string error_msg = execute_device_smartctl((b ? "--offlineauto=on" : "--offlineauto=off"), smartctl_ex, output);
+	SharedOutput shared_output;
+	std::string error_msg = execute_device_smartctl((b ? "--offlineauto=on" : "--offlineauto=off"), smartctl_ex, shared_output);
+	const std::string& output = shared_output_str(shared_output);
 	if (!error_msg.empty())
 		return error_msg;
 
@@ -743,28 +906,59 @@ bool StorageDevice::get_is_hdd() const
 
 void StorageDevice::set_info_output(std::string s)
 {
-	info_output_ = std::move(s);
+	info_output_ = make_shared_output(std::move(s));
+	info_output_read_time_.reset();
 }
 
 
 
-std::string StorageDevice::get_info_output() const
+void StorageDevice::set_info_output(SharedOutput output, std::optional<std::chrono::system_clock::time_point> read_time)
+{
+	info_output_ = std::move(output);
+	info_output_read_time_ = read_time;
+}
+
+
+
+const std::string& StorageDevice::get_info_output() const
+{
+	return shared_output_str(info_output_);
+}
+
+
+
+SharedOutput StorageDevice::get_info_output_shared() const
 {
 	return info_output_;
 }
 
 
 
+std::optional<std::chrono::system_clock::time_point> StorageDevice::get_info_output_read_time() const
+{
+	return info_output_read_time_;
+}
+
+
+
 void StorageDevice::set_full_output(std::string s)
 {
-	full_output_ = std::move(s);
+	full_output_ = make_shared_output(std::move(s));
+	full_output_read_time_.reset();
 }
 
 
 
-std::string StorageDevice::get_full_output() const
+const std::string& StorageDevice::get_full_output() const
 {
-	return full_output_;
+	return shared_output_str(full_output_);
+}
+
+
+
+std::optional<std::chrono::system_clock::time_point> StorageDevice::get_full_output_read_time() const
+{
+	return full_output_read_time_;
 }
 
 
@@ -788,7 +982,7 @@ void StorageDevice::set_test_is_active(bool b)
 	bool changed = (test_is_active_ != b);
 	test_is_active_ = b;
 	if (changed) {
-		signal_changed().emit(this);  // so that everybody stops any test-aborting operations.
+		notify_changed(change_test_state);  // so that everybody stops any test-aborting operations.
 	}
 }
 
@@ -849,7 +1043,7 @@ std::string StorageDevice::get_device_options() const
 
 
 std::string StorageDevice::execute_device_smartctl(const std::string& command_options,
-		const std::shared_ptr<CommandExecutor>& smartctl_ex, std::string& smartctl_output, bool check_type)
+		const std::shared_ptr<CommandExecutor>& smartctl_ex, SharedOutput& smartctl_output, bool check_type)
 {
 	// don't forbid running on currently tested drive - we need to call this from the test code.
 
@@ -871,7 +1065,7 @@ std::string StorageDevice::execute_device_smartctl(const std::string& command_op
 		// and there is no information about the device manufacturer/etc... in the output.
 		// We detect this and set the device type to scsi to at least have _some_ info.
 		if (check_type && this->get_detected_type() == DetectedType::unknown
-				&& app_pcre_match("/specify device type with the -d option/mi", smartctl_output)) {
+				&& app_pcre_match("/specify device type with the -d option/mi", shared_output_str(smartctl_output))) {
 			this->set_detected_type(DetectedType::invalid);
 		}
 
@@ -883,7 +1077,7 @@ std::string StorageDevice::execute_device_smartctl(const std::string& command_op
 
 
 
-sigc::signal<void, StorageDevice*>& StorageDevice::signal_changed()
+sigc::signal<void, StorageDevice*, int>& StorageDevice::signal_changed()
 {
 	return signal_changed_;
 }
@@ -904,6 +1098,34 @@ void StorageDevice::set_properties(std::vector<AtaStorageProperty> props)
 
 
 
+void StorageDevice::notify_changed(int changes)
+{
+	// Nobody is listening, e.g. this is a copy being parsed in a worker thread.
+	// Don't touch the main loop then.
+	if (signal_changed_.empty())
+		return;
+
+	pending_changes_ |= changes;
+	if (!changed_idle_conn_.connected()) {
+		// High idle priority runs before GTK redraws, so the listeners' updates are
+		// drawn in the same frame.
+		changed_idle_conn_ = Glib::signal_idle().connect(sigc::mem_fun(*this, &StorageDevice::on_changed_idle),
+				Glib::PRIORITY_HIGH_IDLE);
+	}
+}
+
+
+
+bool StorageDevice::on_changed_idle()
+{
+	const int changes = pending_changes_;
+	pending_changes_ = 0;
+	signal_changed_.emit(this, changes);
+	return false;  // one-shot
+}
+
+
+
 
 
 
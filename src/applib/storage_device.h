@@ -16,12 +16,14 @@ Copyright:
 #include <map>
 #include <optional>
 #include <memory>
+#include <chrono>
 #include <sigc++/sigc++.h>
 
 #include "hz/fs_ns.h"
 #include "ata_storage_property.h"
 #include "smartctl_ata_text_parser.h"  // prop_list_t
 #include "smartctl_executor.h"
+#include "shared_output.h"
 
 
 
@@ -71,12 +73,23 @@ class StorageDevice {
 		};
 
 
+		/// Flags passed to signal_changed() listeners, telling what has changed
+		enum ChangeFlags {
+			change_identity = 1 << 0,  ///< Basic data: type, model, serial number, size, SMART status
+			change_properties = 1 << 1,  ///< Parsed properties (attributes, logs, etc...)
+			change_test_state = 1 << 2,  ///< "Test is active" flag
+		};
+
+
 		/// Constructor
 		explicit StorageDevice(std::string dev_or_vfile, bool is_virtual = false);
 
 		/// Constructor
 		StorageDevice(std::string dev, std::string type_arg);
 
+		/// Destructor, drops any pending change notification
+		~StorageDevice();
+
 
 		// clear everything fetched before.
 		void clear_fetched(bool including_outputs = true);
@@ -90,6 +103,11 @@ class StorageDevice {
 		/// Note: this will clear the non-basic properties!
 		std::string parse_basic_data(bool do_set_properties = true, bool emit_signal = true);
 
+		/// Execute smartctl --all (all sections) and store its output, without parsing it.
+		/// The previously parsed data is kept until parse_data() or take_parsed_data().
+		/// \return error message on error.
+		std::string fetch_data(const std::shared_ptr<CommandExecutor>& smartctl_ex);
+
 		/// Execute smartctl --all (all sections), get output, parse it (basic data too), fill properties.
 		std::string fetch_data_and_parse(const std::shared_ptr<CommandExecutor>& smartctl_ex);  // returns error message on error.
 
@@ -101,6 +119,20 @@ class StorageDevice {
 		ParseStatus get_parse_status() const;
 
 
+		/// Create a drive with the same identity (device, type, virtual file) and outputs,
+		/// but without the parsed data and without any signal connections. The copy
+		/// is independent of this object, so it may be parsed in another thread.
+		[[nodiscard]] StorageDevicePtr clone_for_parsing() const;
+
+		/// Replace the parsed data (outputs, basic data, properties) with the one of \c parsed,
+		/// a parsed clone_for_parsing() copy of this drive. The "test is active" flag is kept.
+		/// Listeners are notified of all the changes at once.
+		/// If the outputs of this drive were replaced after the copy was made, the copy is
+		/// outdated and nothing is changed.
+		/// \return false if the copy was outdated.
+		bool take_parsed_data(StorageDevice& parsed);
+
+
 		/// Try to enable SMART.
 		/// \return error message on error, empty string on success
 		std::string set_smart_enabled(bool b, const std::shared_ptr<CommandExecutor>&);
@@ -204,15 +236,31 @@ class StorageDevice {
 		/// Set "info" output to parse
 		void set_info_output(std::string s);
 
+		/// Set "info" output to parse, sharing the buffer. \c read_time is the time
+		/// it was read from the device, if it was (and not e.g. loaded from a file).
+		void set_info_output(SharedOutput output,
+				std::optional<std::chrono::system_clock::time_point> read_time = std::nullopt);
+
 		/// Get "info" output to parse
-		std::string get_info_output() const;
+		[[nodiscard]] const std::string& get_info_output() const;
+
+		/// Get "info" output to parse, as a shared buffer (may be null)
+		[[nodiscard]] SharedOutput get_info_output_shared() const;
+
+		/// Get the time the "info" output was read from the device.
+		/// \return std::nullopt if it wasn't (e.g. a virtual drive or a cached output).
+		[[nodiscard]] std::optional<std::chrono::system_clock::time_point> get_info_output_read_time() const;
 
 
 		/// Set "full" output to parse
 		void set_full_output(std::string s);
 
 		/// Get "full" output to parse
-		std::string get_full_output() const;
+		[[nodiscard]] const std::string& get_full_output() const;
+
+		/// Get the time the "full" output was read from the device.
+		/// \return std::nullopt if it wasn't (e.g. a virtual drive).
+		[[nodiscard]] std::optional<std::chrono::system_clock::time_point> get_full_output_read_time() const;
 
 
 		/// Set "manually added" flag
@@ -222,7 +270,7 @@ class StorageDevice {
 		bool get_is_manually_added() const;
 
 
-		/// Set "test is active" flag, emit the "changed" signal if needed.
+		/// Set "test is active" flag, notify the listeners if it changed.
 		void set_test_is_active(bool b);
 
 		/// Get "test is active" flag
@@ -240,11 +288,13 @@ class StorageDevice {
 		/// Execute smartctl on this device. Nothing is modified in this class.
 		/// \return error message on error, empty string on success
 		std::string execute_device_smartctl(const std::string& command_options,
-				const std::shared_ptr<CommandExecutor>& smartctl_ex, std::string& output, bool check_type = false);
+				const std::shared_ptr<CommandExecutor>& smartctl_ex, SharedOutput& output, bool check_type = false);
 
 
-		/// Emitted whenever new information is available
-		sigc::signal<void, StorageDevice*>& signal_changed();
+		/// Emitted whenever new information is available, with a combination of ChangeFlags.
+		/// Changes are coalesced: the signal is emitted once per main loop iteration
+		/// (before redrawing), no matter how many changes were made during it.
+		sigc::signal<void, StorageDevice*, int>& signal_changed();
 
 
 	protected:
@@ -258,8 +308,28 @@ class StorageDevice {
 
 	private:
 
-		std::string info_output_;  ///< "smartctl --info" output
-		std::string full_output_;  ///< "smartctl --all" output
+		/// Set the basic data (model, serial number, SMART support, etc...) from
+		/// the Info section properties of an already parsed output.
+		void set_basic_data_from_properties(const std::vector<AtaStorageProperty>& props);
+
+		/// Get the disk type for attribute processing, based on the rotation rate.
+		[[nodiscard]] AtaStorageAttribute::DiskType get_disk_type() const;
+
+		/// Remember the changes (ChangeFlags) and schedule signal_changed() emission
+		void notify_changed(int changes);
+
+		/// Idle callback, emits signal_changed() with the accumulated changes
+		bool on_changed_idle();
+
+
+		SharedOutput info_output_;  ///< "smartctl --info" output. May share the buffer with full_output_.
+		SharedOutput full_output_;  ///< "smartctl --all" output
+
+		std::optional<std::chrono::system_clock::time_point> info_output_read_time_;  ///< When info_output_ was read from the device
+		std::optional<std::chrono::system_clock::time_point> full_output_read_time_;  ///< When full_output_ was read from the device
+
+		SharedOutput cloned_info_output_;  ///< For clone_for_parsing() copies, info_output_ of the original at the time of cloning
+		SharedOutput cloned_full_output_;  ///< For clone_for_parsing() copies, full_output_ of the original at the time of cloning
 
 		std::string device_;  ///< e.g. /dev/sda or pd0. empty if virtual.
 		std::string type_arg_;  ///< Device type (for -d smartctl parameter), as specified when adding the device.
@@ -292,7 +362,10 @@ class StorageDevice {
 		std::vector<AtaStorageProperty> properties_;  ///< Smart properties. Detected through full output.
 
 		/// Emitted whenever new information is available
-		sigc::signal<void, StorageDevice*> signal_changed_;
+		sigc::signal<void, StorageDevice*, int> signal_changed_;
+
+		int pending_changes_ = 0;  ///< Changes (ChangeFlags) not yet reported through signal_changed_
+		sigc::connection changed_idle_conn_;  ///< Scheduled signal_changed_ emission
 
 
 };
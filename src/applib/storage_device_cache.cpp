@@ -0,0 +1,109 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <string>
+
+#include "json/json.hpp"
+#include "hz/debug.h"
+#include "hz/fs.h"
+
+#include "storage_device_cache.h"
+
+
+
+namespace {
+
+	/// Increase when the format changes. Files with other versions are ignored.
+	constexpr int device_cache_version = 1;
+
+}
+
+
+
+std::vector<StorageDevicePtr> storage_device_cache_load(const hz::fs::path& file)
+{
+	std::error_code ec;
+	if (!hz::fs::exists(file, ec)) {
+		return {};
+	}
+
+	std::string json_str;
+	ec = hz::fs_file_get_contents(file, json_str, 10*1024*1024);  // 10M
+	if (ec) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot read device cache file \"" << file.u8string() << "\": " << ec.message() << "\n");
+		return {};
+	}
+
+	std::vector<StorageDevicePtr> drives;
+	try {
+		const nlohmann::json root = nlohmann::json::parse(json_str);
+		if (root.value("version", 0) != device_cache_version) {
+			debug_out_info("app", DBG_FUNC_MSG << "Device cache file \"" << file.u8string() << "\" has a different version, ignoring.\n");
+			return {};
+		}
+
+		for (const auto& entry : root.at("drives")) {
+			auto drive = std::make_shared<StorageDevice>(entry.at("device").get<std::string>(), entry.at("type").get<std::string>());
+			drive->set_info_output(entry.at("info_output").get<std::string>());
+			if (!drive->parse_basic_data(true, false).empty()) {
+				continue;
+			}
+			drives.push_back(drive);
+		}
+	}
+	catch (nlohmann::json::exception& e) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot load device cache file \"" << file.u8string() << "\": " << e.what() << "\n");
+		return {};
+	}
+
+	debug_out_info("app", DBG_FUNC_MSG << "Loaded " << drives.size() << " drives from device cache.\n");
+	return drives;
+}
+
+
+
+std::error_code storage_device_cache_save(const hz::fs::path& file, const std::vector<StorageDevicePtr>& drives)
+{
+	nlohmann::json entries = nlohmann::json::array();
+	for (const auto& drive : drives) {
+		if (!drive || drive->get_is_virtual() || drive->get_is_manually_added() || drive->get_info_output().empty()) {
+			continue;
+		}
+		entries.push_back({
+			{"device", drive->get_device()},
+			{"type", drive->get_type_argument()},
+			{"serial", drive->get_serial_number()},  // informational
+			{"info_output", drive->get_info_output()},
+		});
+	}
+
+	const nlohmann::json root = {
+		{"version", device_cache_version},
+		{"drives", entries},
+	};
+
+	std::error_code ec;
+	hz::fs::create_directories(file.parent_path(), ec);  // ignore errors, writing will fail anyway
+
+	// Replace atomically, so that a crash doesn't leave a truncated cache.
+	ec = hz::fs_file_put_contents_atomic(file, root.dump(1, '\t'));
+	if (ec) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot save device cache file \"" << file.u8string() << "\": " << ec.message() << "\n");
+	}
+	return ec;
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,39 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef STORAGE_DEVICE_CACHE_H
+#define STORAGE_DEVICE_CACHE_H
+
+#include <vector>
+#include <system_error>
+
+#include "hz/fs_ns.h"
+#include "storage_device.h"
+
+
+
+/// Load the drives saved by storage_device_cache_save(). The drives have their
+/// basic data (model, serial number, SMART status, etc...) parsed from the
+/// cached "smartctl --info" output, so they may be shown before they are probed.
+/// \return an empty vector if the cache is missing or invalid.
+std::vector<StorageDevicePtr> storage_device_cache_load(const hz::fs::path& file);
+
+
+/// Save the basic data of the detected drives (virtual and manually added
+/// drives are skipped). The file is replaced atomically.
+std::error_code storage_device_cache_save(const hz::fs::path& file, const std::vector<StorageDevicePtr>& drives);
+
+
+
+
+#endif
+
+/// @}
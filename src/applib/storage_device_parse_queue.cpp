@@ -0,0 +1,162 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <algorithm>
+
+#include "hz/debug.h"
+#include "storage_device_parse_queue.h"
+
+
+
+StorageDeviceParseQueue::StorageDeviceParseQueue(unsigned int num_threads)
+		: num_threads_(num_threads == 0 ? std::clamp(std::thread::hardware_concurrency(), 1U, 4U) : num_threads)
+{
+	dispatcher_.connect(sigc::mem_fun(*this, &StorageDeviceParseQueue::on_dispatch));
+}
+
+
+
+StorageDeviceParseQueue::~StorageDeviceParseQueue()
+{
+	{
+		const std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+		pending_.clear();
+	}
+	cond_.notify_all();
+	for (auto& worker : workers_) {
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+}
+
+
+
+void StorageDeviceParseQueue::parse(const StorageDevicePtr& drive, ParsedSlot slot)
+{
+	DBG_ASSERT_RETURN_NONE(drive);
+
+	Job job;
+	job.id = next_id_++;
+	job.drive = drive;
+	job.copy = drive->clone_for_parsing();
+
+	latest_ids_[drive.get()] = job.id;  // supersedes the previous request
+	if (slot) {
+		slots_[job.id] = std::move(slot);
+	}
+
+	if (workers_.empty()) {
+		debug_out_dump("app", DBG_FUNC_MSG << "Starting " << num_threads_ << " parser threads.\n");
+		for (unsigned int i = 0; i < num_threads_; ++i) {
+			workers_.emplace_back(&StorageDeviceParseQueue::run_worker, this);
+		}
+	}
+
+	{
+		const std::lock_guard<std::mutex> lock(mutex_);
+		pending_.push_back(std::move(job));
+	}
+	cond_.notify_one();
+}
+
+
+
+bool StorageDeviceParseQueue::is_parsing(const StorageDevicePtr& drive) const
+{
+	return latest_ids_.find(drive.get()) != latest_ids_.end();
+}
+
+
+
+void StorageDeviceParseQueue::cancel_all()
+{
+	{
+		const std::lock_guard<std::mutex> lock(mutex_);
+		pending_.clear();
+	}
+	latest_ids_.clear();  // this discards the results of jobs in progress
+	slots_.clear();
+}
+
+
+
+void StorageDeviceParseQueue::run_worker()
+{
+	while (true) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			cond_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+			if (stopping_) {
+				break;
+			}
+			job = std::move(pending_.front());
+			pending_.pop_front();
+		}
+
+		// The copy is not shared with anything, and the outputs are immutable.
+		job.error_message = job.copy->parse_data();
+
+		{
+			const std::lock_guard<std::mutex> lock(mutex_);
+			done_.push_back(std::move(job));
+		}
+		dispatcher_.emit();
+	}
+}
+
+
+
+void StorageDeviceParseQueue::on_dispatch()
+{
+	std::vector<Job> done;
+	{
+		const std::lock_guard<std::mutex> lock(mutex_);
+		done.swap(done_);
+	}
+
+	for (auto& job : done) {
+		auto id_iter = latest_ids_.find(job.drive.get());
+		if (id_iter == latest_ids_.end() || id_iter->second != job.id) {
+			debug_out_dump("app", DBG_FUNC_MSG << "Discarding outdated parse result of " << job.drive->get_device_with_type() << ".\n");
+			slots_.erase(job.id);
+			continue;
+		}
+		latest_ids_.erase(id_iter);
+
+		ParsedSlot slot;
+		if (auto slot_iter = slots_.find(job.id); slot_iter != slots_.end()) {
+			slot = std::move(slot_iter->second);
+			slots_.erase(slot_iter);
+		}
+
+		// This notifies the drive's listeners. If the drive's outputs were replaced in the meantime
+		// (e.g. by a synchronous rescan), it already holds the newer data, which is kept.
+		const bool applied = job.drive->take_parsed_data(*job.copy);
+		if (!applied) {
+			debug_out_dump("app", DBG_FUNC_MSG << "Discarding parse result of " << job.drive->get_device_with_type()
+					<< ", its outputs were replaced while parsing.\n");
+			job.error_message.clear();
+		}
+		if (slot) {
+			slot(job.drive, job.error_message, applied);
+		}
+	}
+}
+
+
+
+
+
+
+/// @}
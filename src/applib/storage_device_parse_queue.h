@@ -0,0 +1,131 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef STORAGE_DEVICE_PARSE_QUEUE_H
+#define STORAGE_DEVICE_PARSE_QUEUE_H
+
+#include <glibmm.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+#include <sigc++/sigc++.h>
+
+#include "storage_device.h"
+
+
+
+/**
+Parses smartctl outputs of drives on worker threads, so that large outputs
+don't block the main loop.
+
+A copy of the drive (StorageDevice::clone_for_parsing()) is parsed by a worker.
+The result is delivered in the main loop through Glib::Dispatcher, where it
+replaces the drive's data in one step (StorageDevice::take_parsed_data()),
+and the drive's listeners are notified once.
+
+If a drive is queued again before its previous parsing completes, only the
+latest result is applied. A result is also dropped if the drive's outputs were
+replaced by other means (e.g. a synchronous parse) after it was queued.
+
+The object must be created and used in the main thread.
+*/
+class StorageDeviceParseQueue {
+	public:
+
+		/// Called in the main thread when a drive is parsed, with the parser's error message
+		/// (empty on success) and whether the result was applied. The drive data is replaced
+		/// in both error cases, just as StorageDevice::parse_data() does. If the drive's outputs
+		/// were replaced while parsing, the result is discarded and "applied" is false. The drive
+		/// keeps its newer data then, which is not necessarily fully parsed.
+		using ParsedSlot = sigc::slot<void, StorageDevicePtr, std::string, bool>;
+
+
+		/// Constructor. \c num_threads of 0 means the number of CPUs, up to 4.
+		/// The threads are started on first use.
+		explicit StorageDeviceParseQueue(unsigned int num_threads = 0);
+
+		/// Deleted
+		StorageDeviceParseQueue(const StorageDeviceParseQueue& other) = delete;
+
+		/// Deleted
+		StorageDeviceParseQueue(StorageDeviceParseQueue&& other) = delete;
+
+		/// Deleted
+		StorageDeviceParseQueue& operator=(const StorageDeviceParseQueue& other) = delete;
+
+		/// Deleted
+		StorageDeviceParseQueue& operator=(StorageDeviceParseQueue&& other) = delete;
+
+		/// Destructor, drops the pending requests and waits for the workers to exit.
+		~StorageDeviceParseQueue();
+
+
+		/// Parse the current outputs of \c drive (as set by StorageDevice::fetch_data() or
+		/// StorageDevice::set_full_output()) in a worker thread. \c slot is called when done.
+		void parse(const StorageDevicePtr& drive, ParsedSlot slot = ParsedSlot());
+
+
+		/// Check whether \c drive is queued or being parsed
+		[[nodiscard]] bool is_parsing(const StorageDevicePtr& drive) const;
+
+
+		/// Drop all the requests. The results of the ones already being parsed are discarded,
+		/// and no slots are called.
+		void cancel_all();
+
+
+	private:
+
+		/// A parsing request
+		struct Job {
+			std::uint64_t id = 0;  ///< Request ID
+			StorageDevicePtr drive;  ///< Drive to update, not touched by the workers
+			StorageDevicePtr copy;  ///< Copy of the drive parsed by a worker
+			std::string error_message;  ///< Parser error message
+		};
+
+
+		/// Worker thread function
+		void run_worker();
+
+		/// Dispatcher callback, applies the results in the main thread
+		void on_dispatch();
+
+
+		Glib::Dispatcher dispatcher_;  ///< Wakes up the main thread when results are available
+		unsigned int num_threads_ = 0;  ///< Number of worker threads to start
+		std::vector<std::thread> workers_;  ///< Worker threads
+
+		std::mutex mutex_;  ///< Protects pending_, done_ and stopping_
+		std::condition_variable cond_;  ///< Signalled when a job is added or the workers should exit
+		std::deque<Job> pending_;  ///< Jobs waiting for a worker
+		std::vector<Job> done_;  ///< Jobs not yet delivered to the main thread
+		bool stopping_ = false;  ///< Whether the workers should exit
+
+		std::uint64_t next_id_ = 1;  ///< ID of the next request (main thread only)
+		std::map<const StorageDevice*, std::uint64_t> latest_ids_;  ///< Latest request of each drive (main thread only)
+		std::map<std::uint64_t, ParsedSlot> slots_;  ///< Slots of requests, kept out of the workers' reach (main thread only)
+
+};
+
+
+
+
+
+
+#endif
+
+/// @}
@@ -0,0 +1,62 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2022 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+// Catch2 v3
+//#include "catch2/catch_test_macros.hpp"
+
+// Catch2 v2
+#include "catch2/catch.hpp"
+
+#include "applib/app_pcrecpp_pattern_set.h"
+
+
+
+TEST_CASE("AppPcrePatternSet", "[app][pcrecpp]")
+{
+	AppPcrePatternSet empty_set;
+	REQUIRE(empty_set.empty());
+	REQUIRE(!empty_set.match("/dev/sda"));
+	REQUIRE(!empty_set.find_match("/dev/sda").has_value());
+
+	const AppPcrePatternSet set({
+		"/d[a-z][0-9]+$/",
+		"/^/dev/LOOP[0-9]*$/i",
+		"/dm-[0-9]*$/",
+		"/^(sd)x\\1$/",  // backreference, matched separately
+		"/^nvme[0-9]+n[0-9]+p[0-9]+$/E",  // modifier without inline form, matched separately
+		"/[invalid/",  // ignored
+	});
+	REQUIRE(!set.empty());
+	REQUIRE(set.get_patterns().size() == 6);
+
+	REQUIRE(set.find_match("sda1") == 0u);
+	REQUIRE(set.find_match("/dev/loop3") == 1u);
+	REQUIRE(set.find_match("/dev/dm-0") == 2u);
+	REQUIRE(set.find_match("sdxsd") == 3u);
+	REQUIRE(set.find_match("nvme0n1p2") == 4u);
+
+	REQUIRE(!set.match("sda"));
+	REQUIRE(!set.match("/dev/sdb"));
+	REQUIRE(!set.match("nvme0n1"));
+	REQUIRE(!set.match("sdxsdx"));
+	REQUIRE(set.match("/dev/hdb2"));
+
+	AppPcrePatternSet invalid_set({"/[invalid/"});
+	REQUIRE(invalid_set.empty());
+	REQUIRE(!invalid_set.match("[invalid"));
+}
+
+
+
+
+
+
+/// @}
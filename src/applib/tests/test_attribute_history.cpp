@@ -0,0 +1,77 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2022 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+// Catch2 v3
+//#include "catch2/catch_test_macros.hpp"
+
+// Catch2 v2
+#include "catch2/catch.hpp"
+
+#include <cstdio>
+
+#include "hz/fs.h"
+#include "applib/attribute_history.h"
+#include "test_temp_dir.h"
+
+
+
+TEST_CASE("AttributeHistoryStore", "[app][history]")
+{
+	const TestTempDir temp_dir("attribute_history");
+	const hz::fs::path& dir = temp_dir.path();
+
+	AttributeHistoryStore store(dir);
+	REQUIRE(!store.append("S1", 1000, {{"attr/5/raw", 0}, {"temperature", 30}}));
+	REQUIRE(!store.append("S1", 1060, {{"attr/5/raw", 1}, {"temperature", 31}}));
+
+	// Going back in time is not allowed
+	REQUIRE(store.append("S1", 1000, {{"attr/5/raw", 1}}));
+
+	// A new column extends the file, missing values are marked as such
+	REQUIRE(!store.append("S1", 1120, {{"attr/5/raw", 2}, {"attr/9/raw", 77}}));
+	REQUIRE(!store.append("S1", 1180, {{"attr/5/raw", 3}}));
+
+	AttributeHistoryTable table;
+	REQUIRE(!store.read_range("S1", 1050, 1150, table));
+	REQUIRE(table.columns == std::vector<std::string>{"attr/5/raw", "temperature", "attr/9/raw"});
+	REQUIRE(table.times == std::vector<int64_t>{1060, 1120});
+	REQUIRE(table.values.at(0) == std::vector<int64_t>{1, 2});
+	REQUIRE(table.values.at(1) == std::vector<int64_t>{31, AttributeHistoryTable::missing_value});
+	REQUIRE(table.values.at(2) == std::vector<int64_t>{AttributeHistoryTable::missing_value, 77});
+	REQUIRE(table.find_column("attr/9/raw") == 2);
+	REQUIRE(!table.find_column("attr/1/raw").has_value());
+
+	REQUIRE(!store.read_range("S1", 0, 100000, table));
+	REQUIRE(table.times.size() == 4);
+
+	// A partial record left by a crash is dropped on next append
+	{
+		std::FILE* f = hz::fs_platform_fopen(store.get_file("S1"), "ab");
+		REQUIRE(f);
+		std::fputs("xyz", f);
+		std::fclose(f);
+	}
+	REQUIRE(!store.append("S1", 1240, {{"attr/5/raw", 4}}));
+	REQUIRE(!store.read_range("S1", 0, 100000, table));
+	REQUIRE(table.times.size() == 5);
+	REQUIRE(table.values.at(0).back() == 4);
+
+	// No history yet
+	REQUIRE(!store.read_range("S2", 0, 100000, table));
+	REQUIRE(table.times.empty());
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,119 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2022 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+// Catch2 v3
+//#include "catch2/catch_test_macros.hpp"
+
+// Catch2 v2
+#include "catch2/catch.hpp"
+
+#include "applib/attribute_trend.h"
+
+
+
+TEST_CASE("AttributeTrendTracker", "[app][history]")
+{
+	const int64_t day = 24 * 60 * 60;
+
+	const std::vector<AttributeTrendMetric> metrics = {
+		{"attr/5/raw", "Reallocated", 1, std::nullopt},
+		{"attr/231/norm", "Life Left", -1, 0},
+		{"attr/199/raw", "CRC", 1, std::nullopt},
+	};
+
+	AttributeTrendTracker tracker(metrics);
+	AttributeHistoryTable table;
+	table.columns = {"attr/5/raw", "attr/231/norm"};
+	table.values.resize(2);
+
+	// Reallocated sectors are stable for 10 days, then grow quickly. Life left decreases by 1 per day.
+	for (int64_t d = 0; d <= 14; ++d) {
+		const int64_t reallocated = (d <= 10 ? 0 : (d - 10) * 5);
+		tracker.add_sample(d * day, {{"attr/5/raw", reallocated}, {"attr/231/norm", 100 - d}});
+
+		table.times.push_back(d * day);
+		table.values[0].push_back(reallocated);
+		table.values[1].push_back(100 - d);
+	}
+
+	const auto& trends = tracker.get_trends();
+	REQUIRE(trends.size() == 3);
+
+	REQUIRE(trends[0].num_samples == 15);
+	REQUIRE(trends[0].total_change == 20);
+	REQUIRE(trends[0].accelerating);
+	REQUIRE(!trends[0].time_to_limit.has_value());
+	REQUIRE(trends[0].get_warning_level() == WarningLevel::warning);
+
+	REQUIRE(trends[1].total_change == 14);
+	REQUIRE(!trends[1].accelerating);
+	REQUIRE(trends[1].recent_rate_per_day == Approx(1.));
+	REQUIRE(trends[1].time_to_limit.has_value());
+	REQUIRE(trends[1].time_to_limit.value() == std::chrono::seconds(86 * day));  // 86 left, 1 per day
+	REQUIRE(trends[1].get_warning_level() == WarningLevel::warning);
+
+	REQUIRE(trends[2].num_samples == 0);
+	REQUIRE(trends[2].get_warning_level() == WarningLevel::none);
+
+	// Feeding the same samples from a history table gives the same result
+	AttributeTrendTracker table_tracker(metrics);
+	table_tracker.add_samples(table);
+	REQUIRE(table_tracker.get_trends()[0].recent_rate_per_day == Approx(trends[0].recent_rate_per_day));
+	REQUIRE(table_tracker.get_trends()[1].time_to_limit == trends[1].time_to_limit);
+
+	// Old samples are ignored
+	tracker.add_sample(0, {{"attr/5/raw", 1000}});
+	REQUIRE(tracker.get_trends()[0].total_change == 20);
+
+	// A counter which increased once, long ago, is only a notice
+	AttributeTrendTracker slow_tracker(metrics);
+	slow_tracker.add_sample(0, {{"attr/199/raw", 0}});
+	slow_tracker.add_sample(day, {{"attr/199/raw", 1}});
+	for (int64_t d = 2; d < 100; ++d) {
+		slow_tracker.add_sample(d * day, {{"attr/199/raw", 1}});
+	}
+	REQUIRE(!slow_tracker.get_trends()[2].accelerating);
+	REQUIRE(slow_tracker.get_trends()[2].get_warning_level() == WarningLevel::notice);
+}
+
+
+
+
+TEST_CASE("AttributeTrendTrackerCloseSamples", "[app][history]")
+{
+	const int64_t day = 24 * 60 * 60;
+	const std::vector<AttributeTrendMetric> metrics = {
+		{"attr/231/norm", "Life Left", -1, 0},
+	};
+
+	// A wear indicator ticks once between two reads minutes apart. That is not a rate.
+	AttributeTrendTracker tracker(metrics);
+	tracker.add_sample(0, {{"attr/231/norm", 90}});
+	tracker.add_sample(600, {{"attr/231/norm", 89}});
+	REQUIRE(tracker.get_trends()[0].num_samples == 2);
+	REQUIRE(tracker.get_trends()[0].total_change == 1);
+	REQUIRE(tracker.get_trends()[0].num_rates == 0);
+	REQUIRE(!tracker.get_trends()[0].time_to_limit.has_value());
+	REQUIRE(tracker.get_trends()[0].get_warning_level() == WarningLevel::none);
+
+	// The rate is measured from the first sample once a day has passed
+	tracker.add_sample(2 * day, {{"attr/231/norm", 89}});
+	REQUIRE(tracker.get_trends()[0].num_rates == 1);
+	REQUIRE(tracker.get_trends()[0].recent_rate_per_day == Approx(0.5));
+	REQUIRE(tracker.get_trends()[0].time_to_limit.value() == std::chrono::seconds(178 * day));  // 89 left, 0.5 per day
+}
+
+
+
+
+
+
+/// @}
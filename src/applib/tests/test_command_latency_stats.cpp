@@ -0,0 +1,123 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2022 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+// Catch2 v3
+//#include "catch2/catch_test_macros.hpp"
+
+// Catch2 v2
+#include "catch2/catch.hpp"
+
+#include "applib/command_latency_stats.h"
+
+
+
+using namespace std::chrono_literals;
+
+
+
+TEST_CASE("CommandLatencyStats", "[app][latency]")
+{
+	CommandLatencyStats stats;
+	REQUIRE(stats.get_sample_count() == 0);
+	REQUIRE(stats.get_percentile(95.) == 0ms);
+
+	SECTION("Average and percentiles") {
+		for (int i = 1; i <= 10; ++i) {
+			stats.add_sample(std::chrono::milliseconds(i * 100), false);
+		}
+		REQUIRE(stats.get_sample_count() == 10);
+		REQUIRE(stats.get_max() == 1000ms);
+		REQUIRE(stats.get_percentile(50.) == 500ms);
+		REQUIRE(stats.get_percentile(95.) == 1000ms);
+		REQUIRE(stats.get_percentile(0.) == 100ms);
+		REQUIRE(stats.get_average() > 500ms);  // recent samples weigh more
+		REQUIRE(stats.get_average() < 1000ms);
+	}
+
+	SECTION("Window") {
+		stats.add_sample(10s, false);
+		for (std::size_t i = 0; i < CommandLatencyStats::window_size; ++i) {
+			stats.add_sample(100ms, false);
+		}
+		REQUIRE(stats.get_percentile(100.) == 100ms);
+		REQUIRE(stats.get_max() == 10s);
+	}
+
+	SECTION("Timeouts") {
+		stats.add_sample(1s, true);
+		stats.add_sample(1s, true);
+		REQUIRE(stats.get_timeout_count() == 2);
+		REQUIRE(stats.get_consecutive_timeout_count() == 2);
+		stats.add_sample(1s, false);
+		REQUIRE(stats.get_timeout_count() == 2);
+		REQUIRE(stats.get_consecutive_timeout_count() == 0);
+	}
+}
+
+
+
+TEST_CASE("CommandLatencyTracker", "[app][latency]")
+{
+	CommandLatencyTracker tracker;
+	CommandLatencyTracker::Settings settings;
+	settings.min_term_timeout = 10s;
+	settings.max_term_timeout = 100s;
+	settings.kill_delay = 5s;
+	settings.slow_threshold = 5s;
+	settings.min_samples = 3;
+
+	SECTION("Not enough samples") {
+		tracker.add_sample("/dev/sda", "info", 100ms, false);
+		REQUIRE(tracker.get_stop_timeouts("/dev/sda", "info", settings) == std::pair(100000ms, 105000ms));
+		REQUIRE(tracker.get_stop_timeouts("/dev/sdb", "info", settings).first == 100s);
+		REQUIRE(tracker.get_stats("/dev/sdb", "info") == nullptr);
+	}
+
+	SECTION("Clamped timeouts") {
+		for (int i = 0; i < 3; ++i) {
+			tracker.add_sample("/dev/sda", "info", 100ms, false);
+			tracker.add_sample("/dev/sda", "full", 10s, false);
+			tracker.add_sample("/dev/sdb", "full", 100s, false);
+		}
+		REQUIRE(tracker.get_stop_timeouts("/dev/sda", "info", settings).first == 10s);
+		REQUIRE(tracker.get_stop_timeouts("/dev/sda", "full", settings).first == 60s);
+		REQUIRE(tracker.get_stop_timeouts("/dev/sda", "full", settings).second == 65s);
+		REQUIRE(tracker.get_stop_timeouts("/dev/sdb", "full", settings).first == 100s);
+	}
+
+	SECTION("Slow devices") {
+		for (int i = 0; i < 3; ++i) {
+			tracker.add_sample("/dev/sda", "info", 100ms, false);
+			tracker.add_sample("/dev/sdb", "info", 20s, false);
+		}
+		REQUIRE(!tracker.get_device_is_slow("/dev/sda", settings));
+		REQUIRE(tracker.get_device_is_slow("/dev/sdb", settings));
+
+		tracker.add_sample("/dev/sda", "full", 100s, true);
+		REQUIRE(!tracker.get_device_is_slow("/dev/sda", settings));
+		tracker.add_sample("/dev/sda", "full", 100s, true);
+		REQUIRE(tracker.get_device_is_slow("/dev/sda", settings));
+		// Don't shrink the timeout while the device keeps timing out
+		REQUIRE(tracker.get_stop_timeouts("/dev/sda", "full", settings).first == 100s);
+
+		REQUIRE(tracker.format_stats(settings).find("/dev/sdb [info]: samples 3") != std::string::npos);
+
+		tracker.clear();
+		REQUIRE(!tracker.get_device_is_slow("/dev/sdb", settings));
+	}
+}
+
+
+
+
+
+
+/// @}
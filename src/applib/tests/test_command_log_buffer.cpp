@@ -0,0 +1,106 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2022 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+// Catch2 v3
+//#include "catch2/catch_test_macros.hpp"
+
+// Catch2 v2
+#include "catch2/catch.hpp"
+
+#include <giomm/init.h>
+
+#include "applib/command_log_buffer.h"
+
+
+
+namespace {
+
+	CommandExecutorResult make_result(const std::string& parameters, const std::string& output)
+	{
+		return CommandExecutorResult("smartctl", parameters, make_shared_output(output),
+				make_shared_output(""), "", std::chrono::milliseconds(100));
+	}
+
+}
+
+
+
+TEST_CASE("CommandLogBuffer", "[app][executor]")
+{
+	Gio::init();
+
+	std::string output;
+	for (int i = 0; i < 2000; ++i) {
+		output += "ID# ATTRIBUTE_NAME          FLAG     VALUE WORST THRESH TYPE      UPDATED  WHEN_FAILED RAW_VALUE\n";
+	}
+
+	SECTION("Compression round trip") {
+		const std::string compressed = command_log_compress(output);
+		REQUIRE(compressed.size() < output.size() / 10);
+		REQUIRE(command_log_decompress(compressed) == output);
+		REQUIRE(command_log_decompress(command_log_compress("")).empty());
+	}
+
+	SECTION("Entries are numbered and decompressed on request") {
+		CommandLogBuffer buffer(1024 * 1024);
+		REQUIRE(buffer.get_first_number() == 0);
+		REQUIRE(buffer.add(make_result("-x /dev/sda", output)) == 1);
+		REQUIRE(buffer.add(make_result("-x /dev/sdb", "short")) == 2);
+		REQUIRE(buffer.get_memory_usage() < output.size());
+
+		auto entry = buffer.get(1);
+		REQUIRE(entry != nullptr);
+		REQUIRE(entry->parameters == "-x /dev/sda");
+		REQUIRE(*entry->std_output == output);
+		REQUIRE(entry->execution_time == std::chrono::milliseconds(100));
+		REQUIRE(*buffer.get(2)->std_output == "short");
+		REQUIRE(buffer.get(3) == nullptr);
+
+		auto entry_without_outputs = buffer.get(1, false);
+		REQUIRE(entry_without_outputs != nullptr);
+		REQUIRE(entry_without_outputs->parameters == "-x /dev/sda");
+		REQUIRE(entry_without_outputs->std_output->empty());
+	}
+
+	SECTION("Oldest entries are dropped when over the limit") {
+		CommandLogBuffer buffer(1024 * 1024);
+		for (int i = 0; i < 10; ++i) {
+			buffer.add(make_result(std::to_string(i), output + std::to_string(i)));
+		}
+		const std::size_t entry_size = buffer.get_memory_usage() / buffer.size();
+
+		buffer.set_max_bytes(entry_size * 3 + entry_size / 2);
+		REQUIRE(buffer.size() == 3);
+		REQUIRE(buffer.get_first_number() == 8);
+		REQUIRE(buffer.get_last_number() == 10);
+		REQUIRE(buffer.get(7) == nullptr);
+		REQUIRE(buffer.get(8)->parameters == "7");
+
+		// The newest entry is always kept
+		buffer.set_max_bytes(0);
+		REQUIRE(buffer.size() == 1);
+		REQUIRE(buffer.add(make_result("new", output)) == 11);
+		REQUIRE(buffer.size() == 1);
+		REQUIRE(buffer.get(11)->parameters == "new");
+
+		buffer.clear();
+		REQUIRE(buffer.size() == 0);
+		REQUIRE(buffer.get_memory_usage() == 0);
+		REQUIRE(buffer.add(make_result("", "")) == 1);
+	}
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,70 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2022 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+// Catch2 v3
+//#include "catch2/catch_test_macros.hpp"
+
+// Catch2 v2
+#include "catch2/catch.hpp"
+
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "hz/fs.h"
+#include "applib/directory_watcher.h"
+#include "test_temp_dir.h"
+
+
+
+#ifdef __linux__
+
+TEST_CASE("DirectoryWatcher", "[app][watch]")
+{
+	const TestTempDir temp_dir("directory_watcher");
+	const hz::fs::path& dir = temp_dir.path();
+
+	DirectoryWatcher watcher;
+	REQUIRE(!watcher.open(dir / "nonexistent"));
+	REQUIRE(watcher.open(dir));
+	REQUIRE(watcher.is_open());
+
+	std::vector<std::pair<std::string, hz::fs::path>> events;
+	watcher.signal_file_event().connect([&events](const std::string& action, const hz::fs::path& file) {
+		events.emplace_back(action, file);
+	});
+
+	// Written files are reported once they're closed, hidden ones are ignored.
+	REQUIRE(!hz::fs_file_put_contents(dir / "host1-sda.txt", "data"));
+	REQUIRE(!hz::fs_file_put_contents(dir / ".tmp", "data"));
+	hz::fs::rename(dir / ".tmp", dir / "host2-sda.txt");
+	hz::fs::remove(dir / "host1-sda.txt");
+	watcher.process_pending();
+
+	REQUIRE(events.size() == 3);
+	REQUIRE(events.at(0) == std::make_pair(std::string("changed"), dir / "host1-sda.txt"));
+	REQUIRE(events.at(1) == std::make_pair(std::string("changed"), dir / "host2-sda.txt"));
+	REQUIRE(events.at(2) == std::make_pair(std::string("removed"), dir / "host1-sda.txt"));
+
+	// Removing the directory stops the watch
+	hz::fs::remove_all(dir);
+	watcher.process_pending();
+	REQUIRE(!watcher.is_open());
+}
+
+#endif
+
+
+
+
+
+
+/// @}
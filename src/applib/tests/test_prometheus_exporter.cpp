@@ -0,0 +1,166 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2022 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+// Catch2 v3
+//#include "catch2/catch_test_macros.hpp"
+
+// Catch2 v2
+#include "catch2/catch.hpp"
+
+#include "applib/prometheus_exporter.h"
+
+
+
+TEST_CASE("PrometheusTextExporter", "[app][prometheus]")
+{
+	std::vector<AtaStorageProperty> props;
+	{
+		AtaStorageAttribute attr;
+		attr.id = 5;
+		attr.value = 100;
+		attr.worst = 99;
+		attr.threshold = 10;
+		attr.raw_value_int = 3;
+		AtaStorageProperty p;
+		p.set_name("Reallocated_Sector_Ct");
+		p.section = AtaStorageProperty::Section::data;
+		p.value = attr;
+		p.warning_level = WarningLevel::notice;
+		props.push_back(p);
+	}
+	{
+		AtaStorageProperty p;
+		p.set_name("Current Temperature", "ata_sct_status/temperature/current");
+		p.section = AtaStorageProperty::Section::data;
+		p.value = int64_t(41);
+		props.push_back(p);
+	}
+	{
+		AtaStorageProperty p;
+		p.set_name("Model", "model_name");
+		p.section = AtaStorageProperty::Section::info;
+		p.value = std::string("Some Model");
+		props.push_back(p);
+	}
+
+	PrometheusTextExporter exporter;
+	exporter.add_properties({{"device", "/dev/sda"}, {"model", "Quoted \"Model\""}}, props);
+	exporter.add_properties({{"device", "/dev/sdb"}}, {});
+	const std::string text = exporter.render();
+
+	const std::string labels = R"(device="/dev/sda",model="Quoted \"Model\"")";
+	REQUIRE(text.find("gsmartcontrol_attribute_value{" + labels + R"(,id="5",name="Reallocated_Sector_Ct"} 100)" "\n") != std::string::npos);
+	REQUIRE(text.find("gsmartcontrol_attribute_worst{" + labels + R"(,id="5",name="Reallocated_Sector_Ct"} 99)" "\n") != std::string::npos);
+	REQUIRE(text.find("gsmartcontrol_attribute_threshold{" + labels + R"(,id="5",name="Reallocated_Sector_Ct"} 10)" "\n") != std::string::npos);
+	REQUIRE(text.find("gsmartcontrol_attribute_raw{" + labels + R"(,id="5",name="Reallocated_Sector_Ct"} 3)" "\n") != std::string::npos);
+	REQUIRE(text.find("gsmartcontrol_temperature_celsius{" + labels + "} 41\n") != std::string::npos);
+	REQUIRE(text.find("gsmartcontrol_drive_warning_level{" + labels + "} 1\n") != std::string::npos);
+	REQUIRE(text.find("gsmartcontrol_drive_warning_level{device=\"/dev/sdb\"} 0\n") != std::string::npos);
+	REQUIRE(text.find("Some Model") == std::string::npos);
+
+	// Each family header is written once, even with several drives
+	const std::string header = "# TYPE gsmartcontrol_drive_warning_level gauge\n";
+	REQUIRE(text.find(header) != std::string::npos);
+	REQUIRE(text.find(header) == text.rfind(header));
+
+	REQUIRE(PrometheusTextExporter::escape_label_value("a\\b\"c\nd") == "a\\\\b\\\"c\\nd");
+}
+
+
+
+TEST_CASE("PrometheusTextExporterUniqueLabels", "[app][prometheus]")
+{
+	std::vector<AtaStorageProperty> props;
+	for (int64_t value : {1, 2}) {  // e.g. repeated log entries
+		AtaStorageProperty p;
+		p.set_name("Error Count", "ata_smart_error_log/count");
+		p.section = AtaStorageProperty::Section::data;
+		p.value = value;
+		p.warning_level = WarningLevel::warning;
+		props.push_back(p);
+	}
+	{
+		AtaStorageAttribute attr;
+		attr.id = 5;
+		attr.raw_value_int = 3;
+		AtaStorageProperty p;
+		p.set_name("Reallocated_Sector_Ct");
+		p.section = AtaStorageProperty::Section::data;
+		p.value = attr;
+		p.warning_level = WarningLevel::alert;
+		props.push_back(p);
+	}
+
+	PrometheusTextExporter exporter;
+	exporter.add_properties({{"device", "/dev/sda"}}, props);
+	const std::string text = exporter.render();
+
+	const std::string value_sample = R"(gsmartcontrol_property_value{device="/dev/sda",name="ata_smart_error_log/count"} )";
+	REQUIRE(text.find(value_sample + "1\n") != std::string::npos);
+	REQUIRE(text.find(value_sample) == text.rfind(value_sample));
+
+	const std::string warning_sample = R"(gsmartcontrol_property_warning_level{device="/dev/sda",name="ata_smart_error_log/count"} )";
+	REQUIRE(text.find(warning_sample) == text.rfind(warning_sample));
+
+	// Attribute warnings are identified by the attribute id
+	REQUIRE(text.find(R"(gsmartcontrol_property_warning_level{device="/dev/sda",id="5",name="Reallocated_Sector_Ct"} 3)" "\n") != std::string::npos);
+}
+
+
+
+TEST_CASE("PrometheusTextExporterLastFullData", "[app][prometheus]")
+{
+	// A drive parsed with the basic data only, e.g. by a rescan
+	StorageDevice drive("/dev/sda");
+	drive.set_parse_status(StorageDevice::ParseStatus::info);
+
+	PrometheusTextExporter::FullData full_data;
+	{
+		AtaStorageAttribute attr;
+		attr.id = 5;
+		attr.raw_value_int = 3;
+		AtaStorageProperty p;
+		p.set_name("Reallocated_Sector_Ct");
+		p.section = AtaStorageProperty::Section::data;
+		p.value = attr;
+		full_data.properties.push_back(p);
+	}
+	full_data.read_time = std::chrono::system_clock::time_point(std::chrono::seconds(1000));
+
+	{
+		PrometheusTextExporter exporter;
+		exporter.add_drive(drive, &full_data);
+		const std::string text = exporter.render();
+		REQUIRE(text.find(R"(id="5",name="Reallocated_Sector_Ct"} 3)" "\n") != std::string::npos);
+		REQUIRE(text.find("gsmartcontrol_last_read_timestamp_seconds{") != std::string::npos);
+		REQUIRE(text.find(R"(data="full"} 1000)" "\n") != std::string::npos);
+		REQUIRE(text.find(R"(data="info")") == std::string::npos);  // not read from the device
+	}
+
+	// Data of another drive is not used
+	full_data.serial_number = "OTHER";
+	{
+		PrometheusTextExporter exporter;
+		exporter.add_drive(drive, &full_data);
+		const std::string text = exporter.render();
+		REQUIRE(text.find("Reallocated_Sector_Ct") == std::string::npos);
+		REQUIRE(text.find("gsmartcontrol_last_read_timestamp_seconds") == std::string::npos);
+	}
+
+	REQUIRE(!PrometheusTextExporter::get_full_data(drive).has_value());
+}
+
+
+
+
+
+
+/// @}
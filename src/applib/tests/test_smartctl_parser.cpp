@@ -17,6 +17,7 @@ Copyright:
 
 #include "test_helpers/test_helpers.h"
 #include "applib/smartctl_parser.h"
+#include "applib/smartctl_text_parser_helper.h"
 
 
 
@@ -46,6 +47,75 @@ Copyright (C) 2002-20, Bruce Allen, Christian Franke, www.smartmontools.org
 
 
 
+TEST_CASE("SmartctlJsonParser", "[app][parser]")
+{
+	auto parser = SmartctlParser::create(SmartctlParserType::Json);
+	REQUIRE(parser != nullptr);
+
+	REQUIRE(parser->parse_full(R"({
+  "json_format_version": [1, 0],
+  "smartctl": {
+    "version": [7, 2],
+    "svn_revision": "5155",
+    "output": ["smartctl 7.2 2020-12-30 r5155", "Model Family:     Seagate Barracuda"]
+  },
+  "model_family": "Seagate Barracuda",
+  "ata_smart_attributes": {"table": [{"id": 1, "model_family": "not this one"}]}
+})"));
+
+	const auto& props = parser->get_properties();
+	REQUIRE(props.size() == 2);
+	REQUIRE(props.at(0).generic_name == "smartctl/version/_merged");
+	REQUIRE(props.at(0).reported_value == "7.2");
+	REQUIRE(props.at(1).generic_name == "model_family");
+	REQUIRE(props.at(1).reported_value == "Seagate Barracuda");
+
+	auto invalid_parser = SmartctlParser::create(SmartctlParserType::Json);
+	REQUIRE(!invalid_parser->parse_full(R"({"smartctl": {"version": [7, 2])"));
+	REQUIRE(!invalid_parser->parse_full(" "));
+}
+
+
+
+TEST_CASE("SmartctlTextTemperatureHistory", "[app][parser]")
+{
+	AtaStorageTemperatureHistory history;
+	REQUIRE(!SmartctlTextParserHelper::parse_temperature_history("SCT Commands not supported", history));
+
+	REQUIRE(SmartctlTextParserHelper::parse_temperature_history(R"(SCT Temperature History Version:     2
+Temperature Sampling Period:         1 minute
+Temperature Logging Interval:        10 minutes
+Temperature History Size (Index):    478 (361)
+
+Index    Estimated Time   Temperature Celsius
+ 362    2017-08-29 08:43    38  *******************
+ ...    ..(  3 skipped).    ..  *******************
+ 366    2017-08-29 09:23    39  ********************
+ 367    2017-08-29 09:33     ?  -
+ 368    2017-08-29 09:43    25  ******
+)", history));
+
+	REQUIRE(history.logging_interval == std::chrono::minutes(10));
+	REQUIRE(history.start_time != 0);
+	REQUIRE(history.get_sample_time(2) - history.start_time == 20 * 60);
+	REQUIRE(history.samples == std::vector<int8_t>{38, 38, 38, 38, 39, AtaStorageTemperatureHistory::unknown_temperature, 25});
+
+	const auto min_max = history.get_min_max();
+	REQUIRE(min_max.min == 25);
+	REQUIRE(min_max.max == 39);
+
+	// Spikes and dips are preserved, unknown samples are ignored
+	const auto buckets = history.downsample_min_max(3);
+	REQUIRE(buckets.size() == 3);
+	REQUIRE((buckets[0].min == 38 && buckets[0].max == 38));
+	REQUIRE((buckets[1].min == 38 && buckets[1].max == 39));
+	REQUIRE((buckets[2].min == 25 && buckets[2].max == 25));
+
+	REQUIRE(history.downsample_min_max(100).size() == history.samples.size());
+}
+
+
+
 /// @}
 
 
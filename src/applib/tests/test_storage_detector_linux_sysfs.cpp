@@ -0,0 +1,114 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2022 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+// Catch2 v3
+//#include "catch2/catch_test_macros.hpp"
+
+// Catch2 v2
+#include "catch2/catch.hpp"
+
+#include <string>
+
+#include "hz/fs.h"
+#include "applib/storage_detector_linux_sysfs.h"
+#include "test_temp_dir.h"
+
+
+
+namespace {
+
+	/// Create a file in a fake sysfs tree
+	void put_sysfs_file(const hz::fs::path& file, const std::string& contents)
+	{
+		hz::fs::create_directories(file.parent_path());
+		REQUIRE(!hz::fs_file_put_contents(file, contents));
+	}
+
+}
+
+
+
+TEST_CASE("LinuxSysfsClassifier", "[app][detector]")
+{
+	using Kind = LinuxSysfsBlockDeviceInfo::Kind;
+
+	const TestTempDir temp_dir("sysfs_class_block");
+	const hz::fs::path& root = temp_dir.path();
+
+	// ATA disk through libata
+	put_sysfs_file(root / "sda" / "device" / "type", "0\n");
+	put_sysfs_file(root / "sda" / "device" / "vendor", "ATA     \n");
+	put_sysfs_file(root / "sda" / "device" / "model", "ST31000340AS    \n");
+	put_sysfs_file(root / "sda" / "queue" / "rotational", "1\n");
+	put_sysfs_file(root / "sda" / "removable", "0\n");
+	// its partition
+	put_sysfs_file(root / "sda1" / "partition", "1\n");
+	// CD/DVD
+	put_sysfs_file(root / "sr0" / "device" / "type", "5\n");
+	put_sysfs_file(root / "sr0" / "removable", "1\n");
+	// 3ware controller
+	put_sysfs_file(root / "sdb" / "device" / "type", "0\n");
+	put_sysfs_file(root / "sdb" / "device" / "vendor", "AMCC\n");
+	// Enclosure
+	put_sysfs_file(root / "sdc" / "device" / "type", "13\n");
+	// NVMe
+	put_sysfs_file(root / "nvme0n1" / "device" / "serial", "S4EWNX0N\n");
+	put_sysfs_file(root / "nvme0n1" / "queue" / "rotational", "0\n");
+	put_sysfs_file(root / "nvme0c0n1" / "device" / "serial", "S4EWNX0N\n");
+	// Device mapper and other virtual devices
+	put_sysfs_file(root / "dm-0" / "dm" / "name", "root\n");
+	put_sysfs_file(root / "vg-lv" / "slaves" / "sda1", "");
+	put_sysfs_file(root / "zram0" / "size", "0\n");
+	put_sysfs_file(root / "foo0" / "size", "0\n");
+
+	auto sda = linux_sysfs_classify_block_device(root, "sda");
+	REQUIRE(sda.kind == Kind::disk);
+	REQUIRE(sda.needs_probe());
+	REQUIRE(sda.vendor == "ATA");
+	REQUIRE(sda.model == "ST31000340AS");
+	REQUIRE(sda.rotational == true);
+	REQUIRE(!sda.removable);
+	REQUIRE(sda.type_hint == "sat");
+
+	REQUIRE(linux_sysfs_classify_block_device(root, "sda1").kind == Kind::partition);
+
+	auto sr0 = linux_sysfs_classify_block_device(root, "sr0");
+	REQUIRE(sr0.kind == Kind::cddvd);
+	REQUIRE(sr0.removable);
+	REQUIRE(sr0.needs_probe());
+
+	REQUIRE(linux_sysfs_classify_block_device(root, "sdb").kind == Kind::controller);
+	REQUIRE(!linux_sysfs_classify_block_device(root, "sdb").needs_probe());
+	REQUIRE(linux_sysfs_classify_block_device(root, "sdc").kind == Kind::other);
+
+	auto nvme = linux_sysfs_classify_block_device(root, "nvme0n1");
+	REQUIRE(nvme.kind == Kind::disk);
+	REQUIRE(nvme.type_hint == "nvme");
+	REQUIRE(nvme.rotational == false);
+	REQUIRE(linux_sysfs_classify_block_device(root, "nvme0c0n1").kind == Kind::other);
+
+	REQUIRE(linux_sysfs_classify_block_device(root, "dm-0").kind == Kind::virtual_device);
+	REQUIRE(linux_sysfs_classify_block_device(root, "vg-lv").kind == Kind::virtual_device);
+	REQUIRE(linux_sysfs_classify_block_device(root, "zram0").kind == Kind::virtual_device);
+	REQUIRE(linux_sysfs_classify_block_device(root, "foo0").kind == Kind::virtual_device);
+
+	// No information, must be probed
+	REQUIRE(linux_sysfs_classify_block_device(root, "sdz").kind == Kind::unknown);
+	REQUIRE(linux_sysfs_classify_block_device(root, "sdz").needs_probe());
+	REQUIRE(linux_sysfs_classify_block_device(hz::fs::path(), "sda").kind == Kind::unknown);
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,97 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2022 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+// Catch2 v3
+//#include "catch2/catch_test_macros.hpp"
+
+// Catch2 v2
+#include "catch2/catch.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "applib/storage_detector_scan_open.h"
+
+
+
+TEST_CASE("SmartctlScanOpenParser", "[app][detector]")
+{
+	const std::string output = R"({
+  "json_format_version": [1, 0],
+  "smartctl": {"version": [7, 2], "exit_status": 0},
+  "devices": [
+    {"name": "/dev/sda", "info_name": "/dev/sda [SAT]", "type": "sat", "protocol": "ATA"},
+    {"name": "/dev/twa0", "info_name": "/dev/twa0 [3ware_disk_00]", "type": "3ware,0", "protocol": "ATA"},
+    {"name": "/dev/twa0", "info_name": "/dev/twa0 [3ware_disk_01]", "type": "3ware,1", "protocol": "ATA",
+      "open_error": "No such device or address"},
+    {"name": "/dev/nvme0", "info_name": "/dev/nvme0", "type": "nvme", "protocol": "NVMe"}
+  ]
+})";
+
+	std::vector<SmartctlScanOpenEntry> entries;
+	REQUIRE(smartctl_scan_open_parse_json(output, entries).empty());
+	REQUIRE(entries.size() == 3);
+	REQUIRE(entries.at(0).device == "/dev/sda");
+	REQUIRE(entries.at(0).type == "sat");
+	REQUIRE(entries.at(1).device == "/dev/twa0");
+	REQUIRE(entries.at(1).type == "3ware,0");
+	REQUIRE(entries.at(2).protocol == "NVMe");
+
+	std::vector<SmartctlScanOpenEntry> bad_entries;
+	REQUIRE(!smartctl_scan_open_parse_json("/dev/sda -d sat # /dev/sda, ATA device", bad_entries).empty());
+	REQUIRE(!smartctl_scan_open_parse_json(R"({"smartctl": {}})", bad_entries).empty());
+	REQUIRE(bad_entries.empty());
+}
+
+
+
+TEST_CASE("SmartctlScanOpenDrives", "[app][detector]")
+{
+	const std::vector<SmartctlScanOpenEntry> entries = {
+		{"/dev/sda", "sat", "ATA"},
+		{"/dev/sdb", "sat", "ATA"},
+		{"/dev/twa0", "3ware,0", "ATA"},
+		{"/dev/nvme0", "nvme", "NVMe"},
+		{"/dev/bus/0", "megaraid,0", "SCSI"},
+		{"/dev/bus/0", "megaraid,1", "SCSI"},
+	};
+
+	// Found through the partitions file
+	std::vector<StorageDevicePtr> drives = {
+		std::make_shared<StorageDevice>("/dev/sda"),
+		std::make_shared<StorageDevice>("/dev/nvme0n1"),
+	};
+
+	REQUIRE(smartctl_scan_open_add_drives(entries, "3ware,", drives) == 1);
+	REQUIRE(drives.size() == 3);
+	REQUIRE(drives.at(2)->get_type_argument() == "3ware,0");
+
+	// The filter applies to plain devices only, not to the controller ports.
+	const auto reject_all = [](const std::string& /*device*/) { return false; };
+	REQUIRE(smartctl_scan_open_add_remaining_drives(entries, drives, reject_all) == 2);
+	REQUIRE(drives.size() == 5);
+	REQUIRE(drives.at(3)->get_type_argument() == "megaraid,0");
+	REQUIRE(drives.at(4)->get_type_argument() == "megaraid,1");
+
+	REQUIRE(smartctl_scan_open_add_remaining_drives(entries, drives) == 1);
+	REQUIRE(drives.size() == 6);
+	REQUIRE(drives.at(5)->get_device() == "/dev/sdb");
+
+	REQUIRE(smartctl_scan_open_add_remaining_drives(entries, drives) == 0);
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,121 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2022 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+// Catch2 v3
+//#include "catch2/catch_test_macros.hpp"
+
+// Catch2 v2
+#include "catch2/catch.hpp"
+
+#include <glibmm.h>
+#include <memory>
+#include <string>
+
+#include "applib/storage_device_parse_queue.h"
+
+
+
+namespace {
+
+	std::string make_output(const std::string& model)
+	{
+		return "smartctl 7.2 2020-12-30 r5155 [x86_64-linux-5.3.18] (local build)\n"
+				"Copyright (C) 2002-20, Bruce Allen, Christian Franke, www.smartmontools.org\n\n"
+				"=== START OF INFORMATION SECTION ===\n"
+				"Device Model:     " + model + "\n"
+				"Serial Number:    TEST1234\n";
+	}
+
+}
+
+
+
+TEST_CASE("StorageDeviceParseQueue", "[app][parser]")
+{
+	auto main_loop = Glib::MainLoop::create();
+	StorageDeviceParseQueue queue(2);
+
+	auto drive = std::make_shared<StorageDevice>("virtual.txt", true);
+	// The change notification comes from the main loop, after the parse callback.
+	int num_changed = 0;
+	drive->signal_changed().connect([&num_changed, &main_loop](StorageDevice*, int changes) {
+		++num_changed;
+		REQUIRE(changes == (StorageDevice::change_identity | StorageDevice::change_properties));
+		main_loop->quit();
+	});
+
+	// The second request supersedes the first one, only its result is applied.
+	int num_parsed = 0;
+	drive->set_full_output(make_output("OLD MODEL"));
+	queue.parse(drive, [&num_parsed](const StorageDevicePtr&, const std::string&, bool) { ++num_parsed; });
+	drive->set_full_output(make_output("NEW MODEL"));
+	queue.parse(drive, [&num_parsed, &num_changed](const StorageDevicePtr&, const std::string&, bool applied) {
+		++num_parsed;
+		REQUIRE(applied);
+		REQUIRE(num_changed == 0);
+	});
+	REQUIRE(queue.is_parsing(drive));
+	REQUIRE(drive->get_model_name().empty());  // not touched until parsed
+
+	auto timeout_conn = Glib::signal_timeout().connect_seconds([main_loop]() {
+		main_loop->quit();
+		return false;
+	}, 10);
+	main_loop->run();
+	timeout_conn.disconnect();
+
+	REQUIRE(!queue.is_parsing(drive));
+	REQUIRE(num_parsed == 1);
+	REQUIRE(num_changed == 1);
+	REQUIRE(drive->get_model_name() == "NEW MODEL");
+	REQUIRE(drive->get_serial_number() == "TEST1234");
+}
+
+
+
+TEST_CASE("StorageDeviceParseQueueOutdated", "[app][parser]")
+{
+	auto main_loop = Glib::MainLoop::create();
+	StorageDeviceParseQueue queue(1);
+
+	auto drive = std::make_shared<StorageDevice>("virtual.txt", true);
+	drive->set_full_output(make_output("OLD MODEL"));
+	bool delivered = false;
+	queue.parse(drive, [&main_loop, &delivered](const StorageDevicePtr&, const std::string& error_msg, bool applied) {
+		REQUIRE(error_msg.empty());
+		REQUIRE(!applied);
+		delivered = true;
+		main_loop->quit();
+	});
+
+	// The drive is updated synchronously before the result is delivered, the result is discarded.
+	drive->set_info_output(make_output("NEW MODEL"));
+	drive->parse_basic_data();
+	REQUIRE(drive->get_model_name() == "NEW MODEL");
+
+	auto timeout_conn = Glib::signal_timeout().connect_seconds([main_loop]() {
+		main_loop->quit();
+		return false;
+	}, 10);
+	main_loop->run();
+	timeout_conn.disconnect();
+
+	REQUIRE(!queue.is_parsing(drive));
+	REQUIRE(delivered);
+	REQUIRE(drive->get_model_name() == "NEW MODEL");
+}
+
+
+
+
+
+
+/// @}
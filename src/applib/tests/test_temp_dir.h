@@ -0,0 +1,77 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2022 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+#ifndef TEST_TEMP_DIR_H
+#define TEST_TEMP_DIR_H
+
+#include <string>
+#include <system_error>
+
+#include "hz/fs.h"
+
+
+
+/// A temporary directory for a test case, "gsc_test_<name>" in the system temporary
+/// directory. It's created empty (a leftover from a crashed run is removed first),
+/// and is removed with all its contents on destruction.
+class TestTempDir {
+	public:
+
+		/// Constructor
+		explicit TestTempDir(const std::string& name)
+				: path_(hz::fs::temp_directory_path() / ("gsc_test_" + name))
+		{
+			std::error_code ec;
+			hz::fs::remove_all(path_, ec);
+			hz::fs::create_directories(path_);
+		}
+
+		/// Deleted
+		TestTempDir(const TestTempDir& other) = delete;
+
+		/// Deleted
+		TestTempDir(TestTempDir&& other) = delete;
+
+		/// Deleted
+		TestTempDir& operator=(const TestTempDir& other) = delete;
+
+		/// Deleted
+		TestTempDir& operator=(TestTempDir&& other) = delete;
+
+		/// Destructor, removes the directory
+		~TestTempDir()
+		{
+			std::error_code ec;
+			hz::fs::remove_all(path_, ec);
+		}
+
+
+		/// Get the directory path
+		[[nodiscard]] const hz::fs::path& path() const
+		{
+			return path_;
+		}
+
+
+	private:
+
+		hz::fs::path path_;  ///< Directory path
+
+};
+
+
+
+
+
+
+#endif
+
+/// @}
@@ -0,0 +1,112 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2022 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+// Catch2 v3
+//#include "catch2/catch_test_macros.hpp"
+
+// Catch2 v2
+#include "catch2/catch.hpp"
+
+#include <string>
+#include <vector>
+#include <utility>
+#ifndef _WIN32
+	#include <sys/socket.h>
+	#include <unistd.h>  // close()
+#endif
+
+#include "applib/uevent_monitor.h"
+
+
+
+using namespace std::string_literals;
+
+
+
+TEST_CASE("UeventParser", "[app][uevent]")
+{
+	SECTION("Kernel message") {
+		const std::string data = "add@/devices/pci0000:00/0000:00:17.0/ata3/host2/target2:0:0/2:0:0:0/block/sdb\0"
+				"ACTION=add\0DEVPATH=/devices/pci0000:00/0000:00:17.0/ata3/host2/target2:0:0/2:0:0:0/block/sdb\0"
+				"SUBSYSTEM=block\0MAJOR=8\0MINOR=16\0DEVNAME=sdb\0DEVTYPE=disk\0SEQNUM=4242\0"s;
+		auto msg = parse_uevent_message(data);
+		REQUIRE(msg.has_value());
+		REQUIRE(msg->action == "add");
+		REQUIRE(msg->devpath == "/devices/pci0000:00/0000:00:17.0/ata3/host2/target2:0:0/2:0:0:0/block/sdb");
+		REQUIRE(msg->subsystem == "block");
+		REQUIRE(msg->devname == "sdb");
+		REQUIRE(msg->devtype == "disk");
+		REQUIRE(msg->properties.at("SEQNUM") == "4242");
+	}
+
+	SECTION("Without trailing NUL") {
+		auto msg = parse_uevent_message("remove@/devices/virtual/block/loop0\0ACTION=remove\0DEVNAME=loop0"s);
+		REQUIRE(msg.has_value());
+		REQUIRE(msg->action == "remove");
+		REQUIRE(msg->devname == "loop0");
+	}
+
+	SECTION("Invalid messages") {
+		REQUIRE(!parse_uevent_message("").has_value());
+		REQUIRE(!parse_uevent_message("libudev\0\xfe\xed\xca\xfe"s).has_value());
+		REQUIRE(!parse_uevent_message("add@/devices/x\0ACTION=remove\0"s).has_value());
+	}
+}
+
+
+
+#ifndef _WIN32
+
+TEST_CASE("UeventMonitor", "[app][uevent]")
+{
+	// A local socket stands in for the netlink one
+	int fds[2] = {-1, -1};
+	REQUIRE(socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, fds) == 0);
+
+	UeventMonitor monitor;
+	REQUIRE(monitor.open_fd(fds[0]));
+	REQUIRE(monitor.is_open());
+
+	std::vector<std::pair<std::string, std::string>> events;
+	monitor.signal_block_device_event().connect([&events](const std::string& action, const std::string& device) {
+		events.emplace_back(action, device);
+	});
+
+	const std::vector<std::string> messages = {
+		"add@/devices/x/block/sdc\0ACTION=add\0SUBSYSTEM=block\0DEVNAME=sdc\0DEVTYPE=disk\0"s,
+		"add@/devices/x/block/sdc/sdc1\0ACTION=add\0SUBSYSTEM=block\0DEVNAME=sdc1\0DEVTYPE=partition\0"s,
+		"change@/devices/x/block/sdc\0ACTION=change\0SUBSYSTEM=block\0DEVNAME=sdc\0DEVTYPE=disk\0"s,
+		"add@/devices/x/usb1\0ACTION=add\0SUBSYSTEM=usb\0DEVNAME=bus/usb/001/002\0DEVTYPE=usb_device\0"s,
+		"remove@/devices/x/block/sdb\0ACTION=remove\0SUBSYSTEM=block\0DEVNAME=sdb\0DEVTYPE=disk\0"s,
+	};
+	for (const auto& message : messages) {
+		REQUIRE(send(fds[1], message.data(), message.size(), 0) == static_cast<ssize_t>(message.size()));
+	}
+
+	monitor.process_pending();
+
+	REQUIRE(events.size() == 2);
+	REQUIRE(events.at(0) == std::pair("add"s, "/dev/sdc"s));
+	REQUIRE(events.at(1) == std::pair("remove"s, "/dev/sdb"s));
+
+	monitor.close();
+	REQUIRE(!monitor.is_open());
+	::close(fds[1]);
+}
+
+#endif
+
+
+
+
+
+
+/// @}
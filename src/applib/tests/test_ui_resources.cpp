@@ -0,0 +1,41 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2022 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+// Catch2 v3
+//#include "catch2/catch_test_macros.hpp"
+
+// Catch2 v2
+#include "catch2/catch.hpp"
+
+#include <string>
+
+#include "applib/app_builder_widget.h"
+
+
+
+/// The UI files must be compiled in and registered (see src/ui/CMakeLists.txt),
+/// otherwise AppBuilderWidget::create() silently falls back to the "ui" data directory.
+TEST_CASE("UiResources", "[app][ui]")
+{
+	for (const char* name : {"gsc_main_window", "gsc_info_window", "gsc_preferences_window"}) {
+		const std::string resource_path = std::string(app_builder_resource_prefix) + name + ".glade";
+		gsize size = 0;
+		REQUIRE(g_resources_get_info(resource_path.c_str(), G_RESOURCE_LOOKUP_FLAGS_NONE, &size, nullptr, nullptr));
+		REQUIRE(size > 0);
+	}
+}
+
+
+
+
+
+
+/// @}
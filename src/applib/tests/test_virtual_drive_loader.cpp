@@ -0,0 +1,64 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2022 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+// Catch2 v3
+//#include "catch2/catch_test_macros.hpp"
+
+// Catch2 v2
+#include "catch2/catch.hpp"
+
+#include <string>
+#include <vector>
+
+#include "hz/fs.h"
+#include "applib/virtual_drive_loader.h"
+#include "test_temp_dir.h"
+
+
+
+TEST_CASE("VirtualDriveLoaderPaths", "[app][virtual]")
+{
+	const TestTempDir temp_dir("virtual_drive_loader");
+	const hz::fs::path& dir = temp_dir.path();
+	hz::fs::create_directories(dir / "sub");
+
+	REQUIRE(!hz::fs_file_put_contents(dir / "host1-sda.txt", "smartctl output 1"));
+	REQUIRE(!hz::fs_file_put_contents(dir / "host2-sda.txt", "smartctl output 2"));
+	REQUIRE(!hz::fs_file_put_contents(dir / "notes.log", ""));
+	REQUIRE(!hz::fs_file_put_contents(dir / ".hidden.txt", "x"));
+	REQUIRE(!hz::fs_file_put_contents(dir / "sub" / "host3-sda.txt", "x"));
+
+	SECTION("Directories") {
+		// Non-recursive, hidden files are skipped
+		auto files = virtual_drive_expand_paths({dir.u8string()});
+		REQUIRE(files == std::vector<hz::fs::path>{dir / "host1-sda.txt", dir / "host2-sda.txt", dir / "notes.log"});
+	}
+
+	SECTION("Wildcards and duplicates") {
+		auto files = virtual_drive_expand_paths({(dir / "host*.txt").u8string(), (dir / "host1-sda.txt").u8string(),
+				(dir / "missing.txt").u8string(), ""});
+		REQUIRE(files == std::vector<hz::fs::path>{dir / "host1-sda.txt", dir / "host2-sda.txt", dir / "missing.txt"});
+	}
+
+	SECTION("Loading errors") {
+		StorageDevicePtr drive;
+		REQUIRE(!virtual_drive_load(dir / "missing.txt", drive).empty());
+		REQUIRE(!virtual_drive_load(dir / "notes.log", drive).empty());  // empty file
+		REQUIRE(drive == nullptr);
+	}
+}
+
+
+
+
+
+
+/// @}
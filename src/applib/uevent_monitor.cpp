@@ -0,0 +1,253 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <glib.h>
+#include <array>
+#include <cerrno>
+
+#ifndef _WIN32
+	#include <glib-unix.h>  // g_unix_fd_add_full()
+	#include <unistd.h>  // close()
+	#include <sys/types.h>
+	#include <sys/socket.h>
+#endif
+#ifdef __linux__
+	#include <linux/netlink.h>
+#endif
+
+#include "hz/debug.h"
+#include "hz/string_algo.h"
+
+#include "uevent_monitor.h"
+
+
+
+
+// this is needed because these callbacks are called by glib.
+extern "C" {
+
+	/// Uevent socket handler callback
+	inline gboolean uevent_monitor_on_socket_ready(gint fd, GIOCondition cond, gpointer data)
+	{
+		return UeventMonitor::on_socket_ready(fd, cond, static_cast<UeventMonitor*>(data));
+	}
+
+}
+
+
+
+std::optional<UeventMessage> parse_uevent_message(std::string_view data)
+{
+	// The header is "action@devpath", followed by NUL-separated KEY=VALUE pairs.
+	const std::string_view::size_type header_end = data.find('\0');
+	const std::string_view header = data.substr(0, header_end);
+	const std::string_view::size_type at_pos = header.find('@');
+	if (at_pos == std::string_view::npos || at_pos == 0) {
+		return std::nullopt;  // not a kernel message (e.g. "libudev")
+	}
+
+	UeventMessage msg;
+	msg.action = std::string(header.substr(0, at_pos));
+	msg.devpath = std::string(header.substr(at_pos + 1));
+
+	std::string_view::size_type pos = (header_end == std::string_view::npos ? data.size() : header_end + 1);
+	while (pos < data.size()) {
+		std::string_view::size_type end = data.find('\0', pos);
+		if (end == std::string_view::npos) {
+			end = data.size();
+		}
+		const std::string_view pair = data.substr(pos, end - pos);
+		if (const auto eq_pos = pair.find('='); eq_pos != std::string_view::npos && eq_pos != 0) {
+			msg.properties[std::string(pair.substr(0, eq_pos))] = std::string(pair.substr(eq_pos + 1));
+		}
+		pos = end + 1;
+	}
+
+	if (auto iter = msg.properties.find("ACTION"); iter != msg.properties.end() && iter->second != msg.action) {
+		return std::nullopt;  // inconsistent
+	}
+	if (auto iter = msg.properties.find("SUBSYSTEM"); iter != msg.properties.end()) {
+		msg.subsystem = iter->second;
+	}
+	if (auto iter = msg.properties.find("DEVNAME"); iter != msg.properties.end()) {
+		msg.devname = iter->second;
+	}
+	if (auto iter = msg.properties.find("DEVTYPE"); iter != msg.properties.end()) {
+		msg.devtype = iter->second;
+	}
+
+	return msg;
+}
+
+
+
+
+UeventMonitor::~UeventMonitor()
+{
+	close();
+}
+
+
+
+bool UeventMonitor::open()
+{
+#if defined __linux__
+	const int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+	if (fd == -1) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot open uevent socket: " << hz::string_trim_copy(g_strerror(errno)) << "\n");
+		return false;
+	}
+
+	sockaddr_nl addr = { };
+	addr.nl_family = AF_NETLINK;
+	addr.nl_pid = 0;  // let the kernel choose
+	addr.nl_groups = 1;  // kernel uevents (udevd rebroadcasts them in group 2)
+	if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot bind uevent socket: " << hz::string_trim_copy(g_strerror(errno)) << "\n");
+		::close(fd);
+		return false;
+	}
+
+	if (!open_fd(fd)) {
+		return false;
+	}
+	is_netlink_ = true;
+	return true;
+#else
+	debug_out_info("app", DBG_FUNC_MSG << "Uevent monitoring is not supported on this platform.\n");
+	return false;
+#endif
+}
+
+
+
+bool UeventMonitor::open_fd([[maybe_unused]] int fd)
+{
+#ifdef _WIN32
+	return false;
+#else
+	DBG_ASSERT_RETURN(fd != -1, false);
+	close();
+
+	fd_ = fd;
+	is_netlink_ = false;
+	event_source_id_ = g_unix_fd_add_full(G_PRIORITY_DEFAULT_IDLE, fd_, GIOCondition(G_IO_IN | G_IO_ERR | G_IO_HUP),
+			&uevent_monitor_on_socket_ready, this, nullptr);
+	return true;
+#endif
+}
+
+
+
+void UeventMonitor::close()
+{
+	if (event_source_id_ != 0) {
+		g_source_remove(event_source_id_);
+		event_source_id_ = 0;
+	}
+#ifndef _WIN32
+	if (fd_ != -1) {
+		::close(fd_);
+		fd_ = -1;
+	}
+#endif
+	is_netlink_ = false;
+}
+
+
+
+bool UeventMonitor::is_open() const
+{
+	return fd_ != -1;
+}
+
+
+
+void UeventMonitor::process_pending()
+{
+#ifndef _WIN32
+	if (fd_ == -1) {
+		return;
+	}
+
+	std::array<char, 8192> buf = { };  // uevent messages are at most 8 KiB (UEVENT_BUFFER_SIZE)
+
+	while (true) {
+	#ifdef __linux__
+		sockaddr_nl sender = { };
+	#else
+		sockaddr_storage sender = { };
+	#endif
+		socklen_t sender_len = sizeof(sender);
+		const ssize_t received = recvfrom(fd_, buf.data(), buf.size(), MSG_DONTWAIT,
+				reinterpret_cast<sockaddr*>(&sender), &sender_len);
+		if (received == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			// EAGAIN means no more messages. ENOBUFS means we lost some; nothing to do about it.
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				debug_out_warn("app", DBG_FUNC_MSG << "Error reading uevent socket: " << hz::string_trim_copy(g_strerror(errno)) << "\n");
+			}
+			break;
+		}
+		if (received == 0) {
+			break;
+		}
+
+	#ifdef __linux__
+		// Only trust the kernel, anyone may send to our netlink socket.
+		if (is_netlink_ && sender.nl_pid != 0) {
+			continue;
+		}
+	#endif
+
+		const std::optional<UeventMessage> msg = parse_uevent_message(std::string_view(buf.data(), static_cast<std::size_t>(received)));
+		if (!msg || msg->subsystem != "block" || msg->devtype != "disk" || msg->devname.empty()) {
+			continue;
+		}
+		if (msg->action != "add" && msg->action != "remove") {
+			continue;
+		}
+
+		debug_out_info("app", DBG_FUNC_MSG << "Block device " << msg->action << " event for \"" << msg->devname << "\".\n");
+		signal_block_device_event_.emit(msg->action, "/dev/" + msg->devname);
+	}
+#endif
+}
+
+
+
+sigc::signal<void, const std::string&, const std::string&>& UeventMonitor::signal_block_device_event()
+{
+	return signal_block_device_event_;
+}
+
+
+
+int UeventMonitor::on_socket_ready([[maybe_unused]] int fd, int condition, UeventMonitor* self)
+{
+	if ((condition & (G_IO_ERR | G_IO_HUP)) != 0) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Uevent socket closed, not monitoring anymore.\n");
+		self->event_source_id_ = 0;  // we return false, removing the source
+		self->close();
+		return FALSE;
+	}
+	self->process_pending();
+	return TRUE;
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,113 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef UEVENT_MONITOR_H
+#define UEVENT_MONITOR_H
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <optional>
+#include <sigc++/sigc++.h>
+
+
+
+/// A kernel uevent message (as sent over NETLINK_KOBJECT_UEVENT socket)
+struct UeventMessage {
+	std::string action;  ///< "add", "remove", "change", ...
+	std::string devpath;  ///< Sysfs path, e.g. "/devices/pci0000:00/.../block/sdb"
+	std::string subsystem;  ///< e.g. "block"
+	std::string devname;  ///< Device node name relative to /dev, e.g. "sdb"
+	std::string devtype;  ///< e.g. "disk" or "partition"
+	std::map<std::string, std::string> properties;  ///< All KEY=VALUE pairs
+};
+
+
+
+/// Parse a kernel uevent message: "action@devpath\0KEY=VALUE\0KEY=VALUE\0...".
+/// Messages from udevd (starting with "libudev") are not supported.
+/// \return std::nullopt if the message cannot be parsed.
+std::optional<UeventMessage> parse_uevent_message(std::string_view data);
+
+
+
+/// Listens to kernel uevents and reports added and removed block devices (whole disks
+/// only, no partitions). The events are processed in the default GLib main context.
+/// Linux only; open() fails elsewhere.
+class UeventMonitor {
+	public:
+
+		/// Constructor
+		UeventMonitor() = default;
+
+		/// Deleted
+		UeventMonitor(const UeventMonitor& other) = delete;
+
+		/// Deleted
+		UeventMonitor(UeventMonitor&& other) = delete;
+
+		/// Deleted
+		UeventMonitor& operator=(const UeventMonitor& other) = delete;
+
+		/// Deleted
+		UeventMonitor& operator=(UeventMonitor&& other) = delete;
+
+		/// Destructor, calls close()
+		~UeventMonitor();
+
+
+		/// Open a netlink socket for kernel uevents and start watching it.
+		/// \return false on error.
+		bool open();
+
+		/// Start watching an already open datagram socket instead of the netlink one
+		/// (e.g. one end of a socketpair() in tests). The socket is owned by this object.
+		/// \return false on error.
+		bool open_fd(int fd);
+
+		/// Stop watching and close the socket
+		void close();
+
+		/// Check whether the socket is open
+		[[nodiscard]] bool is_open() const;
+
+
+		/// Read and dispatch all the pending messages. This is called automatically
+		/// from the main loop, but may be called manually too.
+		void process_pending();
+
+
+		/// Emitted for each "add" or "remove" event of a whole block device.
+		/// The parameters are the action and the device file (e.g. "/dev/sdb").
+		sigc::signal<void, const std::string&, const std::string&>& signal_block_device_event();
+
+
+		/// Called by the socket watch callback
+		static int on_socket_ready(int fd, int condition, UeventMonitor* self);
+
+
+	private:
+
+		int fd_ = -1;  ///< Socket
+		bool is_netlink_ = false;  ///< Whether the socket is a real netlink one (messages are checked to come from the kernel)
+		unsigned int event_source_id_ = 0;  ///< Socket watch source
+
+		sigc::signal<void, const std::string&, const std::string&> signal_block_device_event_;  ///< Block device event signal
+
+};
+
+
+
+
+
+#endif
+
+/// @}
@@ -0,0 +1,295 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include "local_glibmm.h"
+#include <glib.h>  // g_pattern_match_simple
+#include <algorithm>
+
+#include "hz/fs.h"
+#include "hz/debug.h"
+#include "hz/string_algo.h"
+#include "virtual_drive_loader.h"
+
+
+
+namespace {
+
+
+	/// Add the non-hidden regular files of \c dir matching \c pattern (if not empty) to \c files
+	void virtual_drive_add_dir_files(const hz::fs::path& dir, const std::string& pattern, std::vector<hz::fs::path>& files)
+	{
+		std::error_code ec;
+		for (const auto& entry : hz::fs::directory_iterator(dir, ec)) {
+			const std::string name = entry.path().filename().u8string();
+			std::error_code type_ec;
+			if (hz::string_begins_with(name, '.') || !entry.is_regular_file(type_ec)) {
+				continue;
+			}
+			if (!pattern.empty() && !g_pattern_match_simple(pattern.c_str(), name.c_str())) {
+				continue;
+			}
+			files.push_back(entry.path());
+		}
+		if (ec) {
+			debug_out_warn("app", DBG_FUNC_MSG << "Cannot list directory \"" << dir.u8string() << "\": " << ec.message() << "\n");
+		}
+	}
+
+
+}
+
+
+
+std::vector<hz::fs::path> virtual_drive_expand_paths(const std::vector<std::string>& args)
+{
+	std::vector<hz::fs::path> files;
+	for (const auto& arg : args) {
+		if (arg.empty()) {
+			continue;
+		}
+		const hz::fs::path path = hz::fs::u8path(arg);
+		const std::string name = path.filename().u8string();
+		std::error_code ec;
+
+		if (name.find_first_of("*?") != std::string::npos) {
+			const hz::fs::path dir = path.has_parent_path() ? path.parent_path() : hz::fs::path(".");
+			virtual_drive_add_dir_files(dir, name, files);
+
+		} else if (hz::fs::is_directory(path, ec)) {
+			virtual_drive_add_dir_files(path, std::string(), files);
+
+		} else {
+			files.push_back(path);  // errors are reported when it's loaded
+		}
+	}
+
+	std::sort(files.begin(), files.end());
+	files.erase(std::unique(files.begin(), files.end()), files.end());
+	return files;
+}
+
+
+
+std::string virtual_drive_load(const hz::fs::path& file, StorageDevicePtr& drive)
+{
+	std::string output;
+	const std::uintmax_t max_size = 10*1024*1024;  // 10M, same as for single files
+	if (auto ec = hz::fs_file_get_contents(file, output, max_size)) {
+		debug_out_warn("app", "Cannot open virtual drive file \"" << file.u8string() << "\": " << ec.message() << "\n");
+		return ec.message();
+	}
+
+	auto new_drive = std::make_shared<StorageDevice>(file.u8string(), true);
+	new_drive->set_full_output(output);
+	new_drive->set_info_output(output);  // info can be parsed from full output string too.
+
+	std::string error_msg = new_drive->parse_data();  // this will set the type and add the properties
+	if (!error_msg.empty()) {
+		return error_msg;
+	}
+	drive = new_drive;
+	return {};
+}
+
+
+
+VirtualDriveBulkLoader::VirtualDriveBulkLoader()
+{
+	dispatcher_.connect(sigc::mem_fun(*this, &VirtualDriveBulkLoader::on_dispatch));
+}
+
+
+
+VirtualDriveBulkLoader::~VirtualDriveBulkLoader()
+{
+	cancel();
+}
+
+
+
+bool VirtualDriveBulkLoader::start(std::vector<hz::fs::path> files, unsigned int num_threads)
+{
+	if (running_) {
+		return false;
+	}
+	join_workers();  // finished, but maybe not joined yet
+
+	files_ = std::move(files);
+	next_file_ = 0;
+	cancelled_ = false;
+	num_processed_ = 0;
+	drives_by_serial_.clear();
+	running_ = true;
+
+	if (files_.empty()) {
+		running_ = false;
+		signal_finished_.emit();
+		return true;
+	}
+
+	if (num_threads == 0) {
+		num_threads = std::clamp(std::thread::hardware_concurrency(), 1U, 8U);
+	}
+	num_threads = static_cast<unsigned int>(std::min<std::size_t>(num_threads, files_.size()));
+
+	debug_out_info("app", DBG_FUNC_MSG << "Loading " << files_.size() << " virtual drive files with "
+			<< num_threads << " threads.\n");
+
+	for (unsigned int i = 0; i < num_threads; ++i) {
+		workers_.emplace_back(&VirtualDriveBulkLoader::run_worker, this);
+	}
+	return true;
+}
+
+
+
+void VirtualDriveBulkLoader::cancel()
+{
+	cancelled_ = true;
+	join_workers();
+	running_ = false;
+	const std::lock_guard<std::mutex> lock(results_mutex_);
+	results_.clear();
+}
+
+
+
+bool VirtualDriveBulkLoader::is_running() const
+{
+	return running_;
+}
+
+
+
+std::size_t VirtualDriveBulkLoader::get_num_processed() const
+{
+	return num_processed_;
+}
+
+
+
+std::size_t VirtualDriveBulkLoader::get_num_files() const
+{
+	return files_.size();
+}
+
+
+
+sigc::signal<void, StorageDevicePtr, StorageDevicePtr>& VirtualDriveBulkLoader::signal_drive_loaded()
+{
+	return signal_drive_loaded_;
+}
+
+
+
+sigc::signal<void, const hz::fs::path&, const std::string&>& VirtualDriveBulkLoader::signal_file_failed()
+{
+	return signal_file_failed_;
+}
+
+
+
+sigc::signal<void>& VirtualDriveBulkLoader::signal_finished()
+{
+	return signal_finished_;
+}
+
+
+
+void VirtualDriveBulkLoader::run_worker()
+{
+	while (!cancelled_) {
+		const std::size_t index = next_file_++;
+		if (index >= files_.size()) {
+			break;
+		}
+
+		Result result;
+		result.file = files_[index];
+		std::error_code ec;
+		result.mtime = hz::fs::last_write_time(result.file, ec);
+		result.error_message = virtual_drive_load(result.file, result.drive);
+
+		{
+			const std::lock_guard<std::mutex> lock(results_mutex_);
+			results_.push_back(std::move(result));
+		}
+		dispatcher_.emit();
+	}
+}
+
+
+
+void VirtualDriveBulkLoader::on_dispatch()
+{
+	std::vector<Result> results;
+	{
+		const std::lock_guard<std::mutex> lock(results_mutex_);
+		results.swap(results_);
+	}
+	if (!running_) {  // cancelled
+		return;
+	}
+
+	for (auto& result : results) {
+		if (!running_) {  // cancelled by a signal handler
+			return;
+		}
+		++num_processed_;
+
+		if (!result.drive) {
+			signal_file_failed_.emit(result.file, result.error_message);
+			continue;
+		}
+
+		const std::string serial = result.drive->get_serial_number();
+		StorageDevicePtr replaced;
+		if (!serial.empty()) {
+			auto iter = drives_by_serial_.find(serial);
+			if (iter != drives_by_serial_.end()) {
+				if (iter->second.second >= result.mtime) {
+					debug_out_dump("app", DBG_FUNC_MSG << "Skipping \"" << result.file.u8string()
+							<< "\", a newer report of drive " << serial << " is loaded.\n");
+					continue;
+				}
+				replaced = iter->second.first;
+			}
+			drives_by_serial_[serial] = {result.drive, result.mtime};
+		}
+		signal_drive_loaded_.emit(result.drive, replaced);
+	}
+
+	if (num_processed_ == files_.size()) {
+		running_ = false;
+		join_workers();  // they've all exited or are about to
+		debug_out_info("app", DBG_FUNC_MSG << "Loaded " << files_.size() << " virtual drive files.\n");
+		signal_finished_.emit();
+	}
+}
+
+
+
+void VirtualDriveBulkLoader::join_workers()
+{
+	for (auto& worker : workers_) {
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+	workers_.clear();
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,165 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef VIRTUAL_DRIVE_LOADER_H
+#define VIRTUAL_DRIVE_LOADER_H
+
+#include <glibmm.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <system_error>
+#include <sigc++/sigc++.h>
+
+#include "hz/fs_ns.h"
+#include "storage_device.h"
+
+
+
+/// Expand the arguments of virtual drive loading: files are taken as is, directories
+/// are replaced by the (non-hidden) regular files in them, and arguments with
+/// wildcards ('*', '?') in the file name are matched against the files of their directory.
+/// The result is sorted and has no duplicates.
+std::vector<hz::fs::path> virtual_drive_expand_paths(const std::vector<std::string>& args);
+
+
+
+/// Read and parse smartctl output file as a virtual drive. This doesn't touch
+/// the GUI, so it may be called from any thread.
+/// \return error message on error.
+std::string virtual_drive_load(const hz::fs::path& file, StorageDevicePtr& drive);
+
+
+
+/**
+Loads many virtual drive files in parallel. The files are read and parsed
+on a pool of worker threads, and the results are delivered in the main
+loop (through Glib::Dispatcher) as they complete.
+
+Drives with the same serial number are reported once: when another report of
+an already loaded drive completes, the one from the most recently modified file
+is kept.
+
+The object must be created and used in the main thread.
+*/
+class VirtualDriveBulkLoader {
+	public:
+
+		/// Constructor
+		VirtualDriveBulkLoader();
+
+		/// Deleted
+		VirtualDriveBulkLoader(const VirtualDriveBulkLoader& other) = delete;
+
+		/// Deleted
+		VirtualDriveBulkLoader(VirtualDriveBulkLoader&& other) = delete;
+
+		/// Deleted
+		VirtualDriveBulkLoader& operator=(const VirtualDriveBulkLoader& other) = delete;
+
+		/// Deleted
+		VirtualDriveBulkLoader& operator=(VirtualDriveBulkLoader&& other) = delete;
+
+		/// Destructor, cancels the loading and waits for the workers to exit.
+		~VirtualDriveBulkLoader();
+
+
+		/// Start loading \c files with \c num_threads workers (0 means the number of CPUs,
+		/// up to 8). Does nothing if already running.
+		/// \return false if already running.
+		bool start(std::vector<hz::fs::path> files, unsigned int num_threads = 0);
+
+
+		/// Stop loading the remaining files and wait for the workers to exit.
+		/// No signals are emitted afterwards.
+		void cancel();
+
+
+		/// Check whether the loading is in progress
+		[[nodiscard]] bool is_running() const;
+
+
+		/// Number of files which have been processed (loaded or failed)
+		[[nodiscard]] std::size_t get_num_processed() const;
+
+
+		/// Number of files to load
+		[[nodiscard]] std::size_t get_num_files() const;
+
+
+		/// Emitted when a drive is loaded. The second parameter is a previously loaded
+		/// drive with the same serial number (which should be replaced), or nullptr.
+		sigc::signal<void, StorageDevicePtr, StorageDevicePtr>& signal_drive_loaded();
+
+
+		/// Emitted when a file cannot be loaded, with the file and the error message.
+		sigc::signal<void, const hz::fs::path&, const std::string&>& signal_file_failed();
+
+
+		/// Emitted when all the files have been processed
+		sigc::signal<void>& signal_finished();
+
+
+	private:
+
+		/// Result of loading one file
+		struct Result {
+			hz::fs::path file;  ///< Loaded file
+			StorageDevicePtr drive;  ///< Drive, nullptr on error
+			std::string error_message;  ///< Error message
+			hz::fs::file_time_type mtime;  ///< Modification time of the file
+		};
+
+
+		/// Worker thread function
+		void run_worker();
+
+		/// Dispatcher callback, delivers the results in the main thread
+		void on_dispatch();
+
+		/// Wait for the workers to exit
+		void join_workers();
+
+
+		Glib::Dispatcher dispatcher_;  ///< Wakes up the main thread when results are available
+		std::vector<std::thread> workers_;  ///< Worker threads
+
+		std::vector<hz::fs::path> files_;  ///< Files to load, read-only while the workers run
+		std::atomic<std::size_t> next_file_ = 0;  ///< Index of the next file to take by a worker
+		std::atomic<bool> cancelled_ = false;  ///< Whether the loading has been cancelled
+
+		std::mutex results_mutex_;  ///< Protects results_
+		std::vector<Result> results_;  ///< Results not yet delivered to the main thread
+
+		std::size_t num_processed_ = 0;  ///< Number of delivered results (main thread only)
+		bool running_ = false;  ///< Whether the loading is in progress (main thread only)
+
+		/// Loaded drives by serial number, with their file modification times (main thread only)
+		std::map<std::string, std::pair<StorageDevicePtr, hz::fs::file_time_type>> drives_by_serial_;
+
+		sigc::signal<void, StorageDevicePtr, StorageDevicePtr> signal_drive_loaded_;  ///< Drive loaded signal
+		sigc::signal<void, const hz::fs::path&, const std::string&> signal_file_failed_;  ///< File failed signal
+		sigc::signal<void> signal_finished_;  ///< Finished signal
+
+};
+
+
+
+
+
+
+#endif
+
+/// @}
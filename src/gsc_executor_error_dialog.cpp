@@ -75,9 +75,11 @@ void gsc_executor_error_dialog_show(const std::string& message, const std::strin
 
 	if (response == Gtk::RESPONSE_HELP) {
 		// this one will only hide on close.
-		auto win = GscExecutorLogWindow::create();  // probably already created
+		auto win = GscExecutorLogWindow::create();  // created on first use
 		// win->set_transient_for(*this);  // don't do this - it will make it always-on-top of this.
-		win->show_last();  // show the window and select last entry
+		if (win) {
+			win->show_last();  // show the window and select last entry
+		}
 	}
 }
 
@@ -15,9 +15,12 @@ Copyright:
 #include <sstream>
 #include <cstddef>  // std::size_t
 #include <memory>
+#include <algorithm>  // std::max
 
 #include "applib/app_gtkmm_tools.h"  // app_gtkmm_create_tree_view_column
+#include "applib/smartctl_executor.h"  // get_smartctl_latency_tracker
 #include "hz/fs.h"
+#include "hz/string_num.h"
 #include "rconfig/rconfig.h"
 
 #include "gsc_executor_log_window.h"
@@ -25,6 +28,18 @@ Copyright:
 
 
 
+namespace {
+
+	/// Get the log size limit from config
+	std::size_t get_executor_log_max_bytes()
+	{
+		return std::size_t(std::max(0, rconfig::get_data<int>("gui/executor_log_max_size_kib"))) * 1024;
+	}
+
+}
+
+
+
 
 GscExecutorLogWindow::GscExecutorLogWindow(BaseObjectType* gtkcobj, Glib::RefPtr<Gtk::Builder> ui)
 		: AppBuilderWidget<GscExecutorLogWindow, false>(gtkcobj, std::move(ui))
@@ -61,7 +76,7 @@ GscExecutorLogWindow::GscExecutorLogWindow(BaseObjectType* gtkcobj, Glib::RefPtr
 	if (treeview) {
 		Gtk::TreeModelColumnRecord model_columns;
 
-		// #, Command + parameters, [EntryPtr]
+		// #, Command + parameters, Time. The entry is looked up by its number.
 
 		model_columns.add(col_num);
 		app_gtkmm_create_tree_view_column(col_num, *treeview,
@@ -71,7 +86,9 @@ GscExecutorLogWindow::GscExecutorLogWindow(BaseObjectType* gtkcobj, Glib::RefPtr
 		app_gtkmm_create_tree_view_column(col_command, *treeview,
 				_("Command"), _("Command with parameters"), true);  // sortable
 
-		model_columns.add(col_entry);
+		model_columns.add(col_time);
+		app_gtkmm_create_tree_view_column(col_time, *treeview,
+				_("Time"), _("Execution time, in seconds"), false);
 
 
 		// create a TreeModel (ListStore)
@@ -102,15 +119,32 @@ GscExecutorLogWindow::GscExecutorLogWindow(BaseObjectType* gtkcobj, Glib::RefPtr
 
 	// ---------------
 
-	// Connect to CommandExecutor signal
-	cmdex_sync_signal_execute_finish().connect(sigc::mem_fun(*this,
-			&GscExecutorLogWindow::on_command_output_received));
+	// Add the entries recorded before the window was created. Their outputs
+	// are decompressed only when selected.
+	CommandLogBuffer& entries = get_entries();
+	for (std::size_t num = entries.get_first_number(); num != 0 && num <= entries.get_last_number(); ++num) {
+		if (auto entry = entries.get(num, false)) {
+			add_entry_row(num, *entry, false);
+		}
+	}
 
 	// show();
 }
 
 
 
+void GscExecutorLogWindow::start_logging()
+{
+	static bool started = false;
+	if (!started) {
+		started = true;
+		// Connect to CommandExecutor signal
+		cmdex_sync_signal_execute_finish().connect(sigc::ptr_fun(&GscExecutorLogWindow::on_command_output_received));
+	}
+}
+
+
+
 void GscExecutorLogWindow::show_last()
 {
 	auto* treeview = this->lookup_widget<Gtk::TreeView*>("command_list_treeview");
@@ -149,19 +183,13 @@ void GscExecutorLogWindow::clear_view_widgets()
 
 void GscExecutorLogWindow::on_command_output_received(const CommandExecutorResult& info)
 {
-	auto entry = std::make_shared<CommandExecutorResult>(info);
-	entries.push_back(entry);
-
-	// update tree model
-	Gtk::TreeRow row = *(list_store->append());
-	row[col_num] = entries.size();
-	row[col_command] = info.command + " " + info.parameters;
-	row[col_entry] = entry;
+	// The limit may have been changed in config
+	get_entries().set_max_bytes(get_executor_log_max_bytes());
+	const std::size_t number = get_entries().add(info);
 
-	// if visible, set the selection to it
-	if (auto* treeview = this->lookup_widget<Gtk::TreeView*>("command_list_treeview")) {
-		selection->select(row);
-		treeview->scroll_to_row(list_store->get_path(row));
+	if (auto win = instance()) {
+		win->remove_dropped_rows();
+		win->add_entry_row(number, info, true);
 	}
 }
 
@@ -188,7 +216,10 @@ void GscExecutorLogWindow::on_window_save_current_button_clicked()
 		return;
 
 	Gtk::TreeIter iter = selection->get_selected();
-	std::shared_ptr<CommandExecutorResult> entry = (*iter)[col_entry];
+	const std::size_t number = (*iter)[col_num];
+	std::shared_ptr<CommandExecutorResult> entry = get_entries().get(number);
+	if (!entry)
+		return;
 
 	static std::string last_dir;
 	if (last_dir.empty()) {
@@ -261,7 +292,7 @@ void GscExecutorLogWindow::on_window_save_current_button_clicked()
 				file += ".txt";
 			}
 
-			auto ec = hz::fs_file_put_contents(file, entry->std_output);
+			auto ec = hz::fs_file_put_contents(file, *entry->std_output);
 			if (ec) {
 				gui_show_error_dialog(_("Cannot save data to file"), ec.message(), this);
 			}
@@ -293,20 +324,30 @@ void GscExecutorLogWindow::on_window_save_all_button_clicked()
 
 	exss << "\n\n\n------------------------- EXECUTION LOG -------------------------\n\n\n";
 
-	for (std::size_t i = 0; i < entries.size(); ++i) {
-		exss << "\n\n\n------------------------- EXECUTED COMMAND " << (i+1) << " -------------------------\n\n";
+	// Decompress the entries one by one, so that only one of them is uncompressed at a time.
+	const CommandLogBuffer& entries = get_entries();
+	for (std::size_t num = entries.get_first_number(); num != 0 && num <= entries.get_last_number(); ++num) {
+		std::shared_ptr<CommandExecutorResult> entry = entries.get(num);
+		if (!entry)
+			continue;
+		exss << "\n\n\n------------------------- EXECUTED COMMAND " << num << " -------------------------\n\n";
 		exss << "\n---------------" << "Command" << "---------------\n";
-		exss << entries[i]->command << "\n";
+		exss << entry->command << "\n";
 		exss << "\n---------------" << "Parameters" << "---------------\n";
-		exss << entries[i]->parameters << "\n";
+		exss << entry->parameters << "\n";
+		exss << "\n---------------" << "Execution Time" << "---------------\n";
+		exss << hz::number_to_string_nolocale(static_cast<double>(entry->execution_time.count()) / 1000., 2, true) << " s\n";
 		exss << "\n---------------" << "STDOUT" << "---------------\n";
-		exss << entries[i]->std_output << "\n\n";
+		exss << *entry->std_output << "\n\n";
 		exss << "\n---------------" << "STDERR" << "---------------\n";
-		exss << entries[i]->std_error << "\n\n";
+		exss << *entry->std_error << "\n\n";
 		exss << "\n---------------" << "Error Message" << "---------------\n";
-		exss << entries[i]->error_message << "\n\n";
+		exss << entry->error_message << "\n\n";
 	}
 
+	exss << "\n\n\n------------------------- LATENCY STATISTICS -------------------------\n\n\n";
+	exss << get_smartctl_latency_tracker().format_stats(get_smartctl_latency_settings()) << "\n";
+
 
 	static std::string last_dir;
 	if (last_dir.empty()) {
@@ -401,12 +442,53 @@ void GscExecutorLogWindow::on_window_save_all_button_clicked()
 
 void GscExecutorLogWindow::on_clear_command_list_button_clicked()
 {
-	entries.clear();
+	get_entries().clear();
 	list_store->clear();  // this will unselect & clear widgets too.
 }
 
 
 
+CommandLogBuffer& GscExecutorLogWindow::get_entries()
+{
+	static CommandLogBuffer entries(get_executor_log_max_bytes());
+	return entries;
+}
+
+
+
+void GscExecutorLogWindow::add_entry_row(std::size_t number, const CommandExecutorResult& info, bool select)
+{
+	Gtk::TreeRow row = *(list_store->append());
+	row[col_num] = number;
+	row[col_command] = info.command + " " + info.parameters;
+	row[col_time] = hz::number_to_string_locale(static_cast<double>(info.execution_time.count()) / 1000., 2, true);
+
+	// set the selection to it
+	if (auto* treeview = this->lookup_widget<Gtk::TreeView*>("command_list_treeview"); treeview && select) {
+		selection->select(row);
+		treeview->scroll_to_row(list_store->get_path(row));
+	}
+}
+
+
+
+void GscExecutorLogWindow::remove_dropped_rows()
+{
+	const std::size_t first_number = get_entries().get_first_number();
+	// The rows may be sorted by the user, so check all of them.
+	auto iter = list_store->children().begin();
+	while (iter) {
+		const std::size_t number = (*iter)[col_num];
+		if (number < first_number) {
+			iter = list_store->erase(iter);
+		} else {
+			++iter;
+		}
+	}
+}
+
+
+
 void GscExecutorLogWindow::on_tree_selection_changed()
 {
 	this->clear_view_widgets();
@@ -415,12 +497,15 @@ void GscExecutorLogWindow::on_tree_selection_changed()
 		Gtk::TreeIter iter = selection->get_selected();
 		Gtk::TreeRow row = *iter;
 
-		std::shared_ptr<CommandExecutorResult> entry = row[col_entry];
+		const std::size_t number = row[col_num];
+		std::shared_ptr<CommandExecutorResult> entry = get_entries().get(number);
+		if (!entry)
+			return;
 
 		if (auto* output_textview = this->lookup_widget<Gtk::TextView*>("output_textview")) {
 			Glib::RefPtr<Gtk::TextBuffer> buffer = output_textview->get_buffer();
 			if (buffer) {
-				buffer->set_text(app_make_valid_utf8_from_command_output(entry->std_output));
+				buffer->set_text(app_make_valid_utf8_from_command_output(*entry->std_output));
 
 				Glib::RefPtr<Gtk::TextTag> tag;
 				Glib::RefPtr<Gtk::TextTagTable> table = buffer->get_tag_table();
@@ -12,19 +12,21 @@ Copyright:
 #ifndef GSC_EXECUTOR_LOG_WINDOW_H
 #define GSC_EXECUTOR_LOG_WINDOW_H
 
-#include <vector>
 #include <cstddef>  // std::size_t
 #include <gtkmm.h>
 #include <memory>
 
 #include "applib/app_builder_widget.h"
 #include "applib/command_executor.h"
+#include "applib/command_log_buffer.h"
 
 
 
 
 /// The "Execution Log" window.
 /// Use create() / destroy() with this class instead of new / delete!
+/// The log is recorded from startup (see start_logging()); the window is only
+/// created when it's first shown, and is kept (hidden) after that.
 class GscExecutorLogWindow : public AppBuilderWidget<GscExecutorLogWindow, false> {
 	public:
 
@@ -36,6 +38,11 @@ class GscExecutorLogWindow : public AppBuilderWidget<GscExecutorLogWindow, false
 		GscExecutorLogWindow(BaseObjectType* gtkcobj, Glib::RefPtr<Gtk::Builder> ui);
 
 
+		/// Start recording the command executor results into the log.
+		/// The window, when created, shows the entries recorded before it.
+		static void start_logging();
+
+
 		/// Show this window and select the last entry
 		void show_last();
 
@@ -50,8 +57,9 @@ class GscExecutorLogWindow : public AppBuilderWidget<GscExecutorLogWindow, false
 
 		// -------------------- callbacks
 
-		/// Callback attached to external source, adds entries in real time.
-		void on_command_output_received(const CommandExecutorResult& info);
+		/// Callback attached to external source, records entries and adds them
+		/// to the window (if created) in real time.
+		static void on_command_output_received(const CommandExecutorResult& info);
 
 
 
@@ -82,7 +90,18 @@ class GscExecutorLogWindow : public AppBuilderWidget<GscExecutorLogWindow, false
 
 	private:
 
-		std::vector<std::shared_ptr<CommandExecutorResult>> entries;  ///< Command information entries
+		/// Command information entries, compressed and bounded.
+		/// These outlive the window, so that it can be created on demand.
+		static CommandLogBuffer& get_entries();
+
+
+		/// Add a row for a log entry, optionally selecting it
+		void add_entry_row(std::size_t number, const CommandExecutorResult& info, bool select);
+
+
+		/// Remove the rows of entries which were dropped from the buffer
+		void remove_dropped_rows();
+
 
 
 		Glib::RefPtr<Gtk::ListStore> list_store;  ///< List store
@@ -90,7 +109,7 @@ class GscExecutorLogWindow : public AppBuilderWidget<GscExecutorLogWindow, false
 
 		Gtk::TreeModelColumn<std::size_t> col_num;  ///< Tree column
 		Gtk::TreeModelColumn<std::string> col_command;  ///< Tree column
-		Gtk::TreeModelColumn<std::shared_ptr<CommandExecutorResult>> col_entry;  ///< Tree column
+		Gtk::TreeModelColumn<std::string> col_time;  ///< Tree column
 
 
 };
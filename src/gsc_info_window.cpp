@@ -13,8 +13,10 @@ Copyright:
 #include <gtkmm.h>
 #include <gdk/gdk.h>  // GDK_KEY_Escape
 #include <vector>  // better use vector, it's needed by others too
-#include <algorithm>  // std::min, std::max
+#include <algorithm>  // std::min, std::max, std::any_of
 #include <memory>
+#include <ctime>
+#include <limits>
 
 #include "hz/string_num.h"  // number_to_string
 #include "hz/string_sprintf.h"  // string_sprintf
@@ -27,11 +29,15 @@ Copyright:
 #include "applib/warning_colors.h"
 #include "applib/gui_utils.h"  // gui_show_error_dialog
 #include "applib/smartctl_executor_gui.h"
+#include "applib/attribute_history.h"
+#include "applib/attribute_trend.h"
 
 #include "gsc_text_window.h"
 #include "gsc_info_window.h"
+#include "gsc_main_window.h"
 #include "gsc_executor_error_dialog.h"
 #include "gsc_startup_settings.h"
+#include "gsc_init.h"  // app_get_attribute_history_dir()
 
 
 
@@ -132,6 +138,20 @@ namespace {
 
 
 
+	/// Store the warning colors of property \c p in a tree row, so that the cell
+	/// renderers don't have to derive them for each cell on each redraw.
+	template<typename ColumnRecord>
+	inline void app_set_row_warning_colors(Gtk::TreeRow& row, const ColumnRecord& columns, const AtaStorageProperty& p)
+	{
+		std::string fg, bg;
+		if (app_property_get_row_highlight_colors(p.warning_level, fg, bg)) {
+			row[columns.row_fg] = fg;
+			row[columns.row_bg] = bg;
+		}
+	}
+
+
+
 	/// Scroll to appropriate error in text when row is selected in tree.
 	inline void on_error_log_treeview_row_selected(GscInfoWindow* window,
 			Gtk::TreeModelColumn<Glib::ustring> mark_name_column)
@@ -201,6 +221,9 @@ GscInfoWindow::GscInfoWindow(BaseObjectType* gtkcobj, Glib::RefPtr<Gtk::Builder>
 	Gtk::Button* test_stop_button = nullptr;
 	APP_BUILDER_AUTO_CONNECT(test_stop_button, clicked);
 
+	Gtk::DrawingArea* temperature_log_graph = nullptr;
+	APP_BUILDER_AUTO_CONNECT(temperature_log_graph, draw);
+
 
 	// Accelerators
 	if (close_window_button) {
@@ -348,12 +371,22 @@ void GscInfoWindow::fill_ui_with_info(bool scan, bool clear_ui, bool clear_tests
 		if (scan) {
 			std::shared_ptr<SmartctlExecutorGui> ex(new SmartctlExecutorGui());
 			ex->create_running_dialog(this, Glib::ustring::compose(_("Running {command} on %1..."), drive->get_device_with_type()));
-			const std::string error_msg = drive->fetch_data_and_parse(ex);  // run it with GUI support
+			const std::string error_msg = drive->fetch_data(ex);  // run it with GUI support
 
 			if (!error_msg.empty()) {
 				gsc_executor_error_dialog_show(_("Cannot retrieve SMART data"), error_msg, this);
+				this->set_sensitive(true);
 				return;
 			}
+
+			// Parse it in the background, the UI is filled when it's done.
+			if (auto main_window = GscMainWindow::instance()) {
+				main_window->get_parse_queue().parse(drive,
+						sigc::bind(sigc::mem_fun(*this, &GscInfoWindow::on_drive_parsed), clear_tests));
+				return;
+			}
+			on_drive_parsed(drive, drive->parse_data(), true, clear_tests);
+			return;
 		}
 	}
 
@@ -416,8 +449,14 @@ void GscInfoWindow::fill_ui_with_info(bool scan, bool clear_ui, bool clear_tests
 
 	// Fill the tabs with info
 
-	// we need reference here - we take addresses of the elements
-	const auto& props = drive->get_properties();  // it's a vector
+	// The tree models take addresses of the elements, so they point to our own copy,
+	// which is not touched when the drive is reparsed. Keep the old copy until the
+	// models are refilled.
+	std::vector<AtaStorageProperty> old_properties;
+	old_properties.swap(displayed_properties);
+	displayed_properties = drive->get_properties();
+	displayed_info_output = drive->get_info_output_shared();
+	const auto& props = displayed_properties;
 
 	fill_ui_general(props);
 	fill_ui_attributes(props);
@@ -446,6 +485,8 @@ void GscInfoWindow::fill_ui_with_info(bool scan, bool clear_ui, bool clear_tests
 
 	// Advanced tab label
 	app_highlight_tab_label(lookup_widget("advanced_tab_label"), max_advanced_tab_warning, tab_advanced_name);
+
+	this->set_sensitive(true);  // in case it was made insensitive by refresh_info()
 }
 
 
@@ -588,6 +629,11 @@ void GscInfoWindow::clear_ui_info(bool clear_tests_too)
 			buffer->set_text("\n"s + _("No data available"));
 		}
 
+		temperature_history = AtaStorageTemperatureHistory();
+		if (auto* graph = lookup_widget<Gtk::DrawingArea*>("temperature_log_graph")) {
+			graph->hide();
+		}
+
 		// tab label
 		app_highlight_tab_label(lookup_widget("temperature_log_tab_label"), WarningLevel::none, tab_temperature_name);
 	}
@@ -654,9 +700,8 @@ void GscInfoWindow::refresh_info(bool clear_tests_too)
 	this->set_sensitive(false);  // make insensitive until filled. helps with pressed F5 problem.
 
 	// this->clear_ui_info();  // no need, fill_ui_with_info() will call it.
+	// It also makes the window sensitive again once the data is parsed and filled.
 	this->fill_ui_with_info(true, true, clear_tests_too);
-
-	this->set_sensitive(true);  // make sensitive again.
 }
 
 
@@ -689,10 +734,8 @@ void GscInfoWindow::on_view_output_button_clicked()
 	auto win = GscTextWindow<SmartctlOutputInstance>::create();
 	// make save visible and enable monospace font
 
-	std::string output = this->drive->get_full_output();
-	if (output.empty()) {
-		output = this->drive->get_info_output();
-	}
+	const std::string& output = this->drive->get_full_output().empty()
+			? this->drive->get_info_output() : this->drive->get_full_output();
 
 	win->set_text_from_command(_("Smartctl Output"), output);
 
@@ -782,10 +825,8 @@ void GscInfoWindow::on_save_info_button_clicked()
 				file += ".txt";
 			}
 
-			std::string data = this->drive->get_full_output();
-			if (data.empty()) {
-				data = this->drive->get_info_output();
-			}
+			const std::string& data = this->drive->get_full_output().empty()
+					? this->drive->get_info_output() : this->drive->get_full_output();
 			const std::error_code ec = hz::fs_file_put_contents(file, data);
 			if (ec) {
 				gui_show_error_dialog(_("Cannot save SMART data to file"), ec.message(), this);
@@ -993,12 +1034,13 @@ void GscInfoWindow::fill_ui_attributes(const std::vector<AtaStorageProperty>& pr
 	treeview->set_tooltip_column(attribute_table_columns.tooltip.index());
 
 	model_columns.add(attribute_table_columns.storage_property);
+	model_columns.add(attribute_table_columns.row_fg);
+	model_columns.add(attribute_table_columns.row_bg);
 
 
-	// create a TreeModel (ListStore)
+	// Create a TreeModel (ListStore). It's filled while detached from the treeview
+	// and unsorted, so that the view doesn't react to each inserted row.
 	Glib::RefPtr<Gtk::ListStore> list_store = Gtk::ListStore::create(model_columns);
-	list_store->set_sort_column(attribute_table_columns.id, Gtk::SORT_ASCENDING);  // default sort
-	treeview->set_model(list_store);
 
 	for (int i = 0; i < int(treeview->get_n_columns()); ++i) {
 		Gtk::TreeViewColumn* tcol = treeview->get_column(i);
@@ -1038,12 +1080,46 @@ void GscInfoWindow::fill_ui_attributes(const std::vector<AtaStorageProperty>& pr
 		row[attribute_table_columns.when_failed] = Glib::Markup::escape_text(AtaStorageAttribute::get_fail_time_name(attr.when_failed));
 		row[attribute_table_columns.tooltip] = p.get_description();  // markup
 		row[attribute_table_columns.storage_property] = &p;
+		app_set_row_warning_colors(row, attribute_table_columns, p);
 
 		if (int(p.warning_level) > int(max_tab_warning))
 			max_tab_warning = p.warning_level;
 	}
 
 
+	list_store->set_sort_column(attribute_table_columns.id, Gtk::SORT_ASCENDING);  // default sort
+	treeview->set_model(list_store);
+
+	// Trends of failure-predicting attributes over the last year, from the recorded history.
+	std::vector<AtaStorageProperty> trend_props;  // must outlive label_strings
+	std::vector<std::string> trend_texts;
+	if (drive && !drive->get_is_virtual() && !drive->get_serial_number().empty()
+			&& rconfig::get_data<bool>("gui/record_attribute_history")) {
+		AttributeHistoryTable table;
+		const int64_t from_time = int64_t(std::time(nullptr)) - 365 * 24 * 60 * 60;
+		AttributeHistoryStore(app_get_attribute_history_dir()).read_range(drive->get_serial_number(),
+				from_time, std::numeric_limits<int64_t>::max(), table);
+
+		AttributeTrendTracker tracker;
+		tracker.add_samples(table);
+		for (const auto& trend : tracker.get_trends()) {
+			if (trend.get_warning_level() == WarningLevel::none)
+				continue;
+			AtaStorageProperty p;
+			p.set_name(trend.metric.column, trend.metric.column, trend.metric.displayable_name);
+			p.set_description(_("This trend is computed from the values recorded on previous reads of this drive."));
+			p.warning_level = trend.get_warning_level();
+			trend_props.push_back(p);
+			trend_texts.push_back(trend.format());
+
+			if (int(p.warning_level) > int(max_tab_warning))
+				max_tab_warning = p.warning_level;
+		}
+	}
+	for (std::size_t i = 0; i < trend_props.size(); ++i) {
+		label_strings.emplace_back(trend_texts[i], &trend_props[i]);
+	}
+
 	auto* label_vbox = lookup_widget<Gtk::Box*>("attributes_label_vbox");
 	app_set_top_labels(label_vbox, label_strings);
 
@@ -1085,12 +1161,13 @@ void GscInfoWindow::fill_ui_statistics(const std::vector<AtaStorageProperty>& pr
 	treeview->set_tooltip_column(statistics_table_columns.tooltip.index());
 
 	model_columns.add(statistics_table_columns.storage_property);
+	model_columns.add(statistics_table_columns.row_fg);
+	model_columns.add(statistics_table_columns.row_bg);
 
 
-	// create a TreeModel (ListStore)
-	Glib::RefPtr<Gtk::ListStore> list_store = Gtk::ListStore::create(model_columns);
-	treeview->set_model(list_store);
+	// Create a TreeModel (ListStore). It's filled while detached from the treeview.
 	// No sorting (we don't want to screw up the headers).
+	Glib::RefPtr<Gtk::ListStore> list_store = Gtk::ListStore::create(model_columns);
 
 	for (int i = 0; i < int(treeview->get_n_columns()); ++i) {
 		Gtk::TreeViewColumn* tcol = treeview->get_column(i);
@@ -1124,11 +1201,14 @@ void GscInfoWindow::fill_ui_statistics(const std::vector<AtaStorageProperty>& pr
 				: hz::string_sprintf("0x%02x, 0x%03x", int(st.page), int(st.offset)));
 		row[statistics_table_columns.tooltip] = p.get_description();  // markup
 		row[statistics_table_columns.storage_property] = &p;
+		app_set_row_warning_colors(row, statistics_table_columns, p);
 
 		if (int(p.warning_level) > int(max_tab_warning))
 			max_tab_warning = p.warning_level;
 	}
 
+	treeview->set_model(list_store);
+
 	auto* label_vbox = lookup_widget<Gtk::Box*>("statistics_label_vbox");
 	app_set_top_labels(label_vbox, label_strings);
 
@@ -1262,12 +1342,13 @@ void GscInfoWindow::fill_ui_self_test_log(const std::vector<AtaStorageProperty>&
 	treeview->set_tooltip_column(self_test_log_table_columns.tooltip.index());
 
 	model_columns.add(self_test_log_table_columns.storage_property);
+	model_columns.add(self_test_log_table_columns.row_fg);
+	model_columns.add(self_test_log_table_columns.row_bg);
 
 
-	// create a TreeModel (ListStore)
+	// Create a TreeModel (ListStore). It's filled while detached from the treeview
+	// and unsorted, so that the view doesn't react to each inserted row.
 	Glib::RefPtr<Gtk::ListStore> list_store = Gtk::ListStore::create(model_columns);
-	list_store->set_sort_column(self_test_log_table_columns.log_entry_index, Gtk::SORT_ASCENDING);  // default sort
-	treeview->set_model(list_store);
 
 	for (int i = 0; i < int(treeview->get_n_columns()); ++i) {
 		Gtk::TreeViewColumn* tcol = treeview->get_column(i);
@@ -1309,12 +1390,16 @@ void GscInfoWindow::fill_ui_self_test_log(const std::vector<AtaStorageProperty>&
 		// "No description available" for all of them.
 		// row[self_test_log_table_columns.tooltip] = p.get_description();
 		row[self_test_log_table_columns.storage_property] = &p;
+		app_set_row_warning_colors(row, self_test_log_table_columns, p);
 
 		if (int(p.warning_level) > int(max_tab_warning))
 			max_tab_warning = p.warning_level;
 	}
 
 
+	list_store->set_sort_column(self_test_log_table_columns.log_entry_index, Gtk::SORT_ASCENDING);  // default sort
+	treeview->set_model(list_store);
+
 	auto* label_vbox = lookup_widget<Gtk::Box*>("selftest_log_label_vbox");
 	app_set_top_labels(label_vbox, label_strings);
 
@@ -1359,12 +1444,13 @@ void GscInfoWindow::fill_ui_error_log(const std::vector<AtaStorageProperty>& pro
 	model_columns.add(error_log_table_columns.storage_property);
 
 	model_columns.add(error_log_table_columns.mark_name);
+	model_columns.add(error_log_table_columns.row_fg);
+	model_columns.add(error_log_table_columns.row_bg);
 
 
-	// create a TreeModel (ListStore)
+	// Create a TreeModel (ListStore). It's filled while detached from the treeview
+	// and unsorted, so that the view doesn't react to each inserted row.
 	Glib::RefPtr<Gtk::ListStore> list_store = Gtk::ListStore::create(model_columns);
-	list_store->set_sort_column(error_log_table_columns.log_entry_index, Gtk::SORT_DESCENDING);  // default sort
-	treeview->set_model(list_store);
 
 	for (int i = 0; i < int(treeview->get_n_columns()); ++i) {
 		Gtk::TreeViewColumn* tcol = treeview->get_column(i);
@@ -1434,12 +1520,16 @@ void GscInfoWindow::fill_ui_error_log(const std::vector<AtaStorageProperty>& pro
 			row[error_log_table_columns.tooltip] = p.get_description();  // markup
 			row[error_log_table_columns.storage_property] = &p;
 			row[error_log_table_columns.mark_name] = Glib::ustring::compose(_("Error %1"), eb.error_num);
+			app_set_row_warning_colors(row, error_log_table_columns, p);
 		}
 
 		if (int(p.warning_level) > int(max_tab_warning))
 			max_tab_warning = p.warning_level;
 	}
 
+	list_store->set_sort_column(error_log_table_columns.log_entry_index, Gtk::SORT_DESCENDING);  // default sort
+	treeview->set_model(list_store);
+
 	auto* label_vbox = lookup_widget<Gtk::Box*>("error_log_label_vbox");
 	app_set_top_labels(label_vbox, label_strings);
 
@@ -1461,6 +1551,11 @@ void GscInfoWindow::fill_ui_temperature_log(const std::vector<AtaStorageProperty
 	enum { temp_attr2 = 1, temp_attr1, temp_stat, temp_sct };  // less important to more important
 	int temp_prop_source = 0;
 
+	// If the history table was decoded (and is shown in the graph), the text holds only the SCT status.
+	const bool history_decoded = std::any_of(props.begin(), props.end(), [](const AtaStorageProperty& p) {
+		return p.generic_name == "ata_sct_temperature_history/table";
+	});
+
 	for (const auto& p : props) {
 		// Find temperature
 		if (temp_prop_source < temp_sct && p.generic_name == "ata_sct_status/temperature/current") {
@@ -1497,13 +1592,22 @@ void GscInfoWindow::fill_ui_temperature_log(const std::vector<AtaStorageProperty
 		// Note: Don't use property description as a tooltip here. It won't be available if there's no property.
 		if (p.generic_name == "ata_sct_status/_and/ata_sct_temperature_history/_merged") {
 			Glib::RefPtr<Gtk::TextBuffer> buffer = textview->get_buffer();
-			buffer->set_text("\n" + Glib::ustring::compose(_("Complete SCT temperature log: %1"), "\n\n" + p.get_value<std::string>()));
+			const char* title = (history_decoded ? _("SCT temperature status: %1") : _("Complete SCT temperature log: %1"));
+			buffer->set_text("\n" + Glib::ustring::compose(title, "\n\n" + p.get_value<std::string>()));
 
 			// Make the text monospace (the 3.16+ glade property does not work anymore for some reason).
 			Glib::RefPtr<Gtk::TextTag> tag = buffer->create_tag();
 			tag->property_family() = "Monospace";
 			buffer->apply_tag(tag, buffer->begin(), buffer->end());
 		}
+
+		if (p.generic_name == "ata_sct_temperature_history/table") {
+			temperature_history = p.get_value<AtaStorageTemperatureHistory>();
+			if (auto* graph = lookup_widget<Gtk::DrawingArea*>("temperature_log_graph")) {
+				graph->set_visible(!temperature_history.samples.empty());
+				graph->queue_draw();
+			}
+		}
 	}
 
 	if (temperature.empty()) {
@@ -1727,11 +1831,10 @@ WarningLevel GscInfoWindow::fill_ui_directory(const std::vector<AtaStorageProper
 
 
 
-/// Set cell renderer's foreground and background colors according to property warning level.
-inline void cell_renderer_set_warning_fg_bg(Gtk::CellRendererText* crt, const AtaStorageProperty& p)
+/// Set cell renderer's foreground and background colors. Empty colors reset them to default.
+inline void cell_renderer_set_fg_bg(Gtk::CellRendererText* crt, const std::string& fg, const std::string& bg)
 {
-	std::string fg, bg;
-	if (app_property_get_row_highlight_colors(p.warning_level, fg, bg)) {
+	if (!fg.empty()) {
 		// Note: property_cell_background makes horizontal tree lines disappear around it,
 		// but property_background doesn't play nice with sorted column color.
 		crt->property_cell_background() = bg;
@@ -1746,6 +1849,16 @@ inline void cell_renderer_set_warning_fg_bg(Gtk::CellRendererText* crt, const At
 
 
 
+/// Set cell renderer's foreground and background colors according to property warning level.
+inline void cell_renderer_set_warning_fg_bg(Gtk::CellRendererText* crt, const AtaStorageProperty& p)
+{
+	std::string fg, bg;
+	app_property_get_row_highlight_colors(p.warning_level, fg, bg);
+	cell_renderer_set_fg_bg(crt, fg, bg);
+}
+
+
+
 void GscInfoWindow::cell_renderer_for_attributes(Gtk::CellRenderer* cr,
 		const Gtk::TreeModel::iterator& iter, [[maybe_unused]] int column_index) const
 {
@@ -1753,7 +1866,7 @@ void GscInfoWindow::cell_renderer_for_attributes(Gtk::CellRenderer* cr,
 	const auto& attribute = prop->get_value<AtaStorageAttribute>();
 
 	if (auto* crt = dynamic_cast<Gtk::CellRendererText*>(cr)) {
-		cell_renderer_set_warning_fg_bg(crt, *prop);
+		cell_renderer_set_fg_bg(crt, (*iter)[this->attribute_table_columns.row_fg], (*iter)[this->attribute_table_columns.row_bg]);
 
 		if (column_index == attribute_table_columns.displayable_name.index()) {
 			crt->property_weight() = Pango::WEIGHT_BOLD;
@@ -1802,7 +1915,7 @@ void GscInfoWindow::cell_renderer_for_statistics(Gtk::CellRenderer* cr,
 	const auto& statistic = prop->get_value<AtaStorageStatistic>();
 
 	if (auto* crt = dynamic_cast<Gtk::CellRendererText*>(cr)) {
-		cell_renderer_set_warning_fg_bg(crt, *prop);
+		cell_renderer_set_fg_bg(crt, (*iter)[this->statistics_table_columns.row_fg], (*iter)[this->statistics_table_columns.row_bg]);
 
 		if (statistic.is_header) {  // subheader
 			crt->property_weight() = Pango::WEIGHT_BOLD;
@@ -1828,10 +1941,8 @@ void GscInfoWindow::cell_renderer_for_statistics(Gtk::CellRenderer* cr,
 void GscInfoWindow::cell_renderer_for_self_test_log(Gtk::CellRenderer* cr,
 		const Gtk::TreeModel::iterator& iter, [[maybe_unused]] int column_index) const
 {
-	const AtaStorageProperty* prop = (*iter)[this->self_test_log_table_columns.storage_property];
-
 	if (auto* crt = dynamic_cast<Gtk::CellRendererText*>(cr)) {
-		cell_renderer_set_warning_fg_bg(crt, *prop);
+		cell_renderer_set_fg_bg(crt, (*iter)[this->self_test_log_table_columns.row_fg], (*iter)[this->self_test_log_table_columns.row_bg]);
 
 		if (column_index == self_test_log_table_columns.log_entry_index.index()) {
 			crt->property_weight() = Pango::WEIGHT_BOLD;
@@ -1859,10 +1970,8 @@ void GscInfoWindow::cell_renderer_for_self_test_log(Gtk::CellRenderer* cr,
 void GscInfoWindow::cell_renderer_for_error_log(Gtk::CellRenderer* cr,
 		const Gtk::TreeModel::iterator& iter, [[maybe_unused]] int column_index) const
 {
-	const AtaStorageProperty* prop = (*iter)[this->error_log_table_columns.storage_property];
-
 	if (auto* crt = dynamic_cast<Gtk::CellRendererText*>(cr)) {
-		cell_renderer_set_warning_fg_bg(crt, *prop);
+		cell_renderer_set_fg_bg(crt, (*iter)[this->error_log_table_columns.row_fg], (*iter)[this->error_log_table_columns.row_bg]);
 
 		if (column_index == error_log_table_columns.log_entry_index.index()) {
 			crt->property_weight() = Pango::WEIGHT_BOLD;
@@ -2176,10 +2285,51 @@ void GscInfoWindow::on_test_stop_button_clicked()
 // We don't refresh automatically (that would make it impossible to do
 // several same-drive info window comparisons side by side).
 // But we need to look for testing status change, to avoid aborting it.
-void GscInfoWindow::on_drive_changed([[maybe_unused]] StorageDevice* pdrive)
+void GscInfoWindow::on_drive_parsed(StorageDevicePtr parsed_drive, std::string error_msg, bool applied, bool clear_tests)
+{
+	if (parsed_drive != drive)  // set_drive() was called in the meantime
+		return;
+
+	// The drive data was replaced while parsing (e.g. by a rescan, with the basic data only).
+	// Keep showing what we have, the user may refresh again.
+	if (!applied) {
+		debug_out_info("app", DBG_FUNC_MSG << "The data was replaced while parsing, not filling the window.\n");
+		this->set_sensitive(true);
+		return;
+	}
+
+	if (!error_msg.empty()) {
+		gsc_executor_error_dialog_show(_("Cannot retrieve SMART data"), error_msg, this);
+		this->set_sensitive(true);
+		return;
+	}
+
+	if (rconfig::get_data<bool>("gui/record_attribute_history")) {
+		AttributeHistoryStore(app_get_attribute_history_dir()).append_drive(*drive);
+	}
+
+	this->fill_ui_with_info(false, false, clear_tests);  // cleared before reading
+}
+
+
+
+void GscInfoWindow::on_drive_changed([[maybe_unused]] StorageDevice* pdrive, int changes)
 {
 	if (!drive)
 		return;
+
+	// The drive was reparsed by someone else (e.g. a watched virtual drive file changed,
+	// or a rescan). Our own refreshes fill the UI when parsed, and are not repeated here.
+	if ((changes & StorageDevice::change_properties) != 0 && drive->get_info_output_shared() != displayed_info_output) {
+		auto main_window = GscMainWindow::instance();
+		if (this->get_sensitive() && (!main_window || !main_window->get_parse_queue().is_parsing(drive))) {
+			debug_out_info("app", DBG_FUNC_MSG << "Drive data changed, refilling the window.\n");
+			this->fill_ui_with_info(false, true, false);
+		}
+	}
+
+	if ((changes & StorageDevice::change_test_state) == 0)
+		return;
 	const bool test_active = drive->get_test_is_active();
 
 	// disable refresh button if test is active or if it's a virtual drive
@@ -2254,6 +2404,75 @@ void GscInfoWindow::on_treeview_menu_copy_clicked(Gtk::TreeView* treeview)
 
 
 
+bool GscInfoWindow::on_temperature_log_graph_draw(const Cairo::RefPtr<Cairo::Context>& cr)
+{
+	auto* graph = lookup_widget<Gtk::DrawingArea*>("temperature_log_graph");
+	const auto all_min_max = temperature_history.get_min_max();
+	if (!graph || all_min_max.min == AtaStorageTemperatureHistory::unknown_temperature) {
+		return false;
+	}
+
+	const int margin_left = 48, margin_right = 8, margin_top = 8, margin_bottom = 20;
+	const int plot_width = graph->get_allocated_width() - margin_left - margin_right;
+	const int plot_height = graph->get_allocated_height() - margin_top - margin_bottom;
+	if (plot_width <= 0 || plot_height <= 0) {
+		return false;
+	}
+
+	// Round the temperature range to 10 degrees
+	const int range_min = (int(all_min_max.min) < 0 ? (int(all_min_max.min) - 9) / 10 : int(all_min_max.min) / 10) * 10;
+	const int range_max = std::max(range_min + 10, (int(all_min_max.max) + 10) / 10 * 10);
+	auto temp_to_y = [&](int temp) {
+		return margin_top + plot_height - double(temp - range_min) * plot_height / (range_max - range_min);
+	};
+
+	const Gdk::RGBA text_color = graph->get_style_context()->get_color(graph->get_state_flags());
+
+	// Axes and labels
+	Gdk::Cairo::set_source_rgba(cr, text_color);
+	cr->set_line_width(1.);
+	cr->rectangle(margin_left - 0.5, margin_top - 0.5, plot_width + 1, plot_height + 1);
+	cr->stroke();
+
+	auto draw_text = [&cr](double x, double y, const std::string& text) {
+		cr->move_to(x, y);
+		cr->show_text(text);
+	};
+	draw_text(4, temp_to_y(range_max) + 10, Glib::ustring::compose(C_("temperature", "%1 °C"), range_max));
+	draw_text(4, temp_to_y(range_min), Glib::ustring::compose(C_("temperature", "%1 °C"), range_min));
+
+	if (temperature_history.start_time != 0) {
+		auto format_time = [](int64_t t) {
+			return std::string(Glib::DateTime::create_now_local(t).format("%Y-%m-%d %H:%M"));
+		};
+		const std::size_t last_index = temperature_history.samples.size() - 1;
+		draw_text(margin_left, margin_top + plot_height + 14, format_time(temperature_history.start_time));
+		const std::string end_text = format_time(temperature_history.get_sample_time(last_index));
+		Cairo::TextExtents extents;
+		cr->get_text_extents(end_text, extents);
+		draw_text(margin_left + plot_width - extents.x_advance, margin_top + plot_height + 14, end_text);
+	}
+
+	// One vertical line per pixel column, spanning the minimum and maximum temperatures of its samples.
+	const auto buckets = temperature_history.downsample_min_max(std::size_t(plot_width));
+	const double column_width = double(plot_width) / double(buckets.size());
+	cr->set_source_rgb(0.8, 0.1, 0.1);
+	cr->set_line_width(std::max(1., column_width));
+	for (std::size_t i = 0; i < buckets.size(); ++i) {
+		if (buckets[i].min == AtaStorageTemperatureHistory::unknown_temperature) {
+			continue;  // gap
+		}
+		const double x = margin_left + (double(i) + 0.5) * column_width;
+		cr->move_to(x, temp_to_y(buckets[i].max) - 0.5);
+		cr->line_to(x, temp_to_y(buckets[i].min) + 0.5);
+	}
+	cr->stroke();
+
+	return true;
+}
+
+
+
 
 
 
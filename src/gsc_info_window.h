@@ -14,6 +14,7 @@ Copyright:
 
 #include <gtkmm.h>
 #include <map>
+#include <vector>
 
 #include "applib/app_builder_widget.h"
 #include "applib/storage_device.h"
@@ -156,8 +157,11 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 		void on_test_stop_button_clicked();
 
 
+		/// Parse queue callback, fills the UI with the freshly read data (if it was applied)
+		void on_drive_parsed(StorageDevicePtr parsed_drive, std::string error_msg, bool applied, bool clear_tests);
+
 		/// Callback attached to StorageDevice change signal.
-		void on_drive_changed(StorageDevice* pdrive);
+		void on_drive_changed(StorageDevice* pdrive, int changes);
 
 		/// Callback
 		bool on_treeview_button_press_event(GdkEventButton* button_event, Gtk::Menu* menu, Gtk::TreeView* treeview);
@@ -165,6 +169,9 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 		/// Callback
 		void on_treeview_menu_copy_clicked(Gtk::TreeView* treeview);
 
+		/// Draw the SCT temperature history graph
+		bool on_temperature_log_graph_draw(const Cairo::RefPtr<Cairo::Context>& cr);
+
 
 	private:
 
@@ -200,6 +207,12 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 
 		StorageDevicePtr drive;  ///< The drive we're showing
 
+		/// Copy of the drive properties shown in the tables. The tree models point to its
+		/// elements, so it's only replaced when the tables are refilled.
+		std::vector<AtaStorageProperty> displayed_properties;
+
+		SharedOutput displayed_info_output;  ///< The drive output the tables were filled from
+
 		std::shared_ptr<SelfTest> current_test;  ///< Currently running test, or 0.
 
 		// Test idle callback temporaries
@@ -208,6 +221,8 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 		Glib::Timer test_timer_bar;  ///< Timer for testing phase
 		bool test_force_bar_update = false;  ///< Helper for testing callback
 
+		AtaStorageTemperatureHistory temperature_history;  ///< SCT temperature history shown in the graph
+
 		/// Attributes table model columns
 		struct {
 			Gtk::TreeModelColumn<int32_t> id;
@@ -222,6 +237,8 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 			Gtk::TreeModelColumn<std::string> flag_value;
 			Gtk::TreeModelColumn<Glib::ustring> tooltip;
 			Gtk::TreeModelColumn<const AtaStorageProperty*> storage_property;
+			Gtk::TreeModelColumn<std::string> row_fg;  ///< Precomputed warning foreground color, empty if none
+			Gtk::TreeModelColumn<std::string> row_bg;  ///< Precomputed warning background color, empty if none
 		} attribute_table_columns;
 
 		/// Statistics table model columns
@@ -232,6 +249,8 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 			Gtk::TreeModelColumn<std::string> page_offset;
 			Gtk::TreeModelColumn<Glib::ustring> tooltip;
 			Gtk::TreeModelColumn<const AtaStorageProperty*> storage_property;
+			Gtk::TreeModelColumn<std::string> row_fg;  ///< Precomputed warning foreground color, empty if none
+			Gtk::TreeModelColumn<std::string> row_bg;  ///< Precomputed warning background color, empty if none
 		} statistics_table_columns;
 
 		/// Self-test log table model columns
@@ -244,6 +263,8 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 			Gtk::TreeModelColumn<std::string> lba;
 			Gtk::TreeModelColumn<Glib::ustring> tooltip;
 			Gtk::TreeModelColumn<const AtaStorageProperty*> storage_property;
+			Gtk::TreeModelColumn<std::string> row_fg;  ///< Precomputed warning foreground color, empty if none
+			Gtk::TreeModelColumn<std::string> row_bg;  ///< Precomputed warning background color, empty if none
 		} self_test_log_table_columns;
 
 		/// Error log table model columns
@@ -255,6 +276,8 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 			Gtk::TreeModelColumn<std::string> details;
 			Gtk::TreeModelColumn<Glib::ustring> tooltip;
 			Gtk::TreeModelColumn<const AtaStorageProperty*> storage_property;
+			Gtk::TreeModelColumn<std::string> row_fg;  ///< Precomputed warning foreground color, empty if none
+			Gtk::TreeModelColumn<std::string> row_bg;  ///< Precomputed warning background color, empty if none
 			Gtk::TreeModelColumn<Glib::ustring> mark_name;
 		} error_log_table_columns;
 
@@ -22,6 +22,8 @@ Copyright:
 #include <memory>
 #include <cmath>
 #include <iostream>
+#include <mutex>
+#include <chrono>
 
 
 
@@ -78,17 +80,56 @@ namespace {
 		return channel;
 	}
 
+
+
+	/// Measures the startup phases, to see what delays the main window appearance.
+	class StartupTimer {
+		public:
+
+			/// Log the duration of the phase ended now (it started when the previous one ended).
+			void phase_done(const char* phase)
+			{
+				const auto now = std::chrono::steady_clock::now();
+				debug_out_info("app", "Startup: " << phase << " took "
+						<< std::chrono::duration_cast<std::chrono::milliseconds>(now - last_).count() << " ms ("
+						<< std::chrono::duration_cast<std::chrono::milliseconds>(now - start_).count() << " ms since start).\n");
+				last_ = now;
+			}
+
+		private:
+
+			std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();  ///< Startup time
+			std::chrono::steady_clock::time_point last_ = start_;  ///< End of the previous phase
+
+	};
+
 }
 
 
 
 std::string app_get_debug_buffer_str()
 {
+	// Worker threads may be writing to it
+	const std::lock_guard<std::recursive_mutex> lock(debug_internal::get_debug_out_mutex());
 	return get_debug_buf_channel_stream().str();
 }
 
 
 
+hz::fs::path app_get_device_cache_file()
+{
+	return get_home_config_file().parent_path() / "device_cache.json";
+}
+
+
+
+hz::fs::path app_get_attribute_history_dir()
+{
+	return get_home_config_file().parent_path() / "history";
+}
+
+
+
 
 
 namespace {
@@ -207,6 +248,7 @@ namespace {
 		gboolean arg_hide_tabs = TRUE;  ///< if true, hide additional info tabs when smart is disabled. false may help debugging.
 		gchar** arg_add_virtual = nullptr;  ///< load smartctl data from these files as virtual drives
 		gchar** arg_add_device = nullptr;  ///< add these device files manually
+		gchar* arg_watch_virtual = nullptr;  ///< watch this directory for smartctl data files, loading them as virtual drives
 		double arg_gdk_scale = std::numeric_limits<double>::quiet_NaN();  ///< The value of GDK_SCALE environment variable
 		double arg_gdk_dpi_scale = std::numeric_limits<double>::quiet_NaN();  ///< The value of GDK_DPI_SCALE environment variable
 	};
@@ -226,11 +268,15 @@ namespace {
 			{ "no-hide-tabs", '\0', G_OPTION_FLAG_REVERSE, G_OPTION_ARG_NONE, &(args.arg_hide_tabs),
 					N_("Don't hide non-identity tabs when SMART is disabled. Useful for debugging."), nullptr },
 			{ "add-virtual", '\0', 0, G_OPTION_ARG_FILENAME_ARRAY, &(args.arg_add_virtual),
-					N_("Load smartctl data from file, creating a virtual drive. You can specify this option multiple times."), nullptr },
+					N_("Load smartctl data from file, creating a virtual drive. Directories and wildcard patterns load all the matching files."
+					" You can specify this option multiple times."), nullptr },
 			{ "add-device", '\0', 0, G_OPTION_ARG_FILENAME_ARRAY, &(args.arg_add_device),
 					N_("Add this device to device list. The format of the device is \"<device>::<type>::<extra_args>\", where type and extra_args are optional."
 					" This option is useful with --no-scan to list certain drives only. You can specify this option multiple times."
 					" Example: --add-device /dev/sda --add-device /dev/twa0::3ware,2 --add-device '/dev/sdb::::-T permissive'"), nullptr },
+			{ "watch-virtual", '\0', 0, G_OPTION_ARG_FILENAME, &(args.arg_watch_virtual),
+					N_("Load smartctl data files from this directory as virtual drives, and reload them when they change"
+					" (e.g. when written by cron jobs on other hosts). Linux only."), nullptr },
 #ifndef _WIN32
 			// X11-specific
 			{ "gdk-scale", 'l', 0, G_OPTION_ARG_DOUBLE, &(args.arg_gdk_scale),
@@ -298,6 +344,8 @@ namespace {
 
 bool app_init_and_loop(int& argc, char**& argv)
 {
+	StartupTimer startup_timer;
+
 	if constexpr(BuildEnv::is_kernel_family_windows()) {
 		std::string csd_value;
 		if (!hz::env_get_value("GTK_CSD", csd_value)) {  // if not set
@@ -353,6 +401,9 @@ bool app_init_and_loop(int& argc, char**& argv)
 	// Add special debug channel to collect all libdebug output into a buffer.
 	debug_add_channel("all", debug_level::get_all_flags(), get_debug_buf_channel());
 
+	// Nothing could be logged before the domains were registered.
+	startup_timer.phase_done("Command line parsing and GTK initialization");
+
 
 
 	std::vector<std::string> load_virtuals;
@@ -382,6 +433,7 @@ bool app_init_and_loop(int& argc, char**& argv)
 		<< "\tscan: " << args.arg_scan << "\n"
 		<< "\targ_add_virtual: " << (load_virtuals_str.empty() ? "[empty]" : load_virtuals_str) << "\n"
 		<< "\targ_add_device: " << (load_devices_str.empty() ? "[empty]" : load_devices_str) << "\n"
+		<< "\targ_watch_virtual: " << (args.arg_watch_virtual ? args.arg_watch_virtual : "[empty]") << "\n"
 		<< "\targ_gdk_scale: " << args.arg_gdk_scale << "\n"
 		<< "\targ_gdk_dpi_scale: " << args.arg_gdk_dpi_scale << "\n");
 
@@ -399,6 +451,7 @@ bool app_init_and_loop(int& argc, char**& argv)
 
 	// Load config files
 	app_init_config();
+	startup_timer.phase_done("Config loading");
 
 
 	// Redirect all GTK+/Glib and related messages to libdebug.
@@ -534,14 +587,16 @@ bool app_init_and_loop(int& argc, char**& argv)
 	// add devices to the list on startup if specified.
 	get_startup_settings().add_devices = load_devices;
 
+	// watch a directory of virtual drive files if specified.
+	get_startup_settings().watch_virtual_dir = (args.arg_watch_virtual ? args.arg_watch_virtual : "");
+
 	// hide tabs if SMART is disabled
 	get_startup_settings().hide_tabs_on_smart_disabled = bool(args.arg_hide_tabs);
 
 
-	// Create executor log window, but don't show it.
-	// It will track all command executor outputs.
-	// The window is destroyed by the instance manager.
-	GscExecutorLogWindow::create();
+	// Track all command executor outputs. The executor log window is created
+	// when it's first shown, and displays the outputs recorded before that.
+	GscExecutorLogWindow::start_logging();
 
 
 	// Open the main window.
@@ -552,6 +607,12 @@ bool app_init_and_loop(int& argc, char**& argv)
 			debug_out_fatal("app", "Cannot create the main window. Exiting.\n");
 			return false;  // cannot create main window
 		}
+		startup_timer.phase_done("UI setup and main window creation");
+
+		// The window is drawn in the first main loop iteration
+		Glib::signal_idle().connect_once([&startup_timer]() {
+			startup_timer.phase_done("First main loop iteration");
+		});
 
 		// first-boot message
 		// app_show_first_boot_message(win);
@@ -14,6 +14,8 @@ Copyright:
 
 #include <string>
 
+#include "hz/fs_ns.h"
+
 
 /// Initialize the application and run the main loop
 bool app_init_and_loop(int& argc, char**& argv);
@@ -28,6 +30,14 @@ void app_quit();
 std::string app_get_debug_buffer_str();
 
 
+/// Get the drive cache file, located next to the config file in user's HOME
+hz::fs::path app_get_device_cache_file();
+
+
+/// Get the directory with per-drive attribute history files, located next to the config file
+hz::fs::path app_get_attribute_history_dir();
+
+
 
 #endif
 
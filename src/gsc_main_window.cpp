@@ -12,7 +12,9 @@ Copyright:
 #include "local_glibmm.h"
 #include <gtkmm.h>
 #include <vector>
+#include <algorithm>  // std::find_if
 #include <memory>
+#include <utility>  // std::exchange
 
 #include "hz/string_algo.h"  // string_split
 #include "hz/string_num.h"
@@ -21,6 +23,11 @@ Copyright:
 #include "hz/fs.h"
 #include "rconfig/rconfig.h"
 #include "applib/storage_detector.h"
+#include "applib/storage_detector_linux.h"  // linux_get_platform_blacklist_match()
+#include "applib/storage_detector_linux_sysfs.h"
+#include "applib/storage_device_cache.h"
+#include "applib/attribute_history.h"
+#include "applib/prometheus_exporter.h"
 #include "applib/gui_utils.h"  // gui_show_error_dialog
 #include "applib/smartctl_executor.h"  // get_smartctl_binary()
 #include "applib/smartctl_executor_gui.h"
@@ -29,7 +36,7 @@ Copyright:
 #include "applib/app_pcrecpp.h"  // app_pcre_match
 #include "applib/smartctl_version_parser.h"
 
-#include "gsc_init.h"  // app_quit()
+#include "gsc_init.h"  // app_quit(), app_get_device_cache_file(), app_get_attribute_history_dir()
 #include "gsc_about_dialog.h"
 #include "gsc_info_window.h"
 #include "gsc_preferences_window.h"
@@ -47,6 +54,16 @@ Copyright:
 using namespace std::literals;
 
 
+
+namespace {
+
+	/// Checked for every drive when populating the icon view
+	const rconfig::Key<bool> show_smart_capable_only_key("gui/show_smart_capable_only");
+
+}
+
+
+
 GscMainWindow::GscMainWindow(BaseObjectType* gtkcobj, Glib::RefPtr<Gtk::Builder> ui)
 		: AppBuilderWidget<GscMainWindow, false>(gtkcobj, std::move(ui))
 {
@@ -104,7 +121,7 @@ GscMainWindow::GscMainWindow(BaseObjectType* gtkcobj, Glib::RefPtr<Gtk::Builder>
 		ex.set_running_msg(_("Checking if smartctl is executable..."));
 
 // 		ex.set_command(Glib::shell_quote(smartctl_binary), smartctl_def_options + "-V");  // --version
-		ex.set_command(Glib::shell_quote(smartctl_binary), "-V");  // --version
+		ex.set_command_argv({smartctl_binary, "-V"});  // --version
 
 		if (!ex.execute() || !ex.get_error_msg().empty()) {
 			error_msg = ex.get_error_msg();
@@ -157,6 +174,10 @@ GscMainWindow::~GscMainWindow()
 	// causing crash on exit.
 	// iconview_->clear_all();
 	delete iconview_;
+	metrics_export_conn_.disconnect();
+	virtual_dir_idle_conn_.disconnect();
+	bulk_loader_.reset();  // wait for the workers
+	parse_queue_.cancel_all();
 }
 
 
@@ -171,7 +192,21 @@ void GscMainWindow::populate_iconview(bool smartctl_valid)
 
 	} else if (rconfig::get_data<bool>("gui/scan_on_startup")  // config option
 			&& !get_startup_settings().no_scan) {  // command-line option
-		rescan_devices();  // scan for devices and fill the iconview
+		// Show the drives known from the last run immediately, then revalidate them with
+		// a rescan. The rescan runs smartctl in this thread, but keeps the main loop
+		// running, so the window stays responsive and the icons update as each drive is probed.
+		if (rconfig::get_data<bool>("gui/use_device_cache")) {
+			const bool smart_capable_only = show_smart_capable_only_key.get();
+			for (auto& drive : storage_device_cache_load(app_get_device_cache_file())) {
+				this->drives_.push_back(drive);
+				if (!smart_capable_only || drive->get_smart_status() != StorageDevice::Status::unsupported) {
+					iconview_->add_entry(drive);
+				}
+			}
+			while (Gtk::Main::events_pending())  // give expose event the time it needs
+				Gtk::Main::iteration();
+		}
+		rescan_devices(true);  // scan for devices and fill the iconview
 
 	} else {
 		iconview_->set_empty_view_message(GscMainWindowIconView::Message::scan_disabled);
@@ -197,9 +232,26 @@ void GscMainWindow::populate_iconview(bool smartctl_valid)
 		}
 	}
 
-	for (auto&& virt : get_startup_settings().load_virtuals) {
-		if (!virt.empty()) {
-			add_virtual_drive(virt);
+	add_virtual_drives(get_startup_settings().load_virtuals);
+
+	std::string watch_dir = get_startup_settings().watch_virtual_dir;
+	if (watch_dir.empty()) {
+		watch_dir = rconfig::get_data<std::string>("gui/virtual_drive_watch_dir");
+	}
+	if (!watch_dir.empty()) {
+		watch_virtual_directory(watch_dir);
+	}
+
+	// Watch for hotplugged drives, so that they are added without a full rescan.
+	if constexpr(BuildEnv::is_kernel_linux()) {
+		if (smartctl_valid && rconfig::get_data<bool>("gui/hotplug_monitor")) {
+			uevent_monitor_ = std::make_unique<UeventMonitor>();
+			if (uevent_monitor_->open()) {
+				uevent_monitor_->signal_block_device_event().connect(
+						sigc::mem_fun(*this, &GscMainWindow::on_block_device_event));
+			} else {
+				uevent_monitor_.reset();
+			}
 		}
 	}
 
@@ -536,9 +588,7 @@ void GscMainWindow::on_action_activated(GscMainWindow::action_t action_type)
 
 		case action_perform_tests:
 			if (iconview_) {
-				auto win = this->show_device_info_window(iconview_->get_selected_drive());
-				if (win)  // won't be created if test is already running
-					win->show_tests();
+				this->show_device_info_window(iconview_->get_selected_drive(), true);
 			}
 			break;
 
@@ -574,9 +624,11 @@ void GscMainWindow::on_action_activated(GscMainWindow::action_t action_type)
 		case action_executor_log:
 		{
 			// this one will only hide on close.
-			auto win = GscExecutorLogWindow::create();  // probably already created
+			auto win = GscExecutorLogWindow::create();  // created on first use
 			// win->set_transient_for(*this);  // don't do this - it will make it always-on-top of this.
-			win->show_last();  // show the window and select last entry
+			if (win) {
+				win->show_last();  // show the window and select last entry
+			}
 			break;
 		}
 
@@ -588,7 +640,11 @@ void GscMainWindow::on_action_activated(GscMainWindow::action_t action_type)
 
 		case action_preferences:
 		{
-			auto win = GscPreferencesWindow::create();  // destroyed on close
+			auto win = GscPreferencesWindow::create();  // created on first use, hidden on close
+			if (!win) {
+				break;
+			}
+			win->import_config();  // the window may have been used before, discard its old state
 			win->set_transient_for(*this);  // for "destroy with parent", always-on-top
 			win->set_main_window(this);
 			win->set_modal(true);
@@ -980,7 +1036,61 @@ void GscMainWindow::update_status_widgets()
 
 
 
-void GscMainWindow::rescan_devices()
+void GscMainWindow::schedule_metrics_export(const StorageDevice* changed_drive)
+{
+	if (rconfig::get_data<std::string>("system/prometheus_textfile").empty()) {
+		return;
+	}
+	// Remember the attributes now, a later basic re-parse (e.g. in a rescan) drops them.
+	if (changed_drive && !changed_drive->get_is_virtual()) {
+		if (auto full_data = PrometheusTextExporter::get_full_data(*changed_drive)) {
+			metrics_full_data_[changed_drive->get_device_with_type()] = std::move(full_data.value());
+		}
+	}
+	if (metrics_export_conn_.connected()) {
+		return;
+	}
+	// Drives often change in bursts (rescans, refreshes), write the file once per burst.
+	metrics_export_conn_ = Glib::signal_timeout().connect_seconds(
+			sigc::mem_fun(*this, &GscMainWindow::on_metrics_export_timeout), 2);
+}
+
+
+
+bool GscMainWindow::on_metrics_export_timeout()
+{
+	const auto file = hz::fs::u8path(rconfig::get_data<std::string>("system/prometheus_textfile"));
+	if (file.empty()) {
+		return false;
+	}
+
+	PrometheusTextExporter exporter;
+	std::map<std::string, PrometheusTextExporter::FullData> shown_full_data;
+	for (const auto& drive : drives_) {
+		if (drive->get_is_virtual()) {
+			continue;
+		}
+		const std::string device = drive->get_device_with_type();
+		if (auto full_data = PrometheusTextExporter::get_full_data(*drive)) {
+			metrics_full_data_[device] = std::move(full_data.value());
+		}
+		auto full_data_iter = metrics_full_data_.find(device);
+		if (full_data_iter != metrics_full_data_.end()) {
+			exporter.add_drive(*drive, &full_data_iter->second);
+			shown_full_data.insert(*full_data_iter);
+		} else {
+			exporter.add_drive(*drive);
+		}
+	}
+	metrics_full_data_ = std::move(shown_full_data);  // forget the removed drives
+	exporter.write_file(file);
+
+	return false;  // one-shot
+}
+
+
+
+void GscMainWindow::rescan_devices(bool refetch_known)
 {
 	// ignore double-scan (may happen because we use gtk loop iterations here).
 	if (this->scanning_)
@@ -1015,12 +1125,16 @@ void GscMainWindow::rescan_devices()
 
 	iconview_->set_empty_view_message(GscMainWindowIconView::Message::scanning);
 
-	iconview_->clear_all();  // clear previous icons, invalidate region to update the message.
+	// The drives are kept (with all their data) if they haven't changed, so the
+	// icons are updated in place. If the preferences have changed, start from scratch.
+	if (full_rescan_needed_) {
+		iconview_->clear_all();  // clear previous icons, invalidate region to update the message.
+		this->drives_.clear();
+		full_rescan_needed_ = false;
+	}
 	while (Gtk::Main::events_pending())  // give expose event the time it needs
 		Gtk::Main::iteration();
 
-	this->drives_.clear();
-
 	// populate the icon area with drive icons
 	StorageDetector sd;
 // 	sd.add_match_patterns(match_patterns);
@@ -1029,7 +1143,9 @@ void GscMainWindow::rescan_devices()
 
 	auto ex_factory = std::make_shared<CommandExecutorFactory>(true, this);  // run it with GUI support
 
-	std::string error_msg = sd.detect_and_fetch_basic_data(drives_, ex_factory);
+	std::vector<StorageDevicePtr> scanned_drives;
+	std::string error_msg = sd.detect_and_fetch_basic_data_incremental(scanned_drives, drives_, ex_factory, refetch_known);
+	this->drives_ = scanned_drives;
 
 	bool error = false;
 
@@ -1047,6 +1163,7 @@ void GscMainWindow::rescan_devices()
 		}
 	}
 
+	std::vector<StorageDevicePtr> shown_drives;
 	if (!error && !error_msg.empty()) {  // generic scan error. smartctl errors are not reported during scan at all.
 		// we don't show output button here
 		gsc_executor_error_dialog_show(_("An error occurred while scanning the system"),
@@ -1056,21 +1173,336 @@ void GscMainWindow::rescan_devices()
 	// add them anyway, in case the error was only on one drive.
 	} else { // if (!error) {
 		// add them to iconview
+		const bool smart_capable_only = show_smart_capable_only_key.get();
 		for (auto& drive : drives_) {
-			if (rconfig::get_data<bool>("gui/show_smart_capable_only")) {
-				if (drive->get_smart_status() != StorageDevice::Status::unsupported)
-					iconview_->add_entry(drive);
-			} else {
-				iconview_->add_entry(drive);
+			if (!smart_capable_only || drive->get_smart_status() != StorageDevice::Status::unsupported) {
+				shown_drives.push_back(drive);
 			}
 		}
 	}
+	iconview_->update_entries(shown_drives);
 
 	// in case there are no drives in the system.
 	if (iconview_->get_num_icons() == 0)
 		iconview_->set_empty_view_message(GscMainWindowIconView::Message::no_drives_found);
 
 	this->scanning_ = false;
+
+	// The hotplug events which arrived during the scan
+	process_block_device_events();
+
+	// The cache is written once per scan, when the drive list is final. Later hotplug
+	// changes are not saved, the next scan revalidates the drives anyway.
+	if (error_msg.empty() && rconfig::get_data<bool>("gui/use_device_cache")) {
+		storage_device_cache_save(app_get_device_cache_file(), drives_);
+	}
+
+	// The virtual drives loaded in the background during the scan
+	const auto held_drives = std::exchange(bulk_loader_held_drives_, {});
+	for (const auto& [drive, replaced_drive] : held_drives) {
+		on_bulk_virtual_drive_loaded(drive, replaced_drive);
+	}
+	if (std::exchange(bulk_loader_held_finish_, false)) {
+		on_bulk_virtual_loading_finished();
+	} else if (!held_drives.empty()) {
+		iconview_->update_menu_actions();
+		this->update_status_widgets();
+	}
+
+	// The drives of the watched directory were dropped with the rest, load them again.
+	if (virtual_dir_watcher_ && virtual_dir_watcher_->is_open()) {
+		virtual_dir_stamps_.clear();
+		queue_virtual_directory_files();
+	}
+
+	// The drives which disappeared don't notify anyone
+	schedule_metrics_export();
+}
+
+
+
+void GscMainWindow::on_block_device_event(const std::string& action, const std::string& device)
+{
+	if (action != "add" && action != "remove")
+		return;
+
+	// Decide by sysfs if it knows the device, by name otherwise (same as in /proc/partitions detection).
+	const std::string name = hz::fs::u8path(device).filename().u8string();
+	const auto sysfs_dir = hz::fs::u8path(rconfig::get_data<std::string>("system/linux_sysfs_class_block_path"));
+	const LinuxSysfsBlockDeviceInfo sysfs_info = linux_sysfs_classify_block_device(sysfs_dir, name);
+	if (sysfs_info.kind != LinuxSysfsBlockDeviceInfo::Kind::unknown) {
+		if (!sysfs_info.needs_probe())
+			return;
+	} else if (!linux_get_platform_blacklist_match(name).empty()) {
+		return;
+	}
+
+	block_device_events_.emplace_back(action, device);
+	process_block_device_events();
+}
+
+
+
+void GscMainWindow::process_block_device_events()
+{
+	// Probing a drive runs the main loop, so more events may arrive while we're here.
+	// They are queued and handled in order by the outer call.
+	// While scanning, they are handled after the scan (see rescan_devices()).
+	if (block_device_events_busy_ || this->scanning_)
+		return;
+	block_device_events_busy_ = true;
+
+	auto blacklist_str = rconfig::get_data<std::string>("system/device_blacklist_patterns");
+	std::vector<std::string> blacklist_patterns;
+	hz::string_split(blacklist_str, ';', blacklist_patterns, true);
+
+	StorageDetector sd;
+	sd.add_blacklist_patterns(blacklist_patterns);
+
+	bool changed = false;
+	while (!block_device_events_.empty() && !this->scanning_) {
+		const auto [action, device] = block_device_events_.front();
+		block_device_events_.pop_front();
+		if (handle_block_device_event(action, device, sd)) {
+			changed = true;
+		}
+	}
+
+	block_device_events_busy_ = false;
+
+	if (changed) {
+		iconview_->update_menu_actions();
+		this->update_status_widgets();
+	}
+}
+
+
+
+bool GscMainWindow::handle_block_device_event(const std::string& action, const std::string& device, StorageDetector& sd)
+{
+	auto find_drive = [this, &device]() {
+		return std::find_if(drives_.begin(), drives_.end(), [&device](const StorageDevicePtr& drive) {
+			return !drive->get_is_virtual() && drive->get_device() == device;
+		});
+	};
+
+	if (action == "remove") {
+		auto drive_iter = find_drive();
+		if (drive_iter == drives_.end())
+			return false;
+		StorageDevicePtr drive = *drive_iter;
+		if (drive->get_test_is_active())  // the test window keeps track of it
+			return false;
+
+		debug_out_info("app", DBG_FUNC_MSG << "Device " << device << " was removed.\n");
+		remove_drive(drive);
+		return true;
+	}
+
+	// "add"
+	if (find_drive() != drives_.end() || sd.get_device_blacklisted(device))
+		return false;
+
+	debug_out_info("app", DBG_FUNC_MSG << "Device " << device << " was added, probing it.\n");
+
+	// Probe only this drive. No dialogs here, the user didn't ask for it.
+	auto drive = std::make_shared<StorageDevice>(device);
+	std::vector<StorageDevicePtr> tmp_drives = {drive};
+	auto ex_factory = std::make_shared<CommandExecutorFactory>(false);
+	sd.fetch_basic_data(tmp_drives, ex_factory);
+
+	// The main loop was running while probing. The device may have been removed since then,
+	// or added by a rescan.
+	const bool removed_meanwhile = std::any_of(block_device_events_.begin(), block_device_events_.end(),
+			[&device](const auto& event) { return event.first == "remove" && event.second == device; });
+	if (removed_meanwhile || this->scanning_ || find_drive() != drives_.end()) {
+		debug_out_info("app", DBG_FUNC_MSG << "Device " << device << " was removed or rescanned while probing, ignoring the probe.\n");
+		return false;
+	}
+
+	this->drives_.push_back(drive);
+	if (!show_smart_capable_only_key.get()
+			|| drive->get_smart_status() != StorageDevice::Status::unsupported) {
+		iconview_->add_entry(drive);
+	}
+	return true;
+}
+
+
+
+void GscMainWindow::on_virtual_directory_event(const std::string& action, const hz::fs::path& file)
+{
+	if (action == "removed") {
+		virtual_dir_pending_.erase(file);
+		virtual_dir_stamps_.erase(file);
+		virtual_dir_new_drives_.erase(file);  // its parse result will be ignored
+
+		auto drive_iter = std::find_if(drives_.begin(), drives_.end(), [&file](const StorageDevicePtr& drive) {
+			return drive->get_is_virtual() && drive->get_virtual_file() == file;
+		});
+		if (drive_iter != drives_.end()) {
+			debug_out_info("app", DBG_FUNC_MSG << "Virtual drive file \"" << file.u8string() << "\" was removed.\n");
+			remove_drive(*drive_iter);
+			iconview_->update_menu_actions();
+			this->update_status_widgets();
+		}
+		return;
+	}
+
+	virtual_dir_pending_.insert(file);
+	if (!virtual_dir_idle_conn_.connected() && !this->scanning_) {  // the rescan queues the files when it finishes
+		virtual_dir_idle_conn_ = Glib::signal_idle().connect(sigc::mem_fun(*this, &GscMainWindow::on_virtual_directory_idle));
+	}
+}
+
+
+
+bool GscMainWindow::on_virtual_directory_idle()
+{
+	// The rescan replaces the drive list and queues the files again afterwards.
+	// Don't stay pending meanwhile, the rescan runs the main loop until no events are pending.
+	if (this->scanning_)
+		return false;
+
+	// One file per main loop iteration, so that the UI stays responsive while
+	// hundreds of files are read. They are parsed in the background.
+	if (!virtual_dir_pending_.empty()) {
+		const hz::fs::path file = *virtual_dir_pending_.begin();
+		virtual_dir_pending_.erase(virtual_dir_pending_.begin());
+		load_watched_virtual_drive(file);
+	}
+
+	if (!virtual_dir_pending_.empty())
+		return true;
+
+	iconview_->update_menu_actions();
+	this->update_status_widgets();
+	return false;  // all loaded
+}
+
+
+
+void GscMainWindow::queue_virtual_directory_files()
+{
+	if (!virtual_dir_watcher_)
+		return;
+
+	std::error_code ec;
+	for (const auto& entry : hz::fs::directory_iterator(virtual_dir_watcher_->get_directory(), ec)) {
+		std::error_code type_ec;
+		if (entry.is_regular_file(type_ec) && !hz::string_begins_with(entry.path().filename().u8string(), ".")) {
+			on_virtual_directory_event("changed", entry.path());
+		}
+	}
+	if (ec) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot list directory \"" << virtual_dir_watcher_->get_directory().u8string()
+				<< "\": " << ec.message() << "\n");
+	}
+}
+
+
+
+void GscMainWindow::load_watched_virtual_drive(const hz::fs::path& file)
+{
+	std::error_code ec;
+	const std::uintmax_t size = hz::fs::file_size(file, ec);
+	const hz::fs::file_time_type mtime = (ec ? hz::fs::file_time_type() : hz::fs::last_write_time(file, ec));
+	if (ec) {  // e.g. removed in the meantime
+		debug_out_info("app", DBG_FUNC_MSG << "Skipping virtual drive file \"" << file.u8string() << "\": " << ec.message() << "\n");
+		return;
+	}
+
+	auto drive_iter = std::find_if(drives_.begin(), drives_.end(), [&file](const StorageDevicePtr& drive) {
+		return drive->get_is_virtual() && drive->get_virtual_file() == file;
+	});
+	StorageDevicePtr drive;
+	if (drive_iter != drives_.end()) {
+		drive = *drive_iter;
+	} else if (auto new_iter = virtual_dir_new_drives_.find(file); new_iter != virtual_dir_new_drives_.end()) {
+		drive = new_iter->second;  // still being parsed
+	}
+
+	// Don't even read the files which weren't modified
+	const auto stamp = std::make_pair(size, mtime);
+	auto stamp_iter = virtual_dir_stamps_.find(file);
+	if (drive && stamp_iter != virtual_dir_stamps_.end() && stamp_iter->second == stamp) {
+		return;
+	}
+
+	std::string output;
+	const int max_size = 10*1024*1024;  // 10M, same as in add_virtual_drive()
+	ec = hz::fs_file_get_contents(file, output, max_size);
+	if (ec) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot open virtual drive file \"" << file.u8string() << "\": " << ec.message() << "\n");
+		return;
+	}
+	virtual_dir_stamps_[file] = stamp;
+
+	if (drive) {
+		if (drive->get_full_output() == output) {  // touched or rewritten with the same data
+			return;
+		}
+		debug_out_info("app", DBG_FUNC_MSG << "Reloading virtual drive file \"" << file.u8string() << "\".\n");
+	} else {
+		drive = std::make_shared<StorageDevice>(file.u8string(), true);
+		virtual_dir_new_drives_[file] = drive;
+	}
+
+	// Existing drives are updated in place once parsed. The icon and the open info windows
+	// are refreshed through signal_changed() (the info windows show their own copy of the
+	// properties until then).
+	drive->set_full_output(output);
+	drive->set_info_output(output);  // info can be parsed from full output string too.
+	parse_queue_.parse(drive, sigc::mem_fun(*this, &GscMainWindow::on_watched_virtual_drive_parsed));
+}
+
+
+
+void GscMainWindow::on_watched_virtual_drive_parsed(StorageDevicePtr drive, std::string error_msg, bool applied)
+{
+	if (!applied)  // replaced by a newer parse, which adds it if needed
+		return;
+
+	const hz::fs::path file = drive->get_virtual_file();
+	auto new_iter = virtual_dir_new_drives_.find(file);
+	const bool is_new = (new_iter != virtual_dir_new_drives_.end() && new_iter->second == drive);
+	if (is_new) {
+		virtual_dir_new_drives_.erase(new_iter);
+	}
+
+	if (!error_msg.empty()) {
+		// No dialogs here, the file may be in the middle of being collected. It will be retried when it changes.
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot interpret SMART data in \"" << file.u8string() << "\": " << error_msg << "\n");
+		return;
+	}
+
+	if (is_new) {
+		this->drives_.push_back(drive);
+		iconview_->add_entry(drive);
+		iconview_->update_menu_actions();
+		this->update_status_widgets();
+	}
+}
+
+
+
+void GscMainWindow::remove_drive(const StorageDevicePtr& drive)
+{
+	auto drive_iter = std::find(drives_.begin(), drives_.end(), drive);
+	if (drive_iter != drives_.end()) {
+		this->drives_.erase(drive_iter);
+	}
+	const Gtk::TreePath model_path = iconview_->get_path_by_drive(drive.get());
+	if (!model_path.empty()) {
+		iconview_->remove_entry(model_path);
+	}
+	if (iconview_->get_num_icons() == 0) {
+		iconview_->set_empty_view_message(GscMainWindowIconView::Message::no_drives_found);
+		iconview_->queue_draw();
+	}
+	if (!drive->get_is_virtual()) {
+		schedule_metrics_export();
+	}
 }
 
 
@@ -1159,16 +1591,129 @@ bool GscMainWindow::add_virtual_drive(const std::string& file)
 	drive->set_full_output(output);
 	drive->set_info_output(output);  // info can be parsed from full output string too.
 
-	std::string error_msg = drive->parse_data();  // this will set the type and add the properties
+	// This will set the type and add the properties
+	parse_queue_.parse(drive, sigc::mem_fun(*this, &GscMainWindow::on_virtual_drive_parsed));
+
+	return true;
+}
+
+
+
+void GscMainWindow::on_virtual_drive_parsed(StorageDevicePtr drive, std::string error_msg, bool applied)
+{
+	if (!applied)  // not parsed from the loaded file
+		return;
+
 	if (!error_msg.empty()) {
 		gui_show_error_dialog(_("Cannot interpret SMART data"), error_msg, this);
-		return false;
+		return;
 	}
 
 	this->drives_.push_back(drive);
 
 	this->iconview_->add_entry(drives_.back(), true);  // add it, scroll and select it.
 
+	iconview_->update_menu_actions();
+	this->update_status_widgets();
+}
+
+
+
+
+void GscMainWindow::add_virtual_drives(const std::vector<std::string>& paths)
+{
+	std::vector<hz::fs::path> files = virtual_drive_expand_paths(paths);
+	if (files.empty()) {
+		return;
+	}
+
+	// A single explicitly given file gets the detailed error dialogs.
+	std::error_code ec;
+	if (files.size() == 1 && paths.size() == 1 && !hz::fs::is_directory(hz::fs::u8path(paths.front()), ec)) {
+		add_virtual_drive(files.front().u8string());
+		return;
+	}
+
+	if (bulk_loader_ && bulk_loader_->is_running()) {
+		gui_show_warn_dialog(_("Please wait until the previous files are loaded."), this);
+		return;
+	}
+	if (!bulk_loader_) {
+		bulk_loader_ = std::make_unique<VirtualDriveBulkLoader>();
+		bulk_loader_->signal_drive_loaded().connect(sigc::mem_fun(*this, &GscMainWindow::on_bulk_virtual_drive_loaded));
+		bulk_loader_->signal_file_failed().connect(sigc::mem_fun(*this, &GscMainWindow::on_bulk_virtual_file_failed));
+		bulk_loader_->signal_finished().connect(sigc::mem_fun(*this, &GscMainWindow::on_bulk_virtual_loading_finished));
+	}
+	bulk_loader_errors_.clear();
+	bulk_loader_->start(std::move(files));
+}
+
+
+
+void GscMainWindow::on_bulk_virtual_drive_loaded(StorageDevicePtr drive, StorageDevicePtr replaced_drive)
+{
+	// The scan replaces the drive list when it's done, hold the drive until then.
+	if (this->scanning_) {
+		bulk_loader_held_drives_.emplace_back(std::move(drive), std::move(replaced_drive));
+		return;
+	}
+	if (replaced_drive) {
+		remove_drive(replaced_drive);
+	}
+	this->drives_.push_back(drive);
+	this->iconview_->add_entry(drive);
+}
+
+
+
+void GscMainWindow::on_bulk_virtual_file_failed(const hz::fs::path& file, const std::string& error_msg)
+{
+	bulk_loader_errors_.push_back(file.u8string() + ": " + error_msg);
+}
+
+
+
+void GscMainWindow::on_bulk_virtual_loading_finished()
+{
+	if (this->scanning_) {
+		bulk_loader_held_finish_ = true;
+		return;
+	}
+
+	iconview_->update_menu_actions();
+	this->update_status_widgets();
+
+	if (!bulk_loader_errors_.empty()) {
+		const std::size_t max_shown = 10;
+		std::vector<std::string> shown(bulk_loader_errors_.begin(),
+				bulk_loader_errors_.begin() + std::ptrdiff_t(std::min(max_shown, bulk_loader_errors_.size())));
+		std::string msg = hz::string_join(shown, "\n");
+		if (bulk_loader_errors_.size() > max_shown) {
+			msg += "\n" + Glib::ustring::compose(_("... and %1 more."), bulk_loader_errors_.size() - max_shown);
+		}
+		bulk_loader_errors_.clear();
+		gui_show_error_dialog(_("Cannot load some data files"), msg, this);
+	}
+}
+
+
+
+bool GscMainWindow::watch_virtual_directory(const std::string& dir)
+{
+	virtual_dir_idle_conn_.disconnect();
+	virtual_dir_pending_.clear();
+	virtual_dir_stamps_.clear();
+
+	virtual_dir_watcher_ = std::make_unique<DirectoryWatcher>();
+	if (!virtual_dir_watcher_->open(hz::fs::u8path(dir))) {
+		virtual_dir_watcher_.reset();
+		gui_show_error_dialog(_("Cannot watch directory"),
+				Glib::ustring::compose(_("Directory \"%1\" cannot be watched for smartctl data files."), dir), this);
+		return false;
+	}
+	virtual_dir_watcher_->signal_file_event().connect(sigc::mem_fun(*this, &GscMainWindow::on_virtual_directory_event));
+
+	queue_virtual_directory_files();
 	return true;
 }
 
@@ -1186,16 +1731,21 @@ bool GscMainWindow::testing_active() const
 
 
 
-std::shared_ptr<GscInfoWindow> GscMainWindow::show_device_info_window(const StorageDevicePtr& drive)
+void GscMainWindow::show_device_info_window(const StorageDevicePtr& drive, bool show_tests)
 {
 	if (!drive) {
-		return nullptr;
+		return;
 	}
 
 	// if a test is being run on it, disallow.
 	if (drive->get_test_is_active()) {
 		gui_show_warn_dialog(_("Please wait until the test is finished on this drive."), this);
-		return nullptr;
+		return;
+	}
+
+	// already being read, the window will be shown when it's done.
+	if (parse_queue_.is_parsing(drive)) {
+		return;
 	}
 
 	// ask to enable SMART if it's supported but disabled
@@ -1228,26 +1778,69 @@ std::shared_ptr<GscInfoWindow> GscMainWindow::show_device_info_window(const Stor
 
 
 	// Virtual drives are parsed at load time.
-	// Parse non-virtual, smart-supporting drives here.
+	// Read non-virtual, smart-supporting drives here and parse them in the background.
 	if (!drive->get_is_virtual() && drive->get_smart_status() != StorageDevice::Status::unsupported) {
 		std::shared_ptr<SmartctlExecutorGui> ex(new SmartctlExecutorGui());
 		ex->create_running_dialog(this, Glib::ustring::compose(_("Running {command} on %1..."), drive->get_device_with_type()));
-		std::string error_msg = drive->fetch_data_and_parse(ex);  // run it with GUI support
+		std::string error_msg = drive->fetch_data(ex);  // run it with GUI support
 
 		if (!error_msg.empty()) {
 			gsc_executor_error_dialog_show(_("Cannot retrieve SMART data"), error_msg, this);
-			return nullptr;
+			return;
 		}
+
+		parse_queue_.parse(drive, sigc::bind(sigc::mem_fun(*this, &GscMainWindow::on_info_window_drive_parsed), show_tests));
+		return;
 	}
 
+	open_device_info_window(drive, show_tests);
+}
+
 
+
+StorageDeviceParseQueue& GscMainWindow::get_parse_queue()
+{
+	return parse_queue_;
+}
+
+
+
+void GscMainWindow::on_info_window_drive_parsed(StorageDevicePtr drive, std::string error_msg, bool applied, bool show_tests)
+{
+	// The drive may have disappeared in a rescan while it was being parsed.
+	if (std::find(drives_.begin(), drives_.end(), drive) == drives_.end()) {
+		return;
+	}
+
+	// Its data was replaced while parsing (e.g. by a rescan), don't show the window with it.
+	if (!applied) {
+		debug_out_info("app", DBG_FUNC_MSG << "The data of " << drive->get_device_with_type() << " was replaced while parsing, not opening its window.\n");
+		return;
+	}
+
+	if (!error_msg.empty()) {
+		gsc_executor_error_dialog_show(_("Cannot retrieve SMART data"), error_msg, this);
+		return;
+	}
+
+	if (rconfig::get_data<bool>("gui/record_attribute_history")) {
+		AttributeHistoryStore(app_get_attribute_history_dir()).append_drive(*drive);
+	}
+
+	open_device_info_window(drive, show_tests);
+}
+
+
+
+void GscMainWindow::open_device_info_window(const StorageDevicePtr& drive, bool show_tests)
+{
 	// If the drive output wasn't fully parsed (happens with e.g. scsi and
 	// usb devices), only very basic info is available and there's no point
 	// in showing this window. - for both virtual and non-virtual.
 	if (drive->get_parse_status() == StorageDevice::ParseStatus::none) {
 		gsc_no_info_dialog_show(_("No additional information is available for this drive."),
 				"", this, false, drive->get_info_output(), _("Smartctl Output"), drive->get_save_filename());
-		return nullptr;
+		return;
 	}
 
 
@@ -1260,13 +1853,16 @@ std::shared_ptr<GscInfoWindow> GscMainWindow::show_device_info_window(const Stor
 
 	win->show();
 
-	return win;
+	if (show_tests) {
+		win->show_tests();
+	}
 }
 
 
 
 void GscMainWindow::show_prefs_updated_message()
 {
+	full_rescan_needed_ = true;  // smartctl options may have changed
 	iconview_->set_empty_view_message(GscMainWindowIconView::Message::please_rescan);
 	iconview_->clear_all();  // the message won't be shown without invalidating the region.
 	while (Gtk::Main::events_pending())  // give expose event the time it needs
@@ -1359,12 +1955,8 @@ void GscMainWindow::show_load_virtual_file_chooser()
 				last_dir = hz::fs::u8path(files.front()).parent_path().u8string();
 			}
 			rconfig::set_data("gui/drive_data_open_save_dir", last_dir);
-			for (const auto& file : files) {
-				std::error_code ec;
-				if (!hz::fs::is_directory(hz::fs::u8path(file), ec)) {  // file chooser returns selected directories as well, ignore them.
-					this->add_virtual_drive(file);
-				}
-			}
+			// Selected directories are loaded with all their files.
+			this->add_virtual_drives(files);
 			break;
 		}
 
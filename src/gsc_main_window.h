@@ -13,10 +13,20 @@ Copyright:
 #define GSC_MAIN_WINDOW_H
 
 #include <map>
+#include <set>
+#include <deque>
+#include <utility>
+#include <memory>
 #include <gtkmm.h>
 
 #include "applib/app_builder_widget.h"
 #include "applib/storage_device.h"
+#include "applib/storage_detector.h"
+#include "applib/uevent_monitor.h"
+#include "applib/directory_watcher.h"
+#include "applib/virtual_drive_loader.h"
+#include "applib/storage_device_parse_queue.h"
+#include "applib/prometheus_exporter.h"
 
 
 
@@ -44,8 +54,9 @@ class GscMainWindow : public AppBuilderWidget<GscMainWindow, false> {
 		virtual ~GscMainWindow();
 
 
-		/// Scan for devices and fill the iconview
-		void rescan_devices();
+		/// Scan for devices and fill the iconview. Unchanged drives are kept with their
+		/// data, unless \c refetch_known is true (then their basic data is fetched again).
+		void rescan_devices(bool refetch_known = false);
 
 
 		/// Execute update-smart-drivedb
@@ -56,16 +67,32 @@ class GscMainWindow : public AppBuilderWidget<GscMainWindow, false> {
 		bool add_device(const std::string& file, const std::string& type_arg, const std::string& extra_args);
 
 
-		/// Read smartctl data from file, add it as a virtual drive to icon list
+		/// Read smartctl data from file, add it as a virtual drive to icon list once it's parsed.
+		/// \return false if the file cannot be read.
 		bool add_virtual_drive(const std::string& file);
 
 
+		/// Load smartctl data from files, directories or wildcard patterns as virtual drives.
+		/// A single file is loaded immediately, many files are loaded in the background
+		/// and added to the icon list as they are parsed.
+		void add_virtual_drives(const std::vector<std::string>& paths);
+
+
+		/// Load all smartctl data files from a directory as virtual drives and keep them
+		/// updated as the files are written, replaced or removed.
+		bool watch_virtual_directory(const std::string& dir);
+
+
 		/// If at least one drive is having a test performed, return true.
 		bool testing_active() const;
 
 
-		/// Show the info window for the drive
-		std::shared_ptr<GscInfoWindow> show_device_info_window(const StorageDevicePtr& drive);
+		/// Show the info window for the drive, switching to its Tests tab if \c show_tests is true.
+		/// Non-virtual drives are read first, and the window is shown once the data is parsed.
+		void show_device_info_window(const StorageDevicePtr& drive, bool show_tests = false);
+
+		/// Get the queue which parses the drive data in the background
+		StorageDeviceParseQueue& get_parse_queue();
 
 		/// Show "Preferences updated, please rescan" message
 		void show_prefs_updated_message();
@@ -107,6 +134,13 @@ class GscMainWindow : public AppBuilderWidget<GscMainWindow, false> {
 		/// Update status widgets (status area, etc...)
 		void update_status_widgets();
 
+		/// Write the metrics of all drives to the Prometheus text file (if enabled in config),
+		/// after a short delay to coalesce multiple drive changes. \c changed_drive is the drive
+		/// whose data has changed, if any.
+		void schedule_metrics_export(const StorageDevice* changed_drive = nullptr);
+
+		/// Metrics export timeout callback
+		bool on_metrics_export_timeout();
 
 		/// Create the widgets - iconview, gtkuimanager stuff (menus), custom labels
 		bool create_widgets();
@@ -121,6 +155,10 @@ class GscMainWindow : public AppBuilderWidget<GscMainWindow, false> {
 		void show_load_virtual_file_chooser();
 
 
+		/// Create and show the info window for an already parsed drive
+		void open_device_info_window(const StorageDevicePtr& drive, bool show_tests);
+
+
 		/// Called when quit has been requested (by delete event or Quit action)
 		void quit_requested();
 
@@ -152,11 +190,71 @@ class GscMainWindow : public AppBuilderWidget<GscMainWindow, false> {
 		/// Action callback
 		void on_action_reread_device_data();
 
+		/// Uevent monitor callback, queues the addition or removal of a hotplugged drive
+		void on_block_device_event(const std::string& action, const std::string& device);
+
+		/// Handle the queued hotplug events, one by one
+		void process_block_device_events();
+
+		/// Add or remove a hotplugged drive. \c sd holds the user blacklist.
+		/// \return true if the drive list has changed.
+		bool handle_block_device_event(const std::string& action, const std::string& device, StorageDetector& sd);
+
+		/// Bulk loader callback, adds a loaded virtual drive
+		void on_bulk_virtual_drive_loaded(StorageDevicePtr drive, StorageDevicePtr replaced_drive);
+
+		/// Bulk loader callback, remembers a failed file
+		void on_bulk_virtual_file_failed(const hz::fs::path& file, const std::string& error_msg);
+
+		/// Bulk loader callback, reports the failed files
+		void on_bulk_virtual_loading_finished();
+
+		/// Parse queue callback, opens the info window of a freshly read drive
+		void on_info_window_drive_parsed(StorageDevicePtr drive, std::string error_msg, bool applied, bool show_tests);
+
+		/// Parse queue callback, adds a manually loaded virtual drive
+		void on_virtual_drive_parsed(StorageDevicePtr drive, std::string error_msg, bool applied);
+
+		/// Parse queue callback, adds or updates a drive of the watched directory
+		void on_watched_virtual_drive_parsed(StorageDevicePtr drive, std::string error_msg, bool applied);
+
+		/// Directory watcher callback, queues a changed file or removes its drive
+		void on_virtual_directory_event(const std::string& action, const hz::fs::path& file);
+
+		/// Idle callback, loads one queued file of the watched directory per call
+		bool on_virtual_directory_idle();
+
+
+		/// Queue all the files of the watched directory for loading
+		void queue_virtual_directory_files();
+
+		/// Load or reload a file of the watched directory, skipping it if it's unchanged.
+		void load_watched_virtual_drive(const hz::fs::path& file);
+
+		/// Remove a drive from the list and its icon
+		void remove_drive(const StorageDevicePtr& drive);
+
 
 	private:
 
 		GscMainWindowIconView* iconview_ = nullptr;  ///< The main icon view
 		std::vector<StorageDevicePtr> drives_;  ///< Scanned drives
+		bool full_rescan_needed_ = false;  ///< If true, the next rescan won't reuse the data of the already scanned drives
+		std::unique_ptr<UeventMonitor> uevent_monitor_;  ///< Hotplug monitor
+		std::deque<std::pair<std::string, std::string>> block_device_events_;  ///< Hotplug events (action, device) waiting to be handled
+		bool block_device_events_busy_ = false;  ///< Whether the hotplug events are being handled (probing runs the main loop)
+		std::unique_ptr<DirectoryWatcher> virtual_dir_watcher_;  ///< Watcher of the virtual drive directory
+		std::set<hz::fs::path> virtual_dir_pending_;  ///< Changed files in the watched directory, waiting to be loaded
+		std::map<hz::fs::path, std::pair<std::uintmax_t, hz::fs::file_time_type>> virtual_dir_stamps_;  ///< Size and modification time of the loaded files
+		std::map<hz::fs::path, StorageDevicePtr> virtual_dir_new_drives_;  ///< New drives of the watched directory, being parsed
+		sigc::connection virtual_dir_idle_conn_;  ///< Pending file loading
+		std::unique_ptr<VirtualDriveBulkLoader> bulk_loader_;  ///< Loader of many virtual drives
+		std::vector<std::string> bulk_loader_errors_;  ///< Errors of the current bulk loading
+		std::vector<std::pair<StorageDevicePtr, StorageDevicePtr>> bulk_loader_held_drives_;  ///< Drives (and the ones they replace) loaded during a scan
+		bool bulk_loader_held_finish_ = false;  ///< Whether the bulk loading finished during a scan
+		StorageDeviceParseQueue parse_queue_;  ///< Parses drive data in worker threads
+		sigc::connection metrics_export_conn_;  ///< Pending metrics export
+		std::map<std::string, PrometheusTextExporter::FullData> metrics_full_data_;  ///< Last fully parsed data of drives, by device
 
 		Glib::RefPtr<Gtk::UIManager> ui_manager_;  ///< UI manager
 		Glib::RefPtr<Gtk::ActionGroup> actiongroup_main_;  ///< Action group
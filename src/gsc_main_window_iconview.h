@@ -15,6 +15,7 @@ Copyright:
 #include "local_glibmm.h"
 #include <gtkmm.h>
 #include <vector>
+#include <algorithm>  // std::find
 #include <cmath>  // std::floor
 #include <unordered_map>
 #include <cairomm/cairomm.h>
@@ -405,6 +406,48 @@ class GscMainWindowIconView : public Gtk::IconView {
 		{
 			const Gtk::TreeModel::Row row = *(ref_list_model->get_iter(model_path));
 			ref_list_model->erase(row);
+			--num_icons;
+		}
+
+
+
+		/// Update the entries in place to show \c drives (in this order): remove
+		/// the entries of drives not in the list, redecorate the existing ones and
+		/// add the new ones.
+		void update_entries(const std::vector<StorageDevicePtr>& drives)
+		{
+			const Gtk::TreeNodeChildren children = ref_list_model->children();
+			for (auto iter = children.begin(); iter != children.end(); ) {
+				const StorageDevicePtr drive = (*iter)[col_drive_ptr];
+				if (std::find(drives.cbegin(), drives.cend(), drive) == drives.cend()) {
+					iter = ref_list_model->erase(iter);
+					--num_icons;
+				} else {
+					++iter;
+				}
+			}
+
+			for (const auto& drive : drives) {
+				const Gtk::TreePath model_path = this->get_path_by_drive(drive.get());
+				if (model_path.empty()) {
+					this->add_entry(drive);
+				} else {
+					this->decorate_entry(model_path);
+				}
+			}
+
+			// Keep the order of the list
+			std::vector<int> new_order;
+			new_order.reserve(drives.size());
+			for (const auto& drive : drives) {
+				const Gtk::TreePath model_path = this->get_path_by_drive(drive.get());
+				if (!model_path.empty()) {
+					new_order.push_back(model_path.front());
+				}
+			}
+			if (new_order.size() == children.size()) {
+				ref_list_model->reorder(new_order);
+			}
 		}
 
 
@@ -560,12 +603,19 @@ class GscMainWindowIconView : public Gtk::IconView {
 
 
 		/// Callback attached to StorageDevice, updates its view.
-		void on_drive_changed(StorageDevice* drive)
+		void on_drive_changed(StorageDevice* drive, int changes)
 		{
-			const Gtk::TreePath model_path = this->get_path_by_drive(drive);
-			this->decorate_entry(model_path);
+			// The icon and the status area show the drive data, not the test state.
+			const bool data_changed = (changes & (StorageDevice::change_identity | StorageDevice::change_properties)) != 0;
+			if (data_changed) {
+				const Gtk::TreePath model_path = this->get_path_by_drive(drive);
+				this->decorate_entry(model_path);
+			}
 			this->update_menu_actions();
-			main_window->update_status_widgets();
+			if (data_changed) {
+				main_window->update_status_widgets();
+				main_window->schedule_metrics_export(drive);
+			}
 		}
 
 
@@ -26,7 +26,8 @@ class GscMainWindow;  // declared in gsc_main_window.h
 
 /// The Preferences window.
 /// Use create() / destroy() with this class instead of new / delete!
-class GscPreferencesWindow : public AppBuilderWidget<GscPreferencesWindow, true> {
+/// The window is created on first use and is hidden (not destroyed) on close.
+class GscPreferencesWindow : public AppBuilderWidget<GscPreferencesWindow, false> {
 	public:
 
 		// name of ui file (without .ui extension) for AppBuilderWidget
@@ -48,11 +49,12 @@ class GscPreferencesWindow : public AppBuilderWidget<GscPreferencesWindow, true>
 		void device_widget_set_remove_possible(bool b);
 
 
-	protected:
-
-		/// Import the configuration into UI
+		/// Import the configuration into UI. Call this before showing a reused window.
 		void import_config();
 
+
+	protected:
+
 		/// Export the configuration from UI
 		void export_config();
 
@@ -61,7 +63,7 @@ class GscPreferencesWindow : public AppBuilderWidget<GscPreferencesWindow, true>
 
 		// ---------- overriden virtual methods
 
-		/// Destroy this object on delete event (by default it calls hide()).
+		/// Same as Cancel.
 		/// Reimplemented from Gtk::Window.
 		bool on_delete_event(GdkEventAny* e) override;
 
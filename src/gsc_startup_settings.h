@@ -20,6 +20,7 @@ struct GscStartupSettings {
 	bool no_scan = false;  ///< No scanning on startup
 	std::vector<std::string> load_virtuals;  ///< Virtual files to load
 	std::vector<std::string> add_devices;  ///< Devices to add (with options)
+	std::string watch_virtual_dir;  ///< Directory to watch for virtual drive files
 	bool hide_tabs_on_smart_disabled = true;  ///< Hide additional Info Window tabs if SMART is disabled.
 
 };
@@ -349,6 +349,76 @@ inline std::error_code fs_file_put_contents(const fs::path& file, const std::str
 
 
 
+/// Write data to a file so that the file contains either its old or its new contents,
+/// even if the program or the system crashes: the data is written to a temporary file
+/// in the same directory, flushed to disk, and then renamed over \c file.
+/// If \c file is a symlink, the file it points to is replaced, keeping the link.
+/// The permissions of an existing file are kept.
+inline std::error_code fs_file_put_contents_atomic(const fs::path& file, const std::string_view& data)
+{
+	if (file.empty()) {
+		return std::make_error_code(std::errc::invalid_argument);
+	}
+
+	// Renaming over a symlink would replace the link itself, so follow it.
+	fs::path target = file;
+	std::error_code ec;
+	for (int depth = 0; fs::is_symlink(fs::symlink_status(target, ec)); ++depth) {
+		if (depth >= 40) {  // same as the usual MAXSYMLINKS
+			return std::make_error_code(std::errc::too_many_symbolic_link_levels);
+		}
+		const fs::path link = fs::read_symlink(target, ec);
+		if (ec) {
+			return ec;
+		}
+		target = link.is_absolute() ? link : (target.parent_path() / link);
+	}
+
+	fs::path tmp_file = target;
+	tmp_file += ".tmp";
+
+	std::FILE* f = fs_platform_fopen(tmp_file, "wb");
+	if (!f) {
+		return {errno, std::system_category()};
+	}
+
+	bool write_error = !data.empty() && std::fwrite(data.data(), data.size(), 1, f) != 1;
+	write_error = write_error || std::fflush(f) != 0;
+#ifdef _WIN32
+	write_error = write_error || _commit(_fileno(f)) != 0;
+#else
+	write_error = write_error || fsync(fileno(f)) != 0;
+#endif
+	ec.clear();
+	if (write_error) {
+		ec = std::error_code(errno, std::system_category());
+	}
+	if (std::fclose(f) != 0 && !ec) {
+		ec = std::error_code(errno, std::system_category());
+	}
+
+	// The temporary file has the default permissions, restore the original ones (e.g. a private config file).
+	if (!ec) {
+		std::error_code status_ec;
+		const fs::file_status old_status = fs::status(target, status_ec);
+		if (!status_ec && fs::exists(old_status)) {
+			fs::permissions(tmp_file, old_status.permissions(), ec);
+		}
+	}
+
+	if (!ec) {
+		fs::rename(tmp_file, target, ec);  // atomic on POSIX, replaces the file on Windows too
+	}
+	if (ec) {
+		std::error_code dummy_ec;
+		fs::remove(tmp_file, dummy_ec);
+	}
+	return ec;
+}
+
+
+
+
 
 /// Get the current user's home directory.
 /// This function always returns something, but
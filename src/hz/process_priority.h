@@ -0,0 +1,152 @@
+/******************************************************************************
+License: Zlib
+Copyright:
+	(C) 2008 - 2021 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup hz
+/// \weakgroup hz
+/// @{
+
+#ifndef HZ_PROCESS_PRIORITY_H
+#define HZ_PROCESS_PRIORITY_H
+
+#include <cerrno>  // errno
+
+#ifndef _WIN32
+	#include <sys/types.h>
+	#include <sys/time.h>
+	#include <sys/resource.h>  // setpriority()
+	#include <fcntl.h>  // open()
+	#include <unistd.h>  // write(), close(), syscall()
+#endif
+#ifdef __linux__
+	#include <sys/syscall.h>  // SYS_ioprio_set
+#endif
+
+
+
+/**
+\file
+Process priority helpers. All the functions here act on the calling process
+and are async-signal-safe (they make raw system calls only, without allocating
+memory), so they may be called in a child between fork() and exec().
+*/
+
+
+
+namespace hz {
+
+
+/// I/O scheduling class, as understood by Linux ioprio_set().
+enum class IoPriorityClass {
+	None = 0,  ///< Don't change
+	RealTime = 1,  ///< Real-time class (needs root)
+	BestEffort = 2,  ///< Best-effort class (the default one), levels 0-7
+	Idle = 3,  ///< Get disk time only when nobody else needs it
+};
+
+
+/// Set the CPU scheduling priority (nice value, -20 to 19) of the calling process.
+/// \return 0 on success, -1 on error (errno is set).
+inline int process_set_cpu_priority_self(int nice_value);
+
+
+/// Set the I/O scheduling class and level (0-7, lower is higher priority)
+/// of the calling process. Linux only, returns -1 with ENOSYS elsewhere.
+/// \return 0 on success, -1 on error (errno is set).
+inline int process_set_io_priority_self(IoPriorityClass io_class, int level);
+
+
+/// Move the calling process to a cgroup v2 group by writing "0" to its
+/// cgroup.procs file (e.g. "/sys/fs/cgroup/smartmon.slice/cgroup.procs").
+/// \return 0 on success, -1 on error (errno is set).
+inline int process_join_cgroup_self(const char* cgroup_procs_file);
+
+
+
+
+// ------------------------------------------ Implementation
+
+
+
+int process_set_cpu_priority_self(int nice_value)
+{
+#ifdef _WIN32
+	(void)nice_value;
+	errno = ENOSYS;
+	return -1;
+#else
+	return setpriority(PRIO_PROCESS, 0, nice_value);
+#endif
+}
+
+
+
+int process_set_io_priority_self(IoPriorityClass io_class, int level)
+{
+	if (io_class == IoPriorityClass::None) {
+		return 0;
+	}
+
+#if defined __linux__ && defined SYS_ioprio_set
+	// From linux/ioprio.h, which is not always installed.
+	constexpr int ioprio_class_shift = 13;
+	constexpr int ioprio_who_process = 1;
+
+	if (io_class == IoPriorityClass::Idle || level < 0) {
+		level = 0;  // idle class has no levels
+	}
+	if (level > 7) {
+		level = 7;
+	}
+	const int ioprio = (static_cast<int>(io_class) << ioprio_class_shift) | level;
+	return static_cast<int>(syscall(SYS_ioprio_set, ioprio_who_process, 0, ioprio));
+#else
+	(void)level;
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+
+
+int process_join_cgroup_self(const char* cgroup_procs_file)
+{
+#ifdef _WIN32
+	(void)cgroup_procs_file;
+	errno = ENOSYS;
+	return -1;
+#else
+	if (!cgroup_procs_file || cgroup_procs_file[0] == '\0') {
+		errno = EINVAL;
+		return -1;
+	}
+	const int fd = open(cgroup_procs_file, O_WRONLY | O_CLOEXEC);
+	if (fd == -1) {
+		return -1;
+	}
+	// "0" means "the writing process" in cgroup v2.
+	const ssize_t written = write(fd, "0", 1);
+	const int saved_errno = errno;
+	close(fd);
+	if (written != 1) {
+		errno = saved_errno;
+		return -1;
+	}
+	return 0;
+#endif
+}
+
+
+
+
+}  // ns
+
+
+
+
+#endif
+
+/// @}
@@ -70,6 +70,14 @@ void debug_end()
 namespace debug_internal {
 
 
+	std::recursive_mutex& get_debug_out_mutex()
+	{
+		static std::recursive_mutex mutex;
+		return mutex;
+	}
+
+
+
 	std::string DebugSourcePos::str() const
 	{
 		std::ostringstream os;
@@ -17,6 +17,7 @@ Copyright:
 // Since every useful operator << is defined in ostream, we include it here anyway.
 #include <ostream>  // std::ostream
 #include <utility>
+#include <mutex>
 
 #include "hz/system_specific.h"  // HZ_FUNC_PRINTF_ISO_CHECK
 
@@ -30,6 +31,46 @@ std::ostream& debug_out(debug_level::flag level, const std::string& domain);
 
 
 
+namespace debug_internal {
+
+	/// Get the mutex which serializes the output to debug streams
+	std::recursive_mutex& get_debug_out_mutex();
+
+
+	/// A debug stream which is locked until the end of the full expression it's
+	/// used in, so that debug_out_*() may be called from several threads.
+	class LockedDebugOut {
+		public:
+
+			/// Constructor
+			LockedDebugOut(debug_level::flag level, const std::string& domain)
+					: lock_(get_debug_out_mutex()), os_(debug_out(level, domain))
+			{ }
+
+			/// Output a value, returning the (still locked) stream
+			template<typename T>
+			std::ostream& operator<< (const T& value) &&
+			{
+				return os_ << value;
+			}
+
+			/// Output a manipulator (e.g. std::endl)
+			std::ostream& operator<< (std::ostream& (*manip)(std::ostream&)) &&
+			{
+				return os_ << manip;
+			}
+
+		private:
+
+			std::unique_lock<std::recursive_mutex> lock_;  ///< Lock held during the output
+			std::ostream& os_;  ///< Debug stream
+
+	};
+
+}
+
+
+
 // These are macros to be able to easily compile-out per-level output.
 
 /// Send an output to debug stream. For example:
@@ -38,23 +79,23 @@ std::ostream& debug_out(debug_level::flag level, const std::string& domain);
 /// debug_out_dump("app", "Error value: " << value << ".\n");
 /// \endcode
 #define debug_out_dump(domain, output) \
-	debug_out(debug_level::dump, domain) << output
+	debug_internal::LockedDebugOut(debug_level::dump, domain) << output
 
 /// Send an output to debug stream. \see debug_out_dump().
 #define debug_out_info(domain, output) \
-	debug_out(debug_level::info, domain) << output
+	debug_internal::LockedDebugOut(debug_level::info, domain) << output
 
 /// Send an output to debug stream. \see debug_out_dump().
 #define debug_out_warn(domain, output) \
-	debug_out(debug_level::warn, domain) << output
+	debug_internal::LockedDebugOut(debug_level::warn, domain) << output
 
 /// Send an output to debug stream. \see debug_out_dump().
 #define debug_out_error(domain, output) \
-	debug_out(debug_level::error, domain) << output
+	debug_internal::LockedDebugOut(debug_level::error, domain) << output
 
 /// Send an output to debug stream. \see debug_out_dump().
 #define debug_out_fatal(domain, output) \
-	debug_out(debug_level::fatal, domain) << output
+	debug_internal::LockedDebugOut(debug_level::fatal, domain) << output
 
 
 
@@ -19,6 +19,7 @@ Copyright:
 
 #include <string>
 #include <chrono>
+#include <cstdint>
 #include <glib.h>
 
 #include "hz/debug.h"
@@ -39,6 +40,14 @@ namespace impl {
 	inline hz::fs::path autosave_config_file;  ///< Config file to autosave to.
 	inline bool autosave_enabled = false;  ///< Autosave enabled or not. This acts as a stopper flag for autosave callback.
 
+	inline std::uint64_t autosave_saved_generation = 0;  ///< Config generation which was last written to (or loaded from) the file.
+	inline std::uint64_t autosave_last_seen_generation = 0;  ///< Config generation seen on the previous autosave tick.
+	inline int autosave_postponed_count = 0;  ///< Number of consecutive ticks the save was postponed because the config was still changing.
+
+	/// A save is postponed at most this many ticks while the config keeps changing,
+	/// so that a burst of changes results in a single write.
+	constexpr int autosave_max_postponed = 3;
+
 }
 
 
@@ -63,16 +72,28 @@ extern "C" {
 		if (!force && !impl::autosave_enabled)  // no more autosaves
 			return FALSE;  // remove timeout, disable autosave for real.
 
-		auto file = impl::autosave_config_file;
-		debug_out_info("rconfig", "Autosaving config to \"" << file << "\"." << std::endl);
+		const std::uint64_t generation = get_config_generation();
+		if (generation == impl::autosave_saved_generation) {
+			return TRUE;  // not modified since the last save, don't touch the disk. This is success for forced saves too.
+		}
 
-		std::error_code ec;
-		if ((hz::fs::exists(file, ec) && !hz::fs::is_regular_file(file, ec)) || !hz::fs_path_is_writable(file, ec)) {
-			debug_out_error("rconfig", "Autosave failed: Cannot write to file:  " << ec.message() << std::endl);
-			return static_cast<gboolean>(force);  // if manual, return failure. else, don't stop the timeout.
+		// If the config is still being modified, wait for it to settle (but not forever).
+		if (!force && generation != impl::autosave_last_seen_generation
+				&& impl::autosave_postponed_count < impl::autosave_max_postponed) {
+			impl::autosave_last_seen_generation = generation;
+			++impl::autosave_postponed_count;
+			return TRUE;
 		}
 
-		const bool status = rconfig::save_to_file(impl::autosave_config_file);
+		const auto& file = impl::autosave_config_file;
+		debug_out_info("rconfig", "Autosaving config to \"" << file << "\"." << std::endl);
+
+		const bool status = rconfig::save_to_file(file);
+		if (status) {
+			impl::autosave_saved_generation = generation;
+			impl::autosave_last_seen_generation = generation;
+			impl::autosave_postponed_count = 0;
+		}
 		if (force)
 			return static_cast<gboolean>(status);  // return status to caller
 
@@ -84,7 +105,9 @@ extern "C" {
 
 
 
-/// Set config file to autosave to.
+/// Set config file to autosave to. The current config is assumed to be
+/// in sync with the file (i.e. just loaded from it); only the subsequent
+/// changes are written.
 inline bool autosave_set_config_file(const hz::fs::path& file)
 {
 	if (file.empty()) {
@@ -93,6 +116,9 @@ inline bool autosave_set_config_file(const hz::fs::path& file)
 	}
 
 	impl::autosave_config_file = file;
+	impl::autosave_saved_generation = get_config_generation();
+	impl::autosave_last_seen_generation = impl::autosave_saved_generation;
+	impl::autosave_postponed_count = 0;
 
 	debug_out_info("rconfig", "Setting autosave config file to \"" << file << "\"." << std::endl);
 	return true;
@@ -130,7 +156,7 @@ inline void autosave_stop()
 
 
 
-/// Forcibly save the config now.
+/// Forcibly save the config now (if it was modified since the last save).
 inline bool autosave_force_now()
 {
 	AutosaveCallbackData data;
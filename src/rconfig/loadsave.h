@@ -44,17 +44,20 @@ inline bool load_from_file(const hz::fs::path& file)
 				<< file << "\": " << e.what() << std::endl);
 		return false;
 	}
+	++impl::config_generation;
+	publish_snapshot();
 	return true;
 }
 
 
 
-/// Save the config branch to a file.
+/// Save the config branch to a file. The file is replaced atomically, so
+/// a crash while saving doesn't leave a truncated config.
 inline bool save_to_file(const hz::fs::path& file)
 {
 	const std::string json_str = get_config_branch().dump(4);
 
-	auto ec = hz::fs_file_put_contents(file, json_str);
+	auto ec = hz::fs_file_put_contents_atomic(file, json_str);
 	if (ec) {
 		debug_out_error("rconfig", DBG_FUNC_MSG
 				<< "Unable to write to file \"" << file << "\": " << ec.message() << "." << std::endl);
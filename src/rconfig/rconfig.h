@@ -17,6 +17,9 @@ Copyright:
 #include <string>
 #include <memory>
 #include <vector>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
 #include <stdexcept>  // std::runtime_error
 
 #include "hz/debug.h"
@@ -37,6 +40,63 @@ namespace impl {
 	inline std::unique_ptr<json> default_node;  ///< Node for default branch
 
 
+	/// Immutable copy of both branches, with config merged over defaults
+	struct Snapshot {
+		json merged;  ///< Defaults with the config branch merged over them
+		json defaults;  ///< Defaults only, used if the config value has a wrong type
+	};
+
+	/// The current snapshot. Replaced (never modified) when outdated, accessed
+	/// through std::atomic_load() / std::atomic_store() so that other threads may read it.
+	inline std::shared_ptr<const Snapshot> snapshot;
+
+	/// Whether the branches were changed since the snapshot was built
+	inline std::atomic<bool> snapshot_dirty = true;
+
+	/// Protects the branches while they are modified by this file's functions or copied
+	/// to a new snapshot (which may happen in any thread).
+	inline std::mutex branches_mutex;
+
+	/// Incremented on each change of the config branch (not defaults), see get_config_generation().
+	inline std::atomic<std::uint64_t> config_generation = 0;
+
+
+
+	/// Convert a slash-separated path to a JSON pointer
+	inline json::json_pointer path_to_pointer(const std::string& path)
+	{
+		std::vector<std::string> components;
+		hz::string_split(path, '/', components, true);
+
+		std::string pointer_str;
+		for (auto& comp : components) {
+			hz::string_replace(comp, "~", "~0");  // JSON pointer escaping
+			pointer_str += "/" + comp;
+		}
+		return json::json_pointer(pointer_str);
+	}
+
+
+
+	/// Get the data from a node by JSON pointer.
+	/// \return false if not found or if the node has a different type.
+	template<typename T>
+	bool get_pointer_data(const json& root, const json::json_pointer& pointer, T& value)
+	{
+		try {
+			if (!root.contains(pointer)) {
+				return false;
+			}
+			value = root.at(pointer).get<T>();  // may throw json::type_error
+		}
+		catch (json::exception& e) {  // type error, or non-object in the middle of the path
+			debug_out_error("rconfig", e.what());
+			return false;
+		}
+		return true;
+	}
+
+
 	template<typename T>
 	inline void set_node_data(json& root, const std::string& path, T&& value)
 	{
@@ -72,36 +132,6 @@ namespace impl {
 
 
 
-	template<typename T>
-	bool get_node_data(json& root, const std::string& path, T& value)
-	{
-		std::vector<std::string> components;
-		hz::string_split(path, '/', components, true);
-
-		json* curr = &root;
-		for (std::size_t comp_index = 0; comp_index < components.size(); ++comp_index) {
-			const std::string& comp_name = components[comp_index];
-
-			if (!curr->is_object()) {  // we can't have non-object values in the middle of a path
-				throw std::runtime_error("Cannot get node data \""s + path + "\", component \"" + comp_name + "\" is not an object.");
-			}
-			if (auto iter = curr->find(comp_name); iter != curr->end()) {  // path component exists
-				json& jval = iter.value();
-				if (comp_index + 1 == components.size()) {  // it's the "value" component
-					value = jval.get<T>();  // may throw json::type_error
-					return true;
-				}
-				// continue to the next component
-				curr = &jval;
-
-			} else {  // path component doesn't exist
-				break;
-			}
-		}
-		return false;
-	}
-
-
 	inline void unset_node_data(json& root, const std::string& path)
 	{
 		std::vector<std::string> components;
@@ -136,17 +166,75 @@ namespace impl {
 
 
 
+/// Mark the snapshot as outdated, so that the next get_snapshot() builds a new one
+/// from the config and default branches. This is done automatically by the functions
+/// below. Call it after modifying get_config_branch() or get_default_branch() directly.
+/// Changes to the config are expected to happen in one (main) thread only.
+/// Building the snapshot copies both branches, so doing it only when the config is
+/// read keeps e.g. registering all the defaults at startup linear.
+inline void publish_snapshot()
+{
+	impl::snapshot_dirty = true;
+}
+
+
+
+/// Get the current config snapshot, building it if the config has changed since.
+/// It never changes, so it can be read from any thread without locking.
+inline std::shared_ptr<const impl::Snapshot> get_snapshot()
+{
+	if (!impl::snapshot_dirty) {
+		if (auto snapshot = std::atomic_load(&impl::snapshot)) {
+			return snapshot;
+		}
+	}
+
+	const std::lock_guard<std::mutex> lock(impl::branches_mutex);
+	if (impl::snapshot_dirty.exchange(false) || !std::atomic_load(&impl::snapshot)) {
+		auto snapshot = std::make_shared<impl::Snapshot>();
+		if (impl::default_node) {
+			snapshot->defaults = *impl::default_node;
+		}
+		snapshot->merged = snapshot->defaults;
+		if (impl::config_node) {
+			snapshot->merged.merge_patch(*impl::config_node);
+		}
+		std::atomic_store(&impl::snapshot, std::shared_ptr<const impl::Snapshot>(std::move(snapshot)));
+	}
+	return std::atomic_load(&impl::snapshot);
+}
+
+
+
+/// Get the number of changes made to the config branch. This can be used
+/// to find out whether the config needs to be saved.
+inline std::uint64_t get_config_generation()
+{
+	return impl::config_generation.load();
+}
+
+
+
 /// Clear user config
 inline void clear_config()
 {
-	impl::config_node = std::make_unique<json>(json::object());
+	{
+		const std::lock_guard<std::mutex> lock(impl::branches_mutex);
+		impl::config_node = std::make_unique<json>(json::object());
+	}
+	++impl::config_generation;
+	publish_snapshot();
 }
 
 
 /// Clear defaults
 inline void clear_defaults()
 {
-	impl::default_node = std::make_unique<json>(json::object());
+	{
+		const std::lock_guard<std::mutex> lock(impl::branches_mutex);
+		impl::default_node = std::make_unique<json>(json::object());
+	}
+	publish_snapshot();
 }
 
 
@@ -164,19 +252,21 @@ inline bool init_root()
 
 
 
-/// Get the config branch node
+/// Get the config branch node. Call publish_snapshot() after modifying it.
 inline json& get_config_branch()
 {
 	init_root();
+	get_snapshot();  // bring it up to date, so that no other thread copies the node while it's being modified
 	return *impl::config_node;
 }
 
 
 
-/// Get the default branch node
+/// Get the default branch node. Call publish_snapshot() after modifying it.
 inline json& get_default_branch()
 {
 	init_root();
+	get_snapshot();  // see get_config_branch()
 	return *impl::default_node;
 }
 
@@ -188,13 +278,17 @@ bool set_data(const std::string& path, T data)
 {
 	// Since config is loaded from a user file, it may contain some invalid
 	// nodes. Don't abort, print warnings.
+	init_root();
 	try {
-		impl::set_node_data(get_config_branch(), path, std::move(data));
+		const std::lock_guard<std::mutex> lock(impl::branches_mutex);
+		impl::set_node_data(*impl::config_node, path, std::move(data));
 	}
 	catch (std::exception& e) {
 		debug_out_error("rconfig", e.what());
 		return false;
 	}
+	++impl::config_generation;
+	publish_snapshot();
 	return true;
 }
 
@@ -205,30 +299,86 @@ template<typename T>
 void set_default_data(const std::string& path, T data)
 {
 	// Default data branch must always be valid, so abort if anything is wrong.
-	impl::set_node_data(get_default_branch(), path, std::move(data));
+	init_root();
+	{
+		const std::lock_guard<std::mutex> lock(impl::branches_mutex);
+		impl::set_node_data(*impl::default_node, path, std::move(data));
+	}
+	publish_snapshot();
 }
 
 
 
+/// A handle to a config key. The path is resolved once, reading the value only
+/// involves a lookup in the current snapshot, so it's cheap enough for hot paths
+/// and safe to use from any thread. Usually declared static:
+/// \code
+/// static const rconfig::Key<bool> show_smart_capable_only("gui/show_smart_capable_only");
+/// if (show_smart_capable_only.get()) { ... }
+/// \endcode
+template<typename T>
+class Key {
+	public:
+
+		/// Constructor
+		explicit Key(std::string path)
+				: path_(std::move(path)), pointer_(impl::path_to_pointer(path_))
+		{ }
+
+
+		/// Get the value from config. If no such node exists (or it has a wrong type),
+		/// look it up in defaults.
+		/// \throw std::runtime_error if not found in defaults either.
+		[[nodiscard]] T get() const
+		{
+			const auto snapshot = get_snapshot();
+			T data = {};
+			// This can possibly fail because the user config file is incorrect.
+			if (impl::get_pointer_data(snapshot->merged, pointer_, data)) {
+				return data;
+			}
+			// This can fail only for errors within the program.
+			if (!impl::get_pointer_data(snapshot->defaults, pointer_, data)) {
+				throw std::runtime_error("No such node: "s + path_);
+			}
+			return data;
+		}
+
+
+		/// Get the value from defaults
+		/// \throw std::runtime_error if not found.
+		[[nodiscard]] T get_default() const
+		{
+			T data = {};
+			if (!impl::get_pointer_data(get_snapshot()->defaults, pointer_, data)) {
+				throw std::runtime_error("No such node: "s + path_);
+			}
+			return data;
+		}
+
+
+		/// Get the key path
+		[[nodiscard]] const std::string& get_path() const
+		{
+			return path_;
+		}
+
+
+	private:
+
+		std::string path_;  ///< Slash-separated path
+		json::json_pointer pointer_;  ///< Pre-parsed path
+
+};
+
+
+
 /// Get the data from config. If no such node exists, look it up in defaults.
+/// This may be called from any thread. Use Key in frequently called code.
 template<typename T>
 T get_data(const std::string& path)
 {
-	T data = {};
-	bool found = false;
-	try {
-		// This can possibly throw because the user config file is incorrect
-		found = impl::get_node_data(get_config_branch(), path, data);
-	}
-	catch(std::exception& e) {
-		debug_out_error("rconfig", e.what());
-	}
-
-	// This can throw only for errors within the program.
-	if (!found && !impl::get_node_data(get_default_branch(), path, data)) {
-		throw std::runtime_error("No such node: "s + path);
-	}
-	return data;
+	return Key<T>(path).get();
 }
 
 
@@ -237,12 +387,7 @@ T get_data(const std::string& path)
 template<typename T>
 T get_default_data(const std::string& path)
 {
-	T data = {};
-	// This can throw only for errors within the program.
-	if (!impl::get_node_data(get_default_branch(), path, data)) {
-		throw std::runtime_error("No such node: "s + path);
-	}
-	return data;
+	return Key<T>(path).get_default();
 }
 
 
@@ -250,7 +395,13 @@ T get_default_data(const std::string& path)
 /// Unset data in config path
 inline void unset_data(const std::string& path)
 {
-	impl::unset_node_data(get_config_branch(), path);
+	init_root();
+	{
+		const std::lock_guard<std::mutex> lock(impl::branches_mutex);
+		impl::unset_node_data(*impl::config_node, path);
+	}
+	++impl::config_generation;
+	publish_snapshot();
 }
 
 